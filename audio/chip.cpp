@@ -142,7 +142,7 @@ int EmulatedChip::getRate() const {
 
 void EmulatedChip::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
-	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
+	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true, false, true);
 }
 
 void EmulatedChip::stopCallbacks() {
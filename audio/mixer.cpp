@@ -26,6 +26,7 @@
 
 #include "audio/mixer_intern.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
@@ -48,14 +49,16 @@ public:
 	/**
 	 * Mixes the channel's samples into the given buffer.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of 10
-	 *             in stereo and 16-bit samples means that the
-	 *             buffer contains twice 10 sample, each 16 bits,
-	 *             for a total of 40 bytes.
+	 * @param data           buffer where to mix the data
+	 * @param len            number of sample *pairs*. So a value of 10
+	 *                       in stereo and 16-bit samples means that the
+	 *                       buffer contains twice 10 sample, each 16 bits,
+	 *                       for a total of 40 bytes.
+	 * @param bytesPerSample size of each sample in the buffer
+	 * @param mixMode        whether the samples are clamped while mixing
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(byte *data, uint len);
+	int mix(byte *data, uint len, uint bytesPerSample, MixMode mixMode);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -228,31 +231,185 @@ private:
 	Common::DisposablePtr<AudioStream> _stream;
 };
 
+/**
+ * Stream used by the default Mixer implementation to read an expensive
+ * stream, such as a software synthesizer, ahead of time on a worker thread.
+ *
+ * The worker reads the stream in small chunks into a ring buffer, and the
+ * mixer callback copies from there. The stream is only accessed with the
+ * render mutex held, but not the mixer mutex, so that the callback is never
+ * held up by rendering unless the worker could not keep up. The worker
+ * publishes the write position and the callback the read position.
+ * Requests made by other threads take effect at the current render
+ * position, i.e. up to one ring buffer later.
+ */
+class RenderAheadStream : public AudioStream {
+public:
+	RenderAheadStream(MixerImpl *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream);
+	~RenderAheadStream();
+
+	/**
+	 * Reads one chunk into the ring buffer. Must be called with the render
+	 * mutex held.
+	 *
+	 * @return true if there was space left and the stream did not end.
+	 */
+	bool renderChunk();
+
+	Common::Mutex &getRenderMutex() { return _renderMutex; }
+
+	// AudioStream API
+	int readBuffer(int16 *buffer, const int numSamples) override;
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return _readPos == _writePos && _endOfData; }
+	bool endOfStream() const override { return _readPos == _writePos && _endOfStream; }
+
+private:
+	enum {
+		kChunkFrames = 256
+	};
+
+	/** Copy as many samples as were rendered, and return their number. */
+	uint copyRendered(int16 *buffer, uint numSamples);
+
+	/** Update the end flags after reading the stream. */
+	void updateEnd();
+
+	MixerImpl *_mixer;
+	Common::DisposablePtr<AudioStream> _stream;
+	Common::Mutex _renderMutex;
+
+	const bool _stereo;
+	const int _rate;
+	std::atomic<bool> _endOfData;
+	std::atomic<bool> _endOfStream;
+
+	int16 *_buffer;
+	uint _bufferSize;
+	uint _chunkSize;
+
+	// Sample counters which only ever increase, the position in the
+	// buffer is the counter modulo _bufferSize
+	std::atomic<uint32> _readPos;
+	std::atomic<uint32> _writePos;
+};
+
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize, uint outBytesPerSample, bool clamp)
 	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _outBytesPerSample(outBytesPerSample), _clamp(clamp)
-	, _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	, _mixerReady(false), _handleSeed(0), _mixBus(false), _mixBuffer(nullptr), _mixBufferSize(0)
+	, _renderAhead(false), _renderQuit(false)
+	, _soundTypeSettings(), _commandHead(0), _commandTail(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_channelStatus[i].handle = SoundHandle()._val;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	_renderQuit = true;
+	_renderWake.post();
+	_renderThread.join();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	delete[] _mixBuffer;
 }
 
 void MixerImpl::setReady(bool ready) {
 	Common::StackLock lock(_mutex);
 
+	// The output buffer size is known by now
+	if (ready && _mixBus)
+		allocateMixBuffer();
+
 	_mixerReady = ready;
 }
 
+void MixerImpl::setMixBus(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	// The bus only replaces the clamped 16-bit output path
+	_mixBus = enable && _clamp && _outBytesPerSample == 2;
+	if (_mixBus)
+		allocateMixBuffer();
+}
+
+void MixerImpl::allocateMixBuffer() {
+	// Backends which don't report their buffer size get a common one, the
+	// callback mixes larger requests in several passes
+	const uint numSamples = (_outBufSize ? _outBufSize : 2048) * (_stereo ? 2 : 1);
+	if (_mixBufferSize == numSamples)
+		return;
+
+	delete[] _mixBuffer;
+	_mixBuffer = new int32[numSamples];
+	_mixBufferSize = numSamples;
+}
+
+void MixerImpl::setRenderAhead(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	// Streams which are already playing keep their mode
+	_renderAhead = enable;
+	if (_renderAhead && !_renderThread.isRunning() && !_renderThread.start(renderAheadProc, this, "MixerRenderAhead"))
+		_renderAhead = false;
+}
+
+void MixerImpl::addRenderAheadStream(RenderAheadStream *stream) {
+	Common::StackLock lock(_mutex);
+	_renderAheadStreams.push_back(stream);
+	_renderWake.post();
+}
+
+void MixerImpl::removeRenderAheadStream(RenderAheadStream *stream) {
+	// Once the stream is gone from the list, the worker cannot pick it anymore
+	Common::StackLock lock(_mutex);
+	for (uint i = 0; i < _renderAheadStreams.size(); i++) {
+		if (_renderAheadStreams[i] == stream) {
+			_renderAheadStreams.remove_at(i);
+			break;
+		}
+	}
+}
+
+void MixerImpl::renderAheadProc(void *data) {
+	MixerImpl *mixer = (MixerImpl *)data;
+
+	while (!mixer->_renderQuit) {
+		// Take turns, so that a callback which ran out of samples never
+		// waits for more than one chunk
+		bool rendered = false;
+		for (uint i = 0; ; i++) {
+			// Only look up the stream with the mixer mutex held. Once its
+			// render mutex is taken, the stream cannot be deleted.
+			RenderAheadStream *stream;
+			{
+				Common::StackLock lock(mixer->_mutex);
+				if (i >= mixer->_renderAheadStreams.size())
+					break;
+				stream = mixer->_renderAheadStreams[i];
+				stream->getRenderMutex().lock();
+			}
+
+			rendered |= stream->renderChunk();
+			stream->getRenderMutex().unlock();
+		}
+
+		// Sleep until the mixer callback consumed some samples
+		if (!rendered)
+			mixer->_renderWake.wait();
+	}
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
@@ -294,10 +451,135 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 
 	chan->setHandle(chanHandle);
 	_handleSeed++;
+
+	// Publish the new channel. The handle is stored last, so that lock-free
+	// readers never see it together with the previous channel's settings.
+	{
+		Common::StackLock lock(_commandMutex);
+		ChannelStatus &status = _channelStatus[index];
+		status.id = chan->getId();
+		status.type = chan->getType();
+		status.volume = chan->getVolume();
+		status.balance = chan->getBalance();
+		status.faderL = chan->getFaderL();
+		status.faderR = chan->getFaderR();
+		status.rate = chan->getRate();
+		status.nativeRate = chan->getRate();
+		status.handle = chanHandle._val;
+	}
+
 	if (handle)
 		*handle = chanHandle;
 }
 
+void MixerImpl::removeChannel(int index) {
+	_channelStatus[index].handle = SoundHandle()._val;
+	delete _channels[index];
+	_channels[index] = nullptr;
+}
+
+int MixerImpl::findStatus(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (_channelStatus[index].handle != handle._val)
+		return -1;
+
+	return index;
+}
+
+template<typename T>
+T MixerImpl::readStatus(SoundHandle handle, const std::atomic<T> ChannelStatus::*field, T defaultValue) const {
+	const int index = findStatus(handle);
+	if (index == -1)
+		return defaultValue;
+
+	const ChannelStatus &status = _channelStatus[index];
+	const T value = status.*field;
+
+	// The channel may have been stopped and its slot reused meanwhile
+	if (status.handle != handle._val)
+		return defaultValue;
+
+	return value;
+}
+
+template<typename T>
+void MixerImpl::queueCommand(CommandType type, SoundHandle handle, std::atomic<T> ChannelStatus::*field, T value) {
+	while (true) {
+		{
+			Common::StackLock lock(_commandMutex);
+
+			const int index = findStatus(handle);
+			if (index == -1)
+				return;
+
+			const uint32 head = _commandHead.load(std::memory_order_relaxed);
+			if (head - _commandTail.load(std::memory_order_acquire) < COMMAND_QUEUE_SIZE) {
+				if (field)
+					_channelStatus[index].*field = value;
+
+				Command &cmd = _commands[head % COMMAND_QUEUE_SIZE];
+				cmd.type = type;
+				cmd.handle = handle._val;
+				cmd.value = (int32)value;
+				_commandHead.store(head + 1, std::memory_order_release);
+				return;
+			}
+		}
+
+		// The audio thread is lagging behind (or not running at all), so
+		// make room in the queue ourselves. This must not happen while
+		// holding _commandMutex, as insertChannel() takes the locks in the
+		// opposite order.
+		Common::StackLock lock(_mutex);
+		processCommands();
+	}
+}
+
+void MixerImpl::processCommands() {
+	const uint32 head = _commandHead.load(std::memory_order_acquire);
+	uint32 tail = _commandTail.load(std::memory_order_relaxed);
+
+	while (tail != head) {
+		applyCommand(_commands[tail % COMMAND_QUEUE_SIZE]);
+		tail++;
+	}
+
+	_commandTail.store(tail, std::memory_order_release);
+}
+
+void MixerImpl::applyCommand(const Command &cmd) {
+	// Ignore commands for sounds that terminated since they were queued
+	const int index = cmd.handle % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case kCommandVolume:
+		_channels[index]->setVolume((byte)cmd.value);
+		break;
+	case kCommandBalance:
+		_channels[index]->setBalance((int8)cmd.value);
+		break;
+	case kCommandFaderL:
+		_channels[index]->setFaderL((uint8)cmd.value);
+		break;
+	case kCommandFaderR:
+		_channels[index]->setFaderR((uint8)cmd.value);
+		break;
+	case kCommandRate:
+		_channels[index]->setRate((uint32)cmd.value);
+		break;
+	case kCommandResetRate:
+		_channels[index]->resetRate();
+		break;
+	case kCommandPause:
+		_channels[index]->pause(cmd.value != 0);
+		break;
+	default:
+		break;
+	}
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -305,8 +587,10 @@ void MixerImpl::playStream(
 			int id, byte volume, int8 balance,
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
-			bool reverseStereo) {
+			bool reverseStereo,
+			bool renderAhead) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	if (stream == nullptr) {
 		warning("stream is 0");
@@ -336,6 +620,11 @@ void MixerImpl::playStream(
 	reverseStereo = !reverseStereo;
 #endif
 
+	if (renderAhead && _renderAhead) {
+		stream = new RenderAheadStream(this, stream, autofreeStream);
+		autofreeStream = DisposeAfterUse::YES;
+	}
+
 	// Create the channel
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
 	chan->setVolume(volume);
@@ -351,76 +640,112 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	processCommands();
+
 	// we store samples of size defined by the backend
 	const uint bytesPerFrame = _outBytesPerSample * (_stereo ? 2 : 1);
 	assert(len % bytesPerFrame == 0);
 	const uint numFrames = len / bytesPerFrame;
 
+	int res;
+	bool zeroed;
+	if (_mixBus) {
+		// with the mix bus, accumulate into the preallocated 32-bit buffer
+		// and clamp once, in several passes if the backend asks for more
+		// than its buffer size
+		const uint channels = _stereo ? 2 : 1;
+		const uint chunkFrames = _mixBufferSize / channels;
+		assert(chunkFrames > 0);
+
+		res = 0;
+		zeroed = false;
+		for (uint pos = 0; pos < numFrames; pos += chunkFrames) {
+			const uint frames = MIN(chunkFrames, numFrames - pos);
+			int16 *out = (int16 *)samples + pos * channels;
+
+			bool chunkZeroed;
+			res += mixChannels((byte *)_mixBuffer, frames, sizeof(int32), MIX_ADD, chunkZeroed);
+			if (chunkZeroed)
+				StereoMix::getClampFunc()(out, _mixBuffer, frames * channels);
+			else
+				memset(out, 0, frames * channels * sizeof(int16));
+			zeroed |= chunkZeroed;
+		}
+	} else {
+		res = mixChannels(samples, numFrames, _outBytesPerSample, _clamp ? MIX_CLAMPED_ADD : MIX_ADD, zeroed);
+	}
+
+	if (!zeroed) {
+		if (_clamp) {
+			memset(samples, 0, len);
+		} else {
+			// optimization: let the caller know that there's nothing to clamp
+			res = 0;
+		}
+	}
+	return res;
+}
+
+int MixerImpl::mixChannels(byte *buffer, uint numFrames, uint bytesPerSample, MixMode mixMode, bool &zeroed) {
 	// mix all channels, zeroing the buffer lazily on first non-silent channel
-	bool zeroed = false;
+	zeroed = false;
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				removeChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				if (!_channels[i]->isSilent() && !zeroed) {
-					memset(samples, 0, len);
+					memset(buffer, 0, numFrames * (_stereo ? 2 : 1) * bytesPerSample);
 					zeroed = true;
 				}
-				tmp = _channels[i]->mix(samples, numFrames);
+				tmp = _channels[i]->mix(buffer, numFrames, bytesPerSample, mixMode);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
-	if (!zeroed) {
-		if (_clamp) {
-			memset(samples, 0, len);
-		} else {
-			// optimization: let the caller know that there's nothing to clamp
-			res = 0;
-		}
-	}
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	removeChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
+	processCommands();
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -435,103 +760,48 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	queueCommand(kCommandVolume, handle, &ChannelStatus::volume, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) const {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getVolume();
+	return readStatus<byte>(handle, &ChannelStatus::volume, 0);
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	queueCommand(kCommandBalance, handle, &ChannelStatus::balance, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) const {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getBalance();
+	return readStatus<int8>(handle, &ChannelStatus::balance, 0);
 }
 
 void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderL(faderL);
+	queueCommand(kCommandFaderL, handle, &ChannelStatus::faderL, faderL);
 }
 
 uint8 MixerImpl::getChannelFaderL(SoundHandle handle) const {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderL();
+	return readStatus<uint8>(handle, &ChannelStatus::faderL, 0);
 }
 
 void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setFaderR(faderR);
+	queueCommand(kCommandFaderR, handle, &ChannelStatus::faderR, faderR);
 }
 
 uint8 MixerImpl::getChannelFaderR(SoundHandle handle) const {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getFaderR();
+	return readStatus<uint8>(handle, &ChannelStatus::faderR, 0);
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	queueCommand(kCommandRate, handle, &ChannelStatus::rate, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) const {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
-
-	return _channels[index]->getRate();
+	return readStatus<uint32>(handle, &ChannelStatus::rate, 0);
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->resetRate();
+	const uint32 nativeRate = readStatus<uint32>(handle, &ChannelStatus::nativeRate, 0);
+	queueCommand(kCommandResetRate, handle, &ChannelStatus::rate, nativeRate);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) const {
@@ -540,6 +810,8 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) const {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) const {
 	Common::StackLock lock(_mutex);
+	// Pending pause requests affect the elapsed time
+	const_cast<MixerImpl *>(this)->processCommands();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -550,6 +822,7 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) const {
 
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -560,6 +833,7 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr) {
 			_channels[i]->pause(paused);
@@ -569,6 +843,7 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
@@ -578,53 +853,43 @@ void MixerImpl::pauseID(int id, bool paused) {
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	// Requests for sounds that already terminated are simply ignored
+	queueCommand<uint32>(kCommandPause, handle, nullptr, paused ? 1 : 0);
 }
 
 bool MixerImpl::isSoundIDActive(int id) const {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const ChannelStatus &status = _channelStatus[i];
+		const uint32 handle = status.handle;
+		if (handle != SoundHandle()._val && status.id == id && status.handle == handle)
 			return true;
+	}
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) const {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	return readStatus<int>(handle, &ChannelStatus::id, 0);
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) const {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findStatus(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) const {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const ChannelStatus &status = _channelStatus[i];
+		const uint32 handle = status.handle;
+		if (handle != SoundHandle()._val && status.type == type && status.handle == handle)
 			return true;
+	}
 	return false;
 }
 
@@ -638,6 +903,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// scaling? See also Player_V2::setMasterVolume
 
 	Common::StackLock lock(_mutex);
+	processCommands();
 	_soundTypeSettings[type].volume = volume;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -812,7 +1078,7 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(byte *data, uint len) {
+int Channel::mix(byte *data, uint len, uint bytesPerSample, MixMode mixMode) {
 	assert(_stream);
 	assert(_converter);
 
@@ -824,15 +1090,98 @@ int Channel::mix(byte *data, uint len) {
 		res = _converter->convert(
 			*_stream,
 			data,
-			_mixer->getOutputBytesPerSample(),
+			bytesPerSample,
 			len,
 			_volL,
 			_volR,
-			_mixer->getClamping() ? MIX_CLAMPED_ADD : MIX_ADD);
+			mixMode);
 		_samplesDecoded += res;
 	}
 
 	return res;
 }
 
+#pragma mark -
+#pragma mark --- RenderAheadStream ---
+#pragma mark -
+
+RenderAheadStream::RenderAheadStream(MixerImpl *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream)
+	: _mixer(mixer), _stream(stream, autofreeStream), _stereo(stream->isStereo()), _rate(stream->getRate()),
+	  _endOfData(stream->endOfData()), _endOfStream(stream->endOfStream()), _readPos(0), _writePos(0) {
+	// Stay about two mixer callbacks ahead
+	uint frames = mixer->getOutputBufSize() * 2;
+	if (frames == 0)
+		frames = 2048;
+	frames = (frames + kChunkFrames - 1) / kChunkFrames * kChunkFrames;
+
+	const uint channels = _stereo ? 2 : 1;
+	_chunkSize = kChunkFrames * channels;
+	_bufferSize = frames * channels;
+	_buffer = new int16[_bufferSize];
+
+	_mixer->addRenderAheadStream(this);
+}
+
+RenderAheadStream::~RenderAheadStream() {
+	// Wait for the worker to finish the chunk it may be rendering
+	_mixer->removeRenderAheadStream(this);
+	Common::StackLock lock(_renderMutex);
+	delete[] _buffer;
+}
+
+void RenderAheadStream::updateEnd() {
+	_endOfData = _stream->endOfData();
+	_endOfStream = _stream->endOfStream();
+}
+
+bool RenderAheadStream::renderChunk() {
+	const uint32 writePos = _writePos;
+	if (_bufferSize - (writePos - _readPos) < _chunkSize || _stream->endOfData())
+		return false;
+
+	// The buffer size is a multiple of the chunk size, so chunks never wrap
+	const int samples = _stream->readBuffer(_buffer + writePos % _bufferSize, _chunkSize);
+	updateEnd();
+	if (samples <= 0)
+		return false;
+
+	// Publish the samples once they are written
+	_writePos = writePos + samples;
+	return (uint)samples == _chunkSize;
+}
+
+uint RenderAheadStream::copyRendered(int16 *buffer, uint numSamples) {
+	const uint32 readPos = _readPos;
+	const uint copied = MIN<uint>(_writePos - readPos, numSamples);
+	const uint offset = readPos % _bufferSize;
+	const uint firstPart = MIN<uint>(copied, _bufferSize - offset);
+	memcpy(buffer, _buffer + offset, firstPart * sizeof(int16));
+	memcpy(buffer + firstPart, _buffer, (copied - firstPart) * sizeof(int16));
+
+	// Hand the space back to the worker once the samples are copied
+	_readPos = readPos + copied;
+	return copied;
+}
+
+int RenderAheadStream::readBuffer(int16 *buffer, const int numSamples) {
+	uint copied = copyRendered(buffer, numSamples);
+
+	// Read the rest directly if the worker could not keep up. It may have
+	// finished a chunk in the meantime, and since the ring buffer is empty
+	// afterwards, the order of the samples is kept.
+	if (copied < (uint)numSamples) {
+		Common::StackLock lock(_renderMutex);
+		copied += copyRendered(buffer + copied, numSamples - copied);
+		if (copied < (uint)numSamples) {
+			const int samples = _stream->readBuffer(buffer + copied, numSamples - copied);
+			updateEnd();
+			if (samples > 0)
+				copied += samples;
+		}
+	}
+
+	_mixer->_renderWake.post();
+	return copied;
+}
+
 } // End of namespace Audio
@@ -126,6 +126,9 @@ public:
 	 * @param autofreeStream  If set, the stream will be freed after the playback is finished.
 	 * @param permanent       If set, a plain stopAll call will not stop this particular stream.
 	 * @param reverseStereo   If set, left and right channels will be swapped.
+	 * @param renderAhead     If set and supported, the stream is read ahead of time on a
+	 *                        worker thread, without the mixer mutex held. This is meant for
+	 *                        expensive software synthesizers which never end.
 	 */
 	virtual void playStream(
 		SoundType type,
@@ -136,7 +139,8 @@ public:
 		int8 balance = 0,
 		DisposeAfterUse::Flag autofreeStream = DisposeAfterUse::YES,
 		bool permanent = false,
-		bool reverseStereo = false) = 0;
+		bool reverseStereo = false,
+		bool renderAhead = false) = 0;
 
 	/**
 	 * Stop all currently playing sounds.
@@ -23,11 +23,18 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
+#include "common/thread.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include <atomic>
 
 namespace Audio {
 
+class RenderAheadStream;
+
 /**
  * @defgroup audio_mixer_intern Mixer implementation
  * @ingroup audio
@@ -49,6 +56,17 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Channel parameter changes (volume, balance, faders, rate, pausing by
+ * handle) do not take the mixer mutex. They are published immediately in a
+ * per-channel status table, so that the matching getters return the new value
+ * right away, and are queued in a lock-free command ring which mixCallback()
+ * drains before each mixing pass. Queries about the channel state (handle or
+ * ID activity, sound type, volume, ...) are answered from the status table
+ * without any locking. Operations which have to be synchronous with the
+ * audio thread (starting and stopping sounds, pausing everything, ...) still
+ * lock the mutex, and process any pending commands first so that the order
+ * of requests is preserved.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -56,21 +74,84 @@ namespace Audio {
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
+	friend class RenderAheadStream;
+
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
+	};
+
+	enum CommandType {
+		kCommandVolume,
+		kCommandBalance,
+		kCommandFaderL,
+		kCommandFaderR,
+		kCommandRate,
+		kCommandResetRate,
+		kCommandPause
+	};
+
+	/**
+	 * A deferred channel parameter change, applied by the audio thread.
+	 */
+	struct Command {
+		CommandType type;
+		uint32 handle;
+		int32 value;
+	};
+
+	/**
+	 * Channel state which may be read from any thread without locking.
+	 *
+	 * It is written by whoever holds the mixer mutex when a channel is
+	 * created or destroyed, and by the setters for the parameters, which
+	 * reflect the value requested by the engine (even if the corresponding
+	 * command has not been processed by the audio thread yet).
+	 */
+	struct ChannelStatus {
+		std::atomic<uint32> handle;
+		std::atomic<int> id;
+		std::atomic<int> type;
+		std::atomic<byte> volume;
+		std::atomic<int8> balance;
+		std::atomic<uint8> faderL;
+		std::atomic<uint8> faderR;
+		std::atomic<uint32> rate;
+		std::atomic<uint32> nativeRate;
 	};
 
 	Common::Mutex _mutex;
+	Common::Mutex _commandMutex;
 
 	const uint _sampleRate;
 	const bool _stereo;
 	uint _outBufSize;
 	const uint _outBytesPerSample;
 	const bool _clamp;
-	bool _mixerReady;
+	std::atomic<bool> _mixerReady;
 	uint32 _handleSeed;
 
+	/**
+	 * Optional 32-bit intermediate buffer. When enabled, all channels are
+	 * accumulated without clamping and the result is clamped once at the
+	 * end, so that overlapping loud sounds no longer clip each other.
+	 */
+	bool _mixBus;
+	int32 *_mixBuffer;
+	uint _mixBufferSize;
+
+	/**
+	 * Optional worker thread which reads streams played with renderAhead
+	 * ahead of time. The list of streams is guarded by _mutex, the streams
+	 * themselves by their own render mutex.
+	 */
+	bool _renderAhead;
+	Common::Array<RenderAheadStream *> _renderAheadStreams;
+	Common::Thread _renderThread;
+	Common::Semaphore _renderWake;
+	std::atomic<bool> _renderQuit;
+
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
@@ -80,14 +161,22 @@ private:
 
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
+	ChannelStatus _channelStatus[NUM_CHANNELS];
 
+	/**
+	 * Single-consumer command ring. Producers are serialized among
+	 * themselves by _commandMutex, the consumer is whoever holds _mutex.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	std::atomic<uint32> _commandHead;
+	std::atomic<uint32> _commandTail;
 
 public:
 
 	MixerImpl(uint sampleRate, bool stereo = true, uint outBufSize = 0, uint outBytesPerSample = 2, bool clamp = true);
 	~MixerImpl();
 
-	bool isReady() const override { Common::StackLock lock(_mutex); return _mixerReady; }
+	bool isReady() const override { return _mixerReady; }
 
 	Common::Mutex &mutex() override { return _mutex; }
 
@@ -98,7 +187,8 @@ public:
 		int id, byte volume, int8 balance,
 		DisposeAfterUse::Flag autofreeStream,
 		bool permanent,
-		bool reverseStereo) override;
+		bool reverseStereo,
+		bool renderAhead) override;
 
 	void stopAll() override;
 	void stopID(int id) override;
@@ -146,6 +236,47 @@ public:
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	void removeChannel(int index);
+
+	/**
+	 * Return the index of the status slot for the given handle, or -1 if the
+	 * handle does not refer to a currently active sound.
+	 */
+	int findStatus(SoundHandle handle) const;
+
+	/**
+	 * Read a field of the status slot of the given handle, checking that the
+	 * slot was not reused for another sound while reading it.
+	 */
+	template<typename T>
+	T readStatus(SoundHandle handle, const std::atomic<T> ChannelStatus::*field, T defaultValue) const;
+
+	/**
+	 * Publish a channel parameter change in the status table and queue it
+	 * for the audio thread. If the queue is full, pending commands are
+	 * processed first with the mutex held.
+	 */
+	template<typename T>
+	void queueCommand(CommandType type, SoundHandle handle, std::atomic<T> ChannelStatus::*field, T value);
+
+	/**
+	 * Apply all pending channel parameter changes. Must be called with the
+	 * mutex held.
+	 */
+	void processCommands();
+	void applyCommand(const Command &cmd);
+
+	/**
+	 * Allocate the mix bus buffer for the output buffer size, so that the
+	 * callback never has to. Must be called with the mutex held.
+	 */
+	void allocateMixBuffer();
+
+	/**
+	 * Mix all playing channels into the given buffer, which is only cleared
+	 * if one of them is not silent. Must be called with the mutex held.
+	 */
+	int mixChannels(byte *buffer, uint numFrames, uint bytesPerSample, MixMode mixMode, bool &zeroed);
 
 public:
 	/**
@@ -170,6 +301,24 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Enable or disable the 32-bit mix bus. This only has an effect if the
+	 * mixer produces clamped 16-bit output, which is the default.
+	 */
+	void setMixBus(bool enable);
+
+	/**
+	 * Allow streams played with renderAhead to be read ahead of time on a
+	 * worker thread. This has no effect if the backend does not support
+	 * threads.
+	 */
+	void setRenderAhead(bool enable);
+
+private:
+	void addRenderAheadStream(RenderAheadStream *stream);
+	void removeRenderAheadStream(RenderAheadStream *stream);
+	static void renderAheadProc(void *data);
 };
 
 /** @} */
@@ -167,5 +167,18 @@ MODULE_OBJS += \
 	soundfont/vab/vab.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate-avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Signed division of 32-bit products by 256, rounding towards zero like C does
+static FORCEINLINE __m256i avx2_div256(__m256i p) {
+	return _mm256_srai_epi32(_mm256_add_epi32(p, _mm256_and_si256(_mm256_srai_epi32(p, 31), _mm256_set1_epi32(255))), 8);
+}
+
+void StereoMix::mixAVX2(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m256i vol = _mm256_set1_epi32((int32)(((uint32)vol1 << 16) | vol0));
+
+	// 8 stereo frames per iteration. Unpacking and packing both work within
+	// 128-bit lanes, so the sample order is preserved.
+	uint i = 0;
+	for (; i + 8 <= frames; i += 8) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)src);
+		const __m256i lo = _mm256_mullo_epi16(in, vol);
+		const __m256i hi = _mm256_mulhi_epi16(in, vol);
+		const __m256i p0 = avx2_div256(_mm256_unpacklo_epi16(lo, hi));
+		const __m256i p1 = avx2_div256(_mm256_unpackhi_epi16(lo, hi));
+
+		__m256i out = _mm256_loadu_si256((const __m256i *)dst);
+		out = _mm256_adds_epi16(out, _mm256_packs_epi32(p0, p1));
+		_mm256_storeu_si256((__m256i *)dst, out);
+
+		src += 16;
+		dst += 16;
+	}
+
+	mixGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::accumAVX2(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m256i vol = _mm256_set1_epi32((int32)(((uint32)vol1 << 16) | vol0));
+
+	// 8 stereo frames per iteration
+	uint i = 0;
+	for (; i + 8 <= frames; i += 8) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)src);
+		const __m256i lo = _mm256_mullo_epi16(in, vol);
+		const __m256i hi = _mm256_mulhi_epi16(in, vol);
+		const __m256i p0 = avx2_div256(_mm256_unpacklo_epi16(lo, hi));
+		const __m256i p1 = avx2_div256(_mm256_unpackhi_epi16(lo, hi));
+
+		// Unpacking works within 128-bit lanes, so put the samples back in order
+		const __m256i first = _mm256_permute2x128_si256(p0, p1, 0x20);
+		const __m256i second = _mm256_permute2x128_si256(p0, p1, 0x31);
+
+		_mm256_storeu_si256((__m256i *)dst, _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)dst), first));
+		_mm256_storeu_si256((__m256i *)(dst + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(dst + 8)), second));
+
+		src += 16;
+		dst += 16;
+	}
+
+	accumGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::clampAVX2(int16 *dst, const int32 *src, uint samples) {
+	uint i = 0;
+	for (; i + 16 <= samples; i += 16) {
+		const __m256i s0 = _mm256_loadu_si256((const __m256i *)src);
+		const __m256i s1 = _mm256_loadu_si256((const __m256i *)(src + 8));
+
+		// Packing works within 128-bit lanes, so put the samples back in order
+		const __m256i packed = _mm256_packs_epi32(s0, s1);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+
+		src += 16;
+		dst += 16;
+	}
+
+	clampGeneric(dst, src, samples - i);
+}
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+// Signed division of 32-bit products by 256, rounding towards zero like C does
+static FORCEINLINE int32x4_t neon_div256(int32x4_t p) {
+	const int32x4_t bias = vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(255));
+	return vshrq_n_s32(vaddq_s32(p, bias), 8);
+}
+
+void StereoMix::mixNEON(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const int16 volArray[4] = { (int16)vol0, (int16)vol1, (int16)vol0, (int16)vol1 };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	// 4 stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const int16x8_t in = vld1q_s16(src);
+		const int32x4_t p0 = neon_div256(vmull_s16(vget_low_s16(in), vol));
+		const int32x4_t p1 = neon_div256(vmull_s16(vget_high_s16(in), vol));
+
+		// The volume is at most kMaxMixerVolume, so the scaled samples fit
+		// in 16 bits and the saturating add is the same as clamping
+		const int16x8_t scaled = vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+		vst1q_s16(dst, vqaddq_s16(vld1q_s16(dst), scaled));
+
+		src += 8;
+		dst += 8;
+	}
+
+	mixGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::accumNEON(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const int16 volArray[4] = { (int16)vol0, (int16)vol1, (int16)vol0, (int16)vol1 };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	// 4 stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const int16x8_t in = vld1q_s16(src);
+		const int32x4_t p0 = neon_div256(vmull_s16(vget_low_s16(in), vol));
+		const int32x4_t p1 = neon_div256(vmull_s16(vget_high_s16(in), vol));
+
+		vst1q_s32(dst, vaddq_s32(vld1q_s32(dst), p0));
+		vst1q_s32(dst + 4, vaddq_s32(vld1q_s32(dst + 4), p1));
+
+		src += 8;
+		dst += 8;
+	}
+
+	accumGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::clampNEON(int16 *dst, const int32 *src, uint samples) {
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const int16x8_t packed = vcombine_s16(vqmovn_s32(vld1q_s32(src)), vqmovn_s32(vld1q_s32(src + 4)));
+		vst1q_s16(dst, packed);
+
+		src += 8;
+		dst += 8;
+	}
+
+	clampGeneric(dst, src, samples - i);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
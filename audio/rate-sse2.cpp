@@ -0,0 +1,119 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Signed division of 32-bit products by 256, rounding towards zero like C does
+static FORCEINLINE __m128i sse2_div256(__m128i p) {
+	return _mm_srai_epi32(_mm_add_epi32(p, _mm_and_si128(_mm_srai_epi32(p, 31), _mm_set1_epi32(255))), 8);
+}
+
+void StereoMix::mixSSE2(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m128i vol = _mm_set_epi16(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+
+	// 4 stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		const __m128i p0 = sse2_div256(_mm_unpacklo_epi16(lo, hi));
+		const __m128i p1 = sse2_div256(_mm_unpackhi_epi16(lo, hi));
+
+		// The volume is at most kMaxMixerVolume, so the scaled samples fit
+		// in 16 bits and the saturating add is the same as clamping
+		__m128i out = _mm_loadu_si128((const __m128i *)dst);
+		out = _mm_adds_epi16(out, _mm_packs_epi32(p0, p1));
+		_mm_storeu_si128((__m128i *)dst, out);
+
+		src += 8;
+		dst += 8;
+	}
+
+	mixGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::accumSSE2(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	const __m128i vol = _mm_set_epi16(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+
+	// 4 stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		const __m128i p0 = sse2_div256(_mm_unpacklo_epi16(lo, hi));
+		const __m128i p1 = sse2_div256(_mm_unpackhi_epi16(lo, hi));
+
+		_mm_storeu_si128((__m128i *)dst, _mm_add_epi32(_mm_loadu_si128((const __m128i *)dst), p0));
+		_mm_storeu_si128((__m128i *)(dst + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(dst + 4)), p1));
+
+		src += 8;
+		dst += 8;
+	}
+
+	accumGeneric(dst, src, frames - i, vol0, vol1);
+}
+
+void StereoMix::clampSSE2(int16 *dst, const int32 *src, uint samples) {
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const __m128i s0 = _mm_loadu_si128((const __m128i *)src);
+		const __m128i s1 = _mm_loadu_si128((const __m128i *)(src + 4));
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(s0, s1));
+
+		src += 8;
+		dst += 8;
+	}
+
+	clampGeneric(dst, src, samples - i);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
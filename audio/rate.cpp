@@ -31,9 +31,11 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -49,6 +51,98 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Number of frames resampled at once into a temporary buffer before being
+ * mixed into the output by a StereoMix function.
+ */
+enum {
+	STEREO_MIX_CHUNK = 256
+};
+
+StereoMix::MixFunc StereoMix::mixFunc = nullptr;
+StereoMix::AccumFunc StereoMix::accumFunc = nullptr;
+StereoMix::ClampFunc StereoMix::clampFunc = nullptr;
+
+void StereoMix::detect() {
+	mixFunc = mixGeneric;
+	accumFunc = accumGeneric;
+	clampFunc = clampGeneric;
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		mixFunc = mixNEON;
+		accumFunc = accumNEON;
+		clampFunc = clampNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		mixFunc = mixSSE2;
+		accumFunc = accumSSE2;
+		clampFunc = clampSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		mixFunc = mixAVX2;
+		accumFunc = accumAVX2;
+		clampFunc = clampAVX2;
+	}
+#endif
+#endif
+}
+
+StereoMix::MixFunc StereoMix::getMixFunc() {
+	// If no function has been selected yet, detect and select
+	if (!mixFunc)
+		detect();
+
+	return mixFunc;
+}
+
+StereoMix::AccumFunc StereoMix::getAccumFunc() {
+	if (!accumFunc)
+		detect();
+
+	return accumFunc;
+}
+
+StereoMix::ClampFunc StereoMix::getClampFunc() {
+	if (!clampFunc)
+		detect();
+
+	return clampFunc;
+}
+
+void StereoMix::mixGeneric(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	for (uint i = 0; i < frames; i++) {
+		processSample<MIX_CLAMPED_ADD>(dst[0], (src[0] * (int)vol0) / Audio::Mixer::kMaxMixerVolume);
+		processSample<MIX_CLAMPED_ADD>(dst[1], (src[1] * (int)vol1) / Audio::Mixer::kMaxMixerVolume);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void StereoMix::accumGeneric(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1) {
+	for (uint i = 0; i < frames; i++) {
+		processSample<MIX_ADD>(dst[0], (src[0] * (int)vol0) / Audio::Mixer::kMaxMixerVolume);
+		processSample<MIX_ADD>(dst[1], (src[1] * (int)vol1) / Audio::Mixer::kMaxMixerVolume);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void StereoMix::clampGeneric(int16 *dst, const int32 *src, uint samples) {
+	for (uint i = 0; i < samples; i++) {
+		const int32 val = CLIP<int32>(src[i], -32768, 32767);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		dst[i] = (int16)(val ^ 0x8000);
+#else
+		dst[i] = (int16)val;
+#endif
+	}
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
 private:
@@ -95,6 +189,9 @@ private:
 	template<typename st_sample_t, MixMode mixMode>
 	int convertForType(AudioStream &input, byte *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR);
 
+	template<typename st_sample_t>
+	int convertStereoMix(void (*mixFunc)(st_sample_t *, const int16 *, uint, st_volume_t, st_volume_t), AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR);
+
 	// keep a single printConvertType shared across all RateConverter_Impl specializations.
 	// PrintContext must be trivially destructible: it lives in a function-scope static and
 	// is torn down after the OSystem (and its memory pool that backs Common::String) is gone.
@@ -525,8 +622,55 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertForType(Audio
 	}
 }
 
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<typename st_sample_t>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertStereoMix(void (*mixFunc)(st_sample_t *, const int16 *, uint, st_volume_t, st_volume_t), AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	// Resample at full volume into a temporary buffer, then mix it into the
+	// output with the vectorized function. Since scaling by kMaxMixerVolume
+	// is lossless, this gives the same result as the direct path. The
+	// samples are already swapped for reversed stereo output, so the
+	// volumes have to be swapped as well.
+	int16 tmp[STEREO_MIX_CHUNK * 2];
+	const st_volume_t vol0 = reverseStereo ? volR : volL;
+	const st_volume_t vol1 = reverseStereo ? volL : volR;
+
+	int total = 0;
+	while (numSamples > 0) {
+		const st_size_t chunk = MIN<st_size_t>(numSamples, STEREO_MIX_CHUNK);
+
+		memset(tmp, 0, chunk * 2 * sizeof(int16));
+		const int res = convertForType<int16, MIX_ADD>(input, (byte *)tmp, chunk, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		mixFunc(outBuffer, tmp, res, vol0, vol1);
+
+		total += res;
+		if ((st_size_t)res < chunk)
+			break;
+
+		outBuffer += res * 2;
+		numSamples -= res;
+	}
+
+	return total;
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, byte *outBuffer, uint outBytesPerSample, st_size_t numSamples, st_volume_t volL, st_volume_t volR, MixMode mixMode) {
+	// Use a vectorized implementation for the most common case, i.e. the
+	// mixer's 16-bit clamped stereo output and its 32-bit mix bus at full
+	// volume. With other volumes, the scalar path skips the silent channels
+	// and doesn't carry their resampling state along, so keep using it.
+	if (outStereo && volL == Audio::Mixer::kMaxMixerVolume && volR == Audio::Mixer::kMaxMixerVolume) {
+		if (outBytesPerSample == sizeof(int16) && mixMode == MIX_CLAMPED_ADD) {
+			StereoMix::MixFunc mixFunc = StereoMix::getMixFunc();
+			if (mixFunc != StereoMix::mixGeneric)
+				return convertStereoMix(mixFunc, input, (int16 *)outBuffer, numSamples, volL, volR);
+		} else if (outBytesPerSample == sizeof(int32) && mixMode == MIX_ADD) {
+			StereoMix::AccumFunc accumFunc = StereoMix::getAccumFunc();
+			if (accumFunc != StereoMix::accumGeneric)
+				return convertStereoMix(accumFunc, input, (int32 *)outBuffer, numSamples, volL, volR);
+		}
+	}
+
 	if (outBytesPerSample == sizeof(int32)) {
 		if (mixMode == MIX_ADD)
 			return convertForType<int32, MIX_ADD>(input, outBuffer, numSamples, volL, volR);
@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Volume scaling and mixing of 16-bit stereo frames, as done by the rate
+ * converters when mixing into the output buffer of the mixer.
+ *
+ * Like BlendBlit, the implementation is selected at runtime depending on the
+ * SIMD instruction sets supported by the CPU. All implementations produce the
+ * exact same output as the scalar code in RateConverter_Impl.
+ */
+class StereoMix {
+public:
+	/**
+	 * Scale the interleaved stereo frames in @p src by the given volumes and
+	 * add them to @p dst, clamping the result to the int16 range.
+	 *
+	 * @param dst     Output frames to mix into.
+	 * @param src     Input frames.
+	 * @param frames  Number of stereo frames to process.
+	 * @param vol0    Volume applied to the first sample of each frame, at most kMaxMixerVolume.
+	 * @param vol1    Volume applied to the second sample of each frame, at most kMaxMixerVolume.
+	 */
+	typedef void(*MixFunc)(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+
+	/**
+	 * Same as MixFunc, but adds to a 32-bit buffer without clamping. This
+	 * is used to mix channels into the mixer's intermediate mix bus.
+	 */
+	typedef void(*AccumFunc)(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+
+	/**
+	 * Clamp the 32-bit samples in @p src to the int16 range and store them
+	 * in @p dst. This is the final pass of the mixer's mix bus.
+	 *
+	 * @param dst      Output samples.
+	 * @param src      Mixed samples.
+	 * @param samples  Number of samples (not frames) to convert.
+	 */
+	typedef void(*ClampFunc)(int16 *dst, const int32 *src, uint samples);
+
+	/** Currently selected implementations, nullptr until first used. */
+	static MixFunc mixFunc;
+	static AccumFunc accumFunc;
+	static ClampFunc clampFunc;
+
+	/**
+	 * Return the implementation to use, detecting the CPU features first if
+	 * needed.
+	 */
+	static MixFunc getMixFunc();
+	static AccumFunc getAccumFunc();
+	static ClampFunc getClampFunc();
+
+	static void mixGeneric(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void accumGeneric(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void clampGeneric(int16 *dst, const int32 *src, uint samples);
+#ifdef SCUMMVM_NEON
+	static void mixNEON(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void accumNEON(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void clampNEON(int16 *dst, const int32 *src, uint samples);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void accumSSE2(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void clampSSE2(int16 *dst, const int32 *src, uint samples);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(int16 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void accumAVX2(int32 *dst, const int16 *src, uint frames, st_volume_t vol0, st_volume_t vol1);
+	static void clampAVX2(int16 *dst, const int32 *src, uint samples);
+#endif
+
+private:
+	static void detect();
+};
+
+} // End of namespace Audio
+
+#endif
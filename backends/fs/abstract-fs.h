@@ -172,6 +172,14 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node, without opening it. The modification time is only meant
+	 * to be compared with earlier values for the same file.
+	 *
+	 * @return true if successful, false if this is not supported or the file cannot be accessed.
+	 */
+	virtual bool getFileStats(int64 &size, int64 &mtime) const;
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +190,16 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance for game data, which nothing
+	 * writes to while it is read. Backends may then read it in a faster
+	 * way, e.g. by mapping the file into memory. The default
+	 * implementation calls createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createDataReadStream();
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
@@ -42,12 +42,14 @@ public:
 	bool isDirectory() const override;
 	bool isReadable() const override;
 	bool isWritable() const override;
+	bool getFileStats(int64 &size, int64 &mtime) const override;
 
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
 	AbstractFSNode *getParent() const override;
 
 	Common::SeekableReadStream *createReadStream() override;
+	Common::SeekableReadStream *createDataReadStream() override;
 	Common::SeekableWriteStream *createWriteStream(bool atomic) override;
 	bool createDirectory() override;
 
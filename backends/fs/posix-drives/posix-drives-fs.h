@@ -66,6 +66,8 @@ public:
 
 	// AbstractFSNode API
 	Common::SeekableReadStream *createReadStream() override;
+	// Game data is read with the buffering of the drive as well
+	Common::SeekableReadStream *createDataReadStream() override { return createReadStream(); }
 	Common::SeekableWriteStream *createWriteStream(bool atomic) override;
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
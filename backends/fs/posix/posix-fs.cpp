@@ -33,6 +33,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -67,6 +68,23 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+bool POSIXFilesystemNode::getFileStats(int64 &size, int64 &mtime) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	// In nanoseconds where available, so that changes within a second are
+	// noticed
+	mtime = (int64)st.st_mtime * 1000000000;
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+	mtime += st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+	mtime += st.st_mtimespec.tv_nsec;
+#endif
+	return true;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -279,6 +297,20 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), StdioStream::WriteMode_Read);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createDataReadStream() {
+#ifdef HAS_MMAP
+	// Only game data is mapped: reading a mapped file which another writer
+	// truncates raises SIGBUS instead of ending the stream. Small files are
+	// cheaper to read through the stdio buffer than to map.
+	const int64 kMinMmapSize = 64 * 1024;
+	Common::SeekableReadStream *stream = PosixMmapStream::makeFromPath(getPath(), kMinMmapSize);
+	if (stream)
+		return stream;
+#endif
+
+	return createReadStream();
+}
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 #ifdef MACOSX
 	if (altStreamType == Common::AltStreamType::MacResourceFork) {
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#ifdef HAS_MMAP
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path, int64 minSize) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size < minSize ||
+	        (uint64)st.st_size > SIZE_MAX / 4) {
+		// Leave anything unusual, or too large for the address space, to
+		// the regular streams
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the file descriptor has been closed
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMmapStream((const byte *)data, st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(const byte *data, int64 size) :
+		_data(data), _size(size), _pos(0), _eos(false) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(const_cast<byte *>(_data), _size);
+}
+
+bool PosixMmapStream::seek(int64 offs, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offs += _size;
+		break;
+	case SEEK_CUR:
+		offs += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	// Like fseek(), allow seeking past the end but not before the start
+	if (offs < 0)
+		return false;
+
+	_pos = offs;
+	_eos = false;
+	return true;
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	if (_pos >= _size) {
+		_eos = true;
+		return 0;
+	}
+
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+	return dataSize;
+}
+
+const byte *PosixMmapStream::getRange(int64 offset, uint32 dataSize) const {
+	if (offset < 0 || offset > _size || dataSize > _size - offset)
+		return nullptr;
+
+	return _data + offset;
+}
+
+#endif
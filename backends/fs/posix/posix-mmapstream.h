@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/noncopyable.h"
+#include "common/str.h"
+#include "common/stream.h"
+
+/**
+ * A read-only file stream which maps the whole file into memory.
+ *
+ * Reads are plain memory copies without any system call, and the file
+ * data can be accessed without copying through getRange().
+ */
+class PosixMmapStream final : public Common::SeekableReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Given a path, maps the file into memory and wraps it in a
+	 * PosixMmapStream instance. Returns nullptr if the file is not a
+	 * regular file, is smaller than minSize, or cannot be mapped.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path, int64 minSize);
+
+	~PosixMmapStream() override;
+
+	bool err() const override { return false; }
+	void clearErr() override { _eos = false; }
+	bool eos() const override { return _eos; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offs, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	const byte *getRange(int64 offset, uint32 dataSize) const override;
+
+private:
+	PosixMmapStream(const byte *data, int64 size);
+
+	const byte *_data;
+	int64 _size;
+	int64 _pos;
+	bool _eos;
+};
+
+#endif
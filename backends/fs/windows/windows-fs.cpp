@@ -44,6 +44,18 @@ bool WindowsFilesystemNode::isWritable() const {
 	return ((fileAttribs != INVALID_FILE_ATTRIBUTES) && (!(fileAttribs & FILE_ATTRIBUTE_READONLY)));
 }
 
+bool WindowsFilesystemNode::getFileStats(int64 &size, int64 &mtime) const {
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesEx(charToTchar(_path.c_str()), GetFileExInfoStandard, &data))
+		return false;
+	if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		return false;
+
+	size = ((int64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	mtime = ((int64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
 void WindowsFilesystemNode::addFile(AbstractFSList &list, ListMode mode, const char *base, bool hidden, WIN32_FIND_DATA* find_data) {
 	// Skip local directory (.) and parent (..)
 	if (!_tcscmp(find_data->cFileName, TEXT(".")) ||
@@ -34,6 +34,7 @@
 #include "common/translation.h"
 #include "common/algorithm.h"
 #include "common/file.h"
+#include "common/frametimings.h"
 #include "common/zip-set.h"
 #include "gui/debugger.h"
 #include "engines/engine.h"
@@ -89,7 +90,7 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 #endif
 #ifdef USE_OSD
 	  , _osdMessageChangeRequest(false), _osdMessageAlpha(0), _osdMessageFadeStartTime(0), _osdMessageSurface(nullptr),
-	  _osdIconSurface(nullptr)
+	  _osdIconSurface(nullptr), _showUploadStats(false), _uploadStatsBytes(0), _uploadStatsFrames(0), _uploadStatsStartTime(0)
 #endif
 #ifdef USE_SCALERS
 	  , _scalerPlugins(ScalerMan.getPlugins())
@@ -97,6 +98,11 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 	{
 	memset(_gamePalette, 0, sizeof(_gamePalette));
 	OpenGLContext.reset();
+
+#ifdef USE_OSD
+	if (ConfMan.hasKey("opengl_debug_upload_stats"))
+		_showUploadStats = ConfMan.getBool("opengl_debug_upload_stats");
+#endif
 }
 
 OpenGLGraphicsManager::~OpenGLGraphicsManager() {
@@ -775,6 +781,9 @@ void OpenGLGraphicsManager::updateScreen() {
 #endif
 
 	// Update changes to textures.
+	Common::FrameTimings *frameTimings = g_system->getFrameTimings();
+	const uint64 convertStart = frameTimings ? g_system->getMicros() : 0;
+
 	if (_gameScreen) {
 		_gameScreen->updateGLTexture();
 	}
@@ -787,6 +796,15 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	if (frameTimings)
+		frameTimings->addTime(Common::FrameTimings::kStageConvert, (uint32)(g_system->getMicros() - convertStart));
+
+#ifdef USE_OSD
+	if (_showUploadStats) {
+		updateUploadStats();
+	}
+#endif
+
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
 		_libretroPipeline->beginScaling();
@@ -1334,6 +1352,23 @@ void OpenGLGraphicsManager::displayMessageOnOSD(const Common::U32String &msg) {
 }
 
 #ifdef USE_OSD
+void OpenGLGraphicsManager::updateUploadStats() {
+	_uploadStatsBytes += Texture::getUploadedBytes();
+	Texture::resetUploadedBytes();
+	++_uploadStatsFrames;
+
+	const uint32 now = g_system->getMillis(false);
+	if (now - _uploadStatsStartTime < 1000) {
+		return;
+	}
+
+	displayMessageOnOSD(Common::U32String::format("Texture uploads: %u KB per frame", _uploadStatsBytes / _uploadStatsFrames / 1024));
+
+	_uploadStatsBytes = 0;
+	_uploadStatsFrames = 0;
+	_uploadStatsStartTime = now;
+}
+
 void OpenGLGraphicsManager::osdMessageUpdateSurface() {
 	// Split up the lines.
 	Common::Array<Common::U32String> osdLines;
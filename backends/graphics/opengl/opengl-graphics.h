@@ -535,6 +535,25 @@ private:
 		kOSDIconTopMargin = 10,
 		kOSDIconRightMargin = 10
 	};
+
+	/**
+	 * Whether to show the number of bytes uploaded to textures per frame
+	 * on the OSD. Enabled with the "opengl_debug_upload_stats" setting.
+	 */
+	bool _showUploadStats;
+
+	/**
+	 * Bytes uploaded and frames drawn since the upload stats were last shown.
+	 */
+	uint32 _uploadStatsBytes;
+	uint _uploadStatsFrames;
+	uint32 _uploadStatsStartTime;
+
+	/**
+	 * Accumulate the bytes uploaded in the current frame, and show the
+	 * average on the OSD once per second.
+	 */
+	void updateUploadStats();
 #endif
 };
 
@@ -44,7 +44,7 @@ namespace OpenGL {
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyRects() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -85,23 +85,29 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 }
 
 void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
+	// Empty rects would break Common::Rect::extend when merging, and nothing
+	// needs to be tracked when everything is dirty anyway.
+	if (r.isEmpty() || _allDirty) {
+		return;
+	}
+
+	_dirtyRects.push_back(r);
+
+	// Some engines update lots of small areas every frame, so keep the list
+	// short.
+	if (_dirtyRects.size() > kMaxDirtyAreas * 8) {
+		_dirtyRects.merge(kDirtyAreaOverhead, kMaxDirtyAreas);
 	}
 }
 
-Common::Rect Surface::getDirtyArea() const {
+const Graphics::DirtyRectList &Surface::getDirtyAreas() {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		_dirtyRects.clear();
+		_dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
 	} else {
-		return _dirtyArea;
+		_dirtyRects.merge(kDirtyAreaOverhead, kMaxDirtyAreas);
 	}
+	return _dirtyRects;
 }
 
 //
@@ -165,12 +171,15 @@ void TextureSurface::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	for (const auto &dirtyArea : getDirtyAreas()) {
+		updateGLTextureArea(dirtyArea);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
-void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
+void TextureSurface::updateGLTextureArea(Common::Rect dirtyArea) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
@@ -201,9 +210,6 @@ void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTextureSurface::FakeTextureSurface(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -288,12 +294,12 @@ void FakeTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
-
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+	for (const auto &dirtyArea : getDirtyAreas()) {
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	TextureSurface::updateGLTexture();
@@ -379,46 +385,48 @@ void ScaledTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	for (Common::Rect dirtyArea : getDirtyAreas()) {
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		// Do generic handling of updating the texture.
+		TextureSurface::updateGLTextureArea(dirtyArea);
+	}
 
-	// Do generic handling of updating the texture.
-	TextureSurface::updateGLTexture(dirtyArea);
+	clearDirty();
 }
 
 void ScaledTextureSurface::setScaler(uint scalerIndex, int scaleFactor) {
@@ -582,7 +590,9 @@ void TextureSurfaceCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		for (const auto &dirtyArea : getDirtyAreas()) {
+			_clut8Texture.updateArea(dirtyArea, _clut8Data);
+		}
 		clearDirty();
 	}
 
@@ -29,6 +29,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/blit.h"
+#include "graphics/dirtyrects.h"
 
 #include "common/rect.h"
 #include "common/rotationmode.h"
@@ -108,7 +109,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRects.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -148,13 +149,26 @@ public:
 	 */
 	virtual const Texture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRects.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+
+	/**
+	 * Merge the dirty areas which are cheaper to update together, and return
+	 * the remaining ones. Calling this again without adding more dirty areas
+	 * returns the same list.
+	 */
+	const Graphics::DirtyRectList &getDirtyAreas();
 private:
+	enum {
+		/** The cost of updating one more area, in pixels. */
+		kDirtyAreaOverhead = 64 * 64,
+		/** The maximum number of areas which are updated separately. */
+		kMaxDirtyAreas = 8
+	};
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Graphics::DirtyRectList _dirtyRects;
 };
 
 /**
@@ -199,7 +213,10 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
-	void updateGLTexture(Common::Rect &dirtyArea);
+	/**
+	 * Upload an area of the texture data, without clearing the dirty state.
+	 */
+	void updateGLTextureArea(Common::Rect dirtyArea);
 
 private:
 	Texture _glTexture;
@@ -31,6 +31,8 @@
 #include "common/util.h"
 #include "common/file.h"
 #include "common/frac.h"
+#include "common/frametimings.h"
+#include "common/thread.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
@@ -191,7 +193,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
 	_transactionMode(kTransactionNone),
-	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
+	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr), _scalerThreads(nullptr),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
@@ -244,6 +246,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
 	delete _scaler;
 	delete _mouseScaler;
+	delete _scalerThreads;
 	if (_mouseOrigSurface) {
 		destroySurface(_mouseOrigSurface);
 		if (_mouseOrigSurface == _mouseSurface) {
@@ -710,6 +713,14 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
 
+		// Scale large dirty rects on all cores if the scaler allows it. The
+		// cursor is small, so the mouse scaler doesn't need the threads.
+		if (_scalerPlugin->canScaleInBands()) {
+			if (!_scalerThreads)
+				_scalerThreads = new Common::ThreadPool(0, "ScummVM scaler");
+			_scaler->setThreadPool(_scalerThreads);
+		}
+
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
 			_mouseScaler = _scalerPlugin->createInstance(_cursorFormat);
@@ -1385,6 +1396,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				error("SDL_BlitSurface failed: %s", SDL_GetError());
 		}
 
+		Common::FrameTimings *frameTimings = g_system->getFrameTimings();
+		const uint64 convertStart = frameTimings ? g_system->getMicros() : 0;
+
 		SDL_LockSurface(srcSurf);
 		SDL_LockSurface(_hwScreen);
 
@@ -1460,6 +1474,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwScreen);
 
+		if (frameTimings)
+			frameTimings->addTime(Common::FrameTimings::kStageConvert, (uint32)(g_system->getMicros() - convertStart));
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceRedraw) {
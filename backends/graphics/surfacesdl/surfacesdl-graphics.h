@@ -335,6 +335,7 @@ protected:
 	const PluginList &_scalerPlugins;
 	ScalerPluginObject *_scalerPlugin;
 	Scaler *_scaler, *_mouseScaler;
+	Common::ThreadPool *_scalerThreads;
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
@@ -144,6 +144,10 @@ void SdlMixerManager::init() {
 
 	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desiredSamples);
 	assert(_mixer);
+	if (ConfMan.hasKey("audio_mix_bus"))
+		_mixer->setMixBus(ConfMan.getBool("audio_mix_bus"));
+	if (ConfMan.hasKey("audio_render_ahead"))
+		_mixer->setRenderAhead(ConfMan.getBool("audio_render_ahead"));
 	_mixer->setReady(true);
 
 	startAudio();
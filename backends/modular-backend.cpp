@@ -26,6 +26,7 @@
 #include "backends/mixer/mixer.h"
 #include "gui/EventRecorder.h"
 
+#include "common/frametimings.h"
 #include "common/timer.h"
 #include "graphics/pixelformat.h"
 
@@ -195,7 +196,13 @@ void ModularGraphicsBackend::updateScreen() {
 	g_eventRec.preDrawOverlayGui();
 #endif
 
-	_graphicsManager->updateScreen();
+	if (_frameTimings) {
+		const uint64 start = getMicros();
+		_graphicsManager->updateScreen();
+		_frameTimings->endFrame(start, getMicros());
+	} else {
+		_graphicsManager->updateScreen();
+	}
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.postDrawOverlayGui();
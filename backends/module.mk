@@ -218,6 +218,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 ifndef USE_SDL3
@@ -280,6 +281,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
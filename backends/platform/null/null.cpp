@@ -51,14 +51,21 @@ typedef void (*sighandler_t)(int);
 
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
 #include "base/main.h"
 
+// Let the tests exercise code which uses worker threads
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+#define NULL_DRIVER_USE_THREADS
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -87,6 +94,11 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef NULL_DRIVER_USE_THREADS
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *data), void *data, const char *name);
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue);
+	virtual uint getCPUCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -158,6 +170,10 @@ void OSystem_NULL::initBackend() {
 	_mixerManager->init();
 
 	BaseBackend::initBackend();
+#else
+	// Code under test may ask for the screen format, like the video decoders
+	_graphicsManager = new NullGraphicsManager();
+	_graphicsManager->initSize(320, 200);
 #endif
 }
 
@@ -189,8 +205,26 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef NULL_DRIVER_USE_THREADS
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+#ifdef NULL_DRIVER_USE_THREADS
+Common::ThreadInternal *OSystem_NULL::createThread(void (*proc)(void *data), void *data, const char *name) {
+	return createPthreadThreadInternal(proc, data, name);
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore(uint initialValue) {
+	return createPthreadSemaphoreInternal(initialValue);
+}
+
+uint OSystem_NULL::getCPUCount() {
+	return getPthreadCPUCount();
 }
+#endif
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
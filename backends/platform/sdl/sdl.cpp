@@ -46,6 +46,7 @@
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -866,6 +867,18 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(void (*proc)(void *data), void *data, const char *name) {
+	return createSdlThreadInternal(proc, data, name);
+}
+
+Common::SemaphoreInternal *OSystem_SDL::createSemaphore(uint initialValue) {
+	return createSdlSemaphoreInternal(initialValue);
+}
+
+uint OSystem_SDL::getCPUCount() {
+	return getSdlCPUCount();
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
@@ -883,6 +896,16 @@ void OSystem_SDL::delayMillis(uint msecs) {
 		SDL_Delay(msecs);
 }
 
+uint64 OSystem_SDL::getMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
 void OSystem_SDL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	time_t curTime = time(nullptr);
 	struct tm t = *localtime(&curTime);
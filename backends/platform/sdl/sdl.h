@@ -89,8 +89,12 @@ public:
 	void setWindowCaption(const Common::U32String &caption) override;
 	void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(void (*proc)(void *data), void *data, const char *name) override;
+	Common::SemaphoreInternal *createSemaphore(uint initialValue) override;
+	uint getCPUCount() override;
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
+	uint64 getMicros() override;
 	void getTimeAndDate(TimeDate &td, bool skipRecord = false) const override;
 	MixerManager *getMixerManager() override;
 	Common::TimerManager *getTimerManager() override;
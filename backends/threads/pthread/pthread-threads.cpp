@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/threads/pthread/pthread-threads.h"
+
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data), _joinable(false) {}
+
+	~PthreadThreadInternal() override {
+		if (_joinable)
+			pthread_detach(_thread);
+	}
+
+	bool start() {
+		_joinable = (pthread_create(&_thread, nullptr, threadFunc, this) == 0);
+		return _joinable;
+	}
+
+	void join() override {
+		if (_joinable && pthread_join(_thread, nullptr) != 0)
+			warning("pthread_join() failed");
+		_joinable = false;
+	}
+
+private:
+	static void *threadFunc(void *data) {
+		PthreadThreadInternal *thread = (PthreadThreadInternal *)data;
+		thread->_proc(thread->_data);
+		return nullptr;
+	}
+
+	Common::ThreadProc _proc;
+	void *_data;
+	pthread_t _thread;
+	bool _joinable;
+};
+
+/**
+ * pthreads semaphore implementation
+ *
+ * Unnamed POSIX semaphores are not available everywhere, so this is built
+ * from a mutex and a condition variable.
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal(uint initialValue) : _value(initialValue) {
+		pthread_mutex_init(&_mutex, nullptr);
+		pthread_cond_init(&_cond, nullptr);
+	}
+
+	~PthreadSemaphoreInternal() override {
+		pthread_cond_destroy(&_cond);
+		pthread_mutex_destroy(&_mutex);
+	}
+
+	void post() override {
+		pthread_mutex_lock(&_mutex);
+		_value++;
+		pthread_cond_signal(&_cond);
+		pthread_mutex_unlock(&_mutex);
+	}
+
+	void wait() override {
+		pthread_mutex_lock(&_mutex);
+		while (_value == 0)
+			pthread_cond_wait(&_cond, &_mutex);
+		_value--;
+		pthread_mutex_unlock(&_mutex);
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _value;
+};
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data, const char *name) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, data);
+	if (!thread->start()) {
+		warning("pthread_create() failed for thread %s", name);
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal(uint initialValue) {
+	return new PthreadSemaphoreInternal(initialValue);
+}
+
+uint getPthreadCPUCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 1 ? (uint)count : 1;
+#else
+	return 1;
+#endif
+}
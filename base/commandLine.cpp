@@ -346,6 +346,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("enable_unsupported_game_warning", true);
 	ConfMan.registerDefault("enable_unsupported_addon_warning", true);
 
+	ConfMan.registerDefault("detection_cache", true);
+	ConfMan.registerDefault("search_lookup_cache", true);
+
 #if defined(USE_FLUIDSYNTH) || defined(USE_FLUIDLITE)
 	ConfMan.registerDefault("soundfont", "Roland_SC-55.sf2");
 #endif
@@ -30,6 +30,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -119,6 +120,9 @@ static bool launcherDialog() {
 #endif
 		status = (dlg.runModal() != -1);
 	} while (noQuit && nullptr == ConfMan.getActiveDomain());
+
+	// Store the MD5s computed when adding games
+	ADCacheMan.flushFileCache(true);
 	return status;
 }
 
@@ -574,6 +578,10 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	// the command line params) was read.
 	system.initBackend();
 
+	// Engines tend to look for the same files, many of which do not exist,
+	// over and over again
+	SearchMan.setLookupCache(ConfMan.getBool("search_lookup_cache"));
+
 	// If we received an invalid graphics mode parameter via command line
 	// we check this here. We can't do it until after the backend is inited,
 	// or there won't be a graphics manager to ask for the supported modes.
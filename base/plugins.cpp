@@ -25,6 +25,9 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/config-manager.h"
+#include "common/md5.h"
+#include "common/stream.h"
+#include "common/thread.h"
 
 #ifdef DYNAMIC_MODULES
 #include "common/fs.h"
@@ -624,6 +627,13 @@ namespace Common {
 DECLARE_SINGLETON(EngineManager);
 }
 
+EngineManager::EngineManager() : _detectionThreads(nullptr) {
+}
+
+EngineManager::~EngineManager() {
+	delete _detectionThreads;
+}
+
 /**
  * This function works for both cached and uncached PluginManagers.
  * For the cached version, most of the logic here will short circuit.
@@ -689,6 +699,8 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Clear md5 cache before each detection starts, just in case.
 	ADCacheMan.clear();
 
+	prefetchDetection(plugins, fslist);
+
 	// Iterate over all known games and for each check if it might be
 	// the game in the presented directory.
 	for (const auto &plugin : plugins) {
@@ -706,10 +718,78 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
+	ADCacheMan.flushFileCache();
 
 	return DetectionResults(candidates);
 }
 
+enum {
+	kDetectionPrefetchBatchSize = 64
+};
+
+static void computeDetectionPrefetch(void *data, uint index) {
+	DetectionPrefetchFile *file = ((DetectionPrefetchFile **)data)[index];
+	Common::SeekableReadStream *stream = file->stream;
+	if (!stream)
+		return;
+
+	file->size = stream->size();
+	if (file->tail && file->size > file->md5Bytes)
+		stream->seek(-(int64)file->md5Bytes, SEEK_END);
+	file->computed = Common::computeStreamMD5(*stream, file->digest, file->md5Bytes);
+}
+
+void EngineManager::prefetchDetection(const PluginList &plugins, const Common::FSList &fslist) {
+	if (fslist.empty())
+		return;
+
+	if (!_detectionThreads)
+		_detectionThreads = new Common::ThreadPool(0, "ScummVM detection");
+
+	// Without threads, this would only do the same work as the detection
+	// itself, one engine after the other
+	if (_detectionThreads->getNumThreads() <= 1)
+		return;
+
+	// The engines list the files they need on this thread, where the file
+	// lists, the configuration and the caches are safe to use. The worker
+	// threads only read the opened files and compute their MD5s. The
+	// detection itself then runs on this thread as before and finds the
+	// MD5s in the cache, so its results do not depend on the threads.
+	DetectionPrefetchList files;
+	for (const auto &plugin : plugins)
+		plugin->get<MetaEngineDetection>().prefetchDetection(fslist, files);
+
+	Common::HashMap<Common::String, bool> queued;
+	DetectionPrefetchList batch;
+	for (uint i = 0; i < files.size(); i++) {
+		if (!queued.contains(files[i]->key)) {
+			queued[files[i]->key] = true;
+			batch.push_back(files[i]);
+		}
+
+		// Only a few files are opened at once
+		if (batch.size() < kDetectionPrefetchBatchSize && i + 1 < files.size())
+			continue;
+
+		for (uint j = 0; j < batch.size(); j++)
+			batch[j]->stream = batch[j]->open();
+
+		_detectionThreads->run(batch.size(), computeDetectionPrefetch, batch.data());
+
+		for (uint j = 0; j < batch.size(); j++) {
+			delete batch[j]->stream;
+			batch[j]->stream = nullptr;
+			if (batch[j]->computed)
+				batch[j]->store();
+		}
+		batch.clear();
+	}
+
+	for (uint i = 0; i < files.size(); i++)
+		delete files[i];
+}
+
 const PluginList &EngineManager::getPlugins(const PluginType fetchPluginType) const {
 	return PluginManager::instance().getPlugins(fetchPluginType);
 }
@@ -25,6 +25,7 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
 #include "common/punycode.h"
 #include "common/debug.h"
 
@@ -308,6 +309,74 @@ uint MemcachingCaseInsensitiveArchive::CacheKey_Hash::operator()(const CacheKey
 	return static_cast<uint>(x.path.hashIgnoreCase() * 1000003u) ^ static_cast<uint>(x.altStreamType);
 }
 
+std::atomic<uint32> SearchSet::_generation(0);
+
+SearchSet::~SearchSet() {
+	clear();
+	delete _lookupMutex;
+}
+
+void SearchSet::setLookupCache(bool enable) {
+	if (enable == (_lookupMutex != nullptr))
+		return;
+
+	if (enable) {
+		_lookupMutex = new Mutex();
+	} else {
+		delete _lookupMutex;
+		_lookupMutex = nullptr;
+		_fileLookups.clear(true);
+		_streamLookups.clear(true);
+	}
+}
+
+bool SearchSet::getCachedLookup(LookupCache &cache, const Path &path, Archive *&archive) const {
+	if (!_lookupMutex)
+		return false;
+
+	StackLock lock(*_lookupMutex);
+	const uint32 generation = _generation;
+	if (_lookupGeneration != generation) {
+		_fileLookups.clear();
+		_streamLookups.clear();
+		_lookupGeneration = generation;
+	}
+
+	LookupCache::const_iterator it = cache.find(path);
+	if (it == cache.end()) {
+		_lookupMisses++;
+		return false;
+	}
+
+	_lookupHits++;
+	archive = it->_value;
+	return true;
+}
+
+void SearchSet::setCachedLookup(LookupCache &cache, const Path &path, Archive *archive) const {
+	if (!_lookupMutex)
+		return;
+
+	StackLock lock(*_lookupMutex);
+	if (_lookupGeneration == _generation)
+		cache.setVal(path, archive);
+}
+
+void SearchSet::getLookupStats(uint32 &cacheHits, uint32 &cacheMisses, Array<ArchiveLookupStats> &archives) const {
+	cacheHits = _lookupHits;
+	cacheMisses = _lookupMisses;
+
+	archives.clear();
+	for (const auto &archive : _list) {
+		ArchiveLookupStats stats;
+		stats.name = archive._name;
+		stats.priority = archive._priority;
+		stats.hits = archive._hits;
+		stats.misses = archive._misses;
+		archives.push_back(stats);
+	}
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
@@ -332,6 +401,8 @@ SearchSet::ArchiveNodeList::const_iterator SearchSet::find(const String &name) c
 	order prevails.
 */
 void SearchSet::insert(const Node &node) {
+	invalidateLookupCaches();
+
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		if (it->_priority < node._priority)
@@ -434,6 +505,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateLookupCaches();
 	}
 }
 
@@ -457,6 +529,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateLookupCaches();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -479,11 +552,20 @@ bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	Archive *cached;
+	if (getCachedLookup(_fileLookups, path, cached))
+		return cached != nullptr;
+
 	for (const auto &archive : _list) {
-		if (archive._arc->hasFile(path))
+		if (archive._arc->hasFile(path)) {
+			archive._hits++;
+			setCachedLookup(_fileLookups, path, archive._arc);
 			return true;
+		}
+		archive._misses++;
 	}
 
+	setCachedLookup(_fileLookups, path, nullptr);
 	return false;
 }
 
@@ -559,15 +641,28 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	Archive *cached;
+	if (getCachedLookup(_fileLookups, path, cached)) {
+		if (!cached)
+			return ArchiveMemberPtr();
+		if (container)
+			*container = cached;
+		return cached->getMember(path);
+	}
+
 	for (const auto &archive : _list) {
 		if (archive._arc->hasFile(path)) {
+			archive._hits++;
+			setCachedLookup(_fileLookups, path, archive._arc);
 			if (container) {
 				*container = archive._arc;
 			}
 			return archive._arc->getMember(path);
 		}
+		archive._misses++;
 	}
 
+	setCachedLookup(_fileLookups, path, nullptr);
 	return ArchiveMemberPtr();
 }
 
@@ -579,12 +674,31 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
-	for (const auto &archive : _list) {
-		SeekableReadStream *stream = archive._arc->createReadStreamForMember(path);
-		if (stream)
+	// Start with the archive which provided the file last time, since the
+	// ones before it did not
+	Archive *cached = nullptr;
+	const bool isCached = getCachedLookup(_streamLookups, path, cached);
+	if (isCached && !cached)
+		return nullptr;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	if (cached) {
+		while (it != _list.end() && it->_arc != cached)
+			++it;
+	}
+
+	for (; it != _list.end(); ++it) {
+		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
+		if (stream) {
+			it->_hits++;
+			if (it->_arc != cached)
+				setCachedLookup(_streamLookups, path, it->_arc);
 			return stream;
+		}
+		it->_misses++;
 	}
 
+	setCachedLookup(_streamLookups, path, nullptr);
 	return nullptr;
 }
 
@@ -22,6 +22,7 @@
 #ifndef COMMON_ARCHIVE_H
 #define COMMON_ARCHIVE_H
 
+#include "common/array.h"
 #include "common/error.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -31,6 +32,8 @@
 #include "common/singleton.h"
 #include "common/str.h"
 
+#include <atomic>
+
 namespace Common {
 
 /**
@@ -45,6 +48,7 @@ namespace Common {
 
 class ArchiveMember;
 class FSNode;
+class Mutex;
 class SeekableReadStream;
 
 enum class AltStreamType {
@@ -333,8 +337,13 @@ class SearchSet : public Archive {
 		String	_name;
 		Archive	*_arc;
 		bool	_autoFree;
+		mutable std::atomic<uint32>	_hits;   //!< Lookups which found the file in this archive
+		mutable std::atomic<uint32>	_misses; //!< Lookups which had to check this archive without finding the file
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree), _hits(0), _misses(0) {
+		}
+		Node(const Node &node)
+			: _priority(node._priority), _name(node._name), _arc(node._arc), _autoFree(node._autoFree), _hits(node._hits.load()), _misses(node._misses.load()) {
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
@@ -347,9 +356,28 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/**
+	 * Maps the paths looked up so far to the archive they were found in,
+	 * or to nullptr if none of the archives contains them. Paths are
+	 * compared case-sensitively, since not every archive ignores case.
+	 */
+	typedef HashMap<Path, Archive *, Path::Hash, Path::EqualTo> LookupCache;
+	mutable LookupCache _fileLookups;   //!< Results of hasFile() and getMember()
+	mutable LookupCache _streamLookups; //!< Results of createReadStreamForMember()
+	mutable uint32 _lookupGeneration;
+	mutable std::atomic<uint32> _lookupHits;
+	mutable std::atomic<uint32> _lookupMisses;
+	Mutex *_lookupMutex;                //!< nullptr if the lookup cache is disabled
+
+	/** Increased whenever any search set changes, which invalidates all the lookup caches. */
+	static std::atomic<uint32> _generation;
+
+	bool getCachedLookup(LookupCache &cache, const Path &path, Archive *&archive) const;
+	void setCachedLookup(LookupCache &cache, const Path &path, Archive *archive) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
-	virtual ~SearchSet() { clear(); }
+	SearchSet() : _ignoreClashes(false), _lookupGeneration(0), _lookupHits(0), _lookupMisses(0), _lookupMutex(nullptr) { }
+	virtual ~SearchSet();
 
 	char getPathSeparator() const override { return '/'; }
 
@@ -476,6 +504,39 @@ public:
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
 
+	/**
+	 * Remember in which archive each file was found, and which files were
+	 * not found at all, so that repeated lookups do not have to ask every
+	 * archive again. This assumes that the contents of the archives do not
+	 * change, see invalidateLookupCaches().
+	 *
+	 * This applies to hasFile(), getMember() and createReadStreamForMember().
+	 * The cache is disabled by default. Since it uses a mutex, it can only
+	 * be enabled once the backend exists.
+	 */
+	void setLookupCache(bool enable);
+
+	/**
+	 * Discard the cached lookups of all search sets. Adding, removing or
+	 * reordering archives does this automatically, but this must be called
+	 * when the contents of an archive in a search set change.
+	 */
+	static void invalidateLookupCaches() { _generation++; }
+
+	struct ArchiveLookupStats {
+		String name;
+		int priority;
+		uint32 hits;   //!< Lookups which found the file in this archive
+		uint32 misses; //!< Lookups which had to check this archive without finding the file
+	};
+
+	/**
+	 * Get the number of lookups answered by the lookup cache, the number of
+	 * lookups which had to search the archives, and how the latter went for
+	 * each archive, in the order they are searched.
+	 */
+	void getLookupStats(uint32 &cacheHits, uint32 &cacheMisses, Array<ArchiveLookupStats> &archives) const;
+
 	bool getChildren(const Common::Path &path, Common::Array<Common::String> &list, ListMode mode = kListDirectoriesOnly, bool hidden = true) const override;
 };
 
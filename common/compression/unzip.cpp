@@ -95,6 +95,7 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -232,6 +233,19 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
 		, const Common::CRC32& crc
 #endif
 		);
+/*
+  A stored file used in place, which keeps the data of the zipfile alive
+  after the archive is closed.
+*/
+class ZipStoredFileStream : public Common::MemoryReadStream {
+public:
+	ZipStoredFileStream(const Common::SharedPtr<Common::SeekableReadStream> &zipStream, const byte *data, uint32 size) :
+		Common::MemoryReadStream(data, size), _zipStream(zipStream) {}
+
+private:
+	Common::SharedPtr<Common::SeekableReadStream> _zipStream;
+};
+
 /*
   Open for reading data the current file in the zipfile.
   If there is no error, the return value is UNZ_OK.
@@ -325,6 +339,7 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owner of _stream, shared with stored files used in place */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +474,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -489,7 +505,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_ERRNO;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -516,7 +531,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -606,7 +620,6 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -988,32 +1001,43 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	}
 
 	uint32 crc32_wait = s->cur_file_info.crc;
+	uint32 dataOffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+	// Stored files can be used in place when the archive is held in memory
+	const byte *storedBuffer = nullptr;
+	if (s->cur_file_info.compression_method == 0 && s->cur_file_info.compressed_size == s->cur_file_info.uncompressed_size)
+		storedBuffer = s->_stream->getRange(dataOffset, s->cur_file_info.uncompressed_size);
 
-	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
-	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
 	byte *uncompressedBuffer = nullptr;
 
-	switch (s->cur_file_info.compression_method) {
-	case 0: // Store
-		uncompressedBuffer = compressedBuffer;
-		break;
-	case Z_DEFLATED:
-		uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
-		assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
-		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
-		delete[] compressedBuffer;
-		compressedBuffer = nullptr;
-		break;
-	default:
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
-		delete[] compressedBuffer;
-		return Common::SharedArchiveContents();
+	if (!storedBuffer) {
+		byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
+		s->_stream->seek(dataOffset);
+		s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
+
+		switch (s->cur_file_info.compression_method) {
+		case 0: // Store
+			uncompressedBuffer = compressedBuffer;
+			break;
+		case Z_DEFLATED:
+			uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
+			assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
+			Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
+			delete[] compressedBuffer;
+			compressedBuffer = nullptr;
+			break;
+		default:
+			warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+			delete[] compressedBuffer;
+			return Common::SharedArchiveContents();
+		}
 	}
+
+	const byte *data = storedBuffer ? storedBuffer : uncompressedBuffer;
 #ifndef USE_ZLIB
-	uint32 crc32_data = crc.crcFast(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc.crcFast(data, s->cur_file_info.uncompressed_size);
 #else
-	uint32 crc32_data = crc32(0, uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc32(0, data, s->cur_file_info.uncompressed_size);
 #endif
 	if (crc32_data != crc32_wait) {
 		delete[] uncompressedBuffer;
@@ -1021,6 +1045,9 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 		return Common::SharedArchiveContents();
 	}
 
+	if (storedBuffer)
+		return Common::SharedArchiveContents::bypass(new ZipStoredFileStream(s->_streamRef, storedBuffer, s->cur_file_info.uncompressed_size));
+
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
@@ -0,0 +1,586 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> has the same API as HashMap<Key,Val>, but stores its
+ * entries directly in the table instead of allocating a node for each of
+ * them.
+ *
+ * Next to the table, a separate array holds one control byte per slot,
+ * which tells whether the slot is empty, deleted, or holds an entry. In the
+ * latter case, it also holds 7 bits of the hash of the key. Lookups use
+ * linear probing over these bytes, and only compare keys when the hash bits
+ * match, so they rarely touch memory other than the control bytes and the
+ * entry they are looking for. Inserting only allocates memory when the
+ * table has to grow.
+ *
+ * Unlike with HashMap, inserting an entry may move the other entries,
+ * so references to values and iterators are invalidated by it.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node() : _value(), _key() {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The load factor, including deleted entries, is kept below the
+		// quotient of these two constants
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	enum : byte {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+		// Entries store the lower 7 bits of their hash, i.e. 0x00 to 0x7F
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;     ///< Control byte of each slot
+	Node *_slots;    ///< Uninitialized storage, only slots holding an entry are constructed
+	size_type _mask; ///< Capacity of the table minus one, the capacity is a power of two
+	size_type _size;
+	size_type _deleted;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Scramble the hash, since many hash functions (e.g. for integers)
+	 * return values which are only distinct in their lower bits.
+	 */
+	static size_type mixHash(size_type hash) {
+		return (size_type)(hash * 0x9E3779B1U) ^ (hash >> 15);
+	}
+
+	static byte ctrlForHash(size_type hash) { return hash & 0x7F; }
+	static bool isFull(byte ctrl) { return (ctrl & 0x80) == 0; }
+
+	void allocStorage(size_type capacity) {
+		_mask = capacity - 1;
+		_ctrl = new byte[capacity];
+		memset(_ctrl, kCtrlEmpty, capacity);
+		_slots = (Node *)malloc(capacity * sizeof(Node));
+		assert(_slots != nullptr);
+		_size = 0;
+		_deleted = 0;
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_slots[ctr].~Node();
+		}
+		delete[] _ctrl;
+		free(_slots);
+	}
+
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void expandStorage(size_type newCapacity);
+	void eraseSlot(size_type ctr);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		freeStorage();
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (isFull(_ctrl[ctr]))
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (isFull(_ctrl[ctr]))
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Keep the same layout, so that no rehashing is needed
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new (&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			_slots[ctr].~Node();
+	}
+	memset(_ctrl, kCtrlEmpty, _mask + 1);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	const size_type oldMask = _mask;
+	byte *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+#ifndef RELEASE_BUILD
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+
+	// Move all the old entries over. Since no key exists twice in the old
+	// table, there is no need to compare keys.
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isFull(oldCtrl[ctr]))
+			continue;
+
+		const size_type hash = mixHash(_hash(oldSlots[ctr]._key));
+		size_type idx = hash & _mask;
+		while (_ctrl[idx] != kCtrlEmpty)
+			idx = (idx + 1) & _mask;
+
+		_ctrl[idx] = ctrlForHash(hash >> 25);
+		new (&_slots[idx]) Node(Common::move(oldSlots[ctr]));
+		oldSlots[ctr].~Node();
+		_size++;
+	}
+
+#ifndef RELEASE_BUILD
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+#endif
+
+	delete[] oldCtrl;
+	free(oldSlots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = mixHash(_hash(key));
+	const byte ctrl = ctrlForHash(hash >> 25);
+	size_type ctr = hash & _mask;
+
+	// There is always at least one empty slot, which ends the search
+	for (;; ctr = (ctr + 1) & _mask) {
+		const byte c = _ctrl[ctr];
+		if (c == kCtrlEmpty)
+			break;
+		if (c == ctrl && _equal(_slots[ctr]._key, key))
+			break;
+	}
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = mixHash(_hash(key));
+	const byte ctrl = ctrlForHash(hash >> 25);
+	size_type ctr = hash & _mask;
+	const size_type NONE_FOUND = _mask + 1;
+	size_type firstFree = NONE_FOUND;
+
+	for (;; ctr = (ctr + 1) & _mask) {
+		const byte c = _ctrl[ctr];
+		if (c == kCtrlEmpty)
+			break;
+		if (c == kCtrlDeleted) {
+			if (firstFree == NONE_FOUND)
+				firstFree = ctr;
+		} else if (c == ctrl && _equal(_slots[ctr]._key, key)) {
+			return ctr;
+		}
+	}
+
+	// Reuse the first deleted slot on the way, if any
+	if (firstFree != NONE_FOUND) {
+		ctr = firstFree;
+		_deleted--;
+	} else if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > (_mask + 1) * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Keep the load factor below a certain threshold. If many of the
+		// used slots are deleted ones, rehashing at the same size is enough.
+		size_type capacity = _mask + 1;
+		if (_size * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+
+		ctr = hash & _mask;
+		while (_ctrl[ctr] != kCtrlEmpty)
+			ctr = (ctr + 1) & _mask;
+	}
+
+	_ctrl[ctr] = ctrl;
+	new (&_slots[ctr]) Node(key);
+	_size++;
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	_slots[ctr].~Node();
+	_size--;
+
+	// If the next slot is empty, no search can continue past this one, so
+	// it can become empty as well, along with deleted slots before it
+	if (_ctrl[(ctr + 1) & _mask] == kCtrlEmpty) {
+		_ctrl[ctr] = kCtrlEmpty;
+		for (ctr = (ctr - 1) & _mask; _ctrl[ctr] == kCtrlDeleted; ctr = (ctr - 1) & _mask) {
+			_ctrl[ctr] = kCtrlEmpty;
+			_deleted--;
+		}
+	} else {
+		_ctrl[ctr] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return isFull(_ctrl[lookup(key)]);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate the storage, so it must happen before _slots is read
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr])) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
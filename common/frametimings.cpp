@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/frametimings.h"
+#include "common/algorithm.h"
+#include "common/stream.h"
+#include "common/str.h"
+
+namespace Common {
+
+FrameTimings::FrameTimings(uint numFrames) : _next(0), _count(0), _lastUpdateEnd(0) {
+	_frames.resize(MAX<uint>(numFrames, 1));
+	memset(&_current, 0, sizeof(_current));
+}
+
+void FrameTimings::addTime(Stage stage, uint32 micros) {
+	_current.times[stage] += micros;
+}
+
+void FrameTimings::endFrame(uint64 updateStart, uint64 updateEnd) {
+	const uint32 update = (uint32)(updateEnd - updateStart);
+	_current.times[kStagePresent] = update > _current.times[kStageConvert] ? update - _current.times[kStageConvert] : 0;
+
+	// The first frame has no previous update to measure from
+	if (_lastUpdateEnd != 0 && updateStart > _lastUpdateEnd) {
+		const uint32 elapsed = (uint32)(updateStart - _lastUpdateEnd);
+		_current.times[kStageEngine] = elapsed > _current.times[kStageSleep] ? elapsed - _current.times[kStageSleep] : 0;
+	} else {
+		_current.times[kStageEngine] = 0;
+	}
+	_lastUpdateEnd = updateEnd;
+
+	_frames[_next] = _current;
+	_next = (_next + 1) % _frames.size();
+	if (_count < _frames.size())
+		_count++;
+	memset(&_current, 0, sizeof(_current));
+}
+
+void FrameTimings::clear() {
+	_next = 0;
+	_count = 0;
+	_lastUpdateEnd = 0;
+	memset(&_current, 0, sizeof(_current));
+}
+
+const FrameTimings::Frame &FrameTimings::getFrame(uint index) const {
+	assert(index < _count);
+	return _frames[(_next + _frames.size() - _count + index) % _frames.size()];
+}
+
+uint32 FrameTimings::getPercentile(Stage stage, uint percent) const {
+	if (_count == 0)
+		return 0;
+
+	Array<uint32> times;
+	times.reserve(_count);
+	for (uint i = 0; i < _count; i++)
+		times.push_back(getFrame(i).times[stage]);
+	sort(times.begin(), times.end());
+
+	// Nearest rank
+	uint rank = (MIN<uint>(percent, 100) * _count + 99) / 100;
+	return times[rank > 0 ? rank - 1 : 0];
+}
+
+void FrameTimings::writeCSV(WriteStream &stream) const {
+	stream.writeString("frame");
+	for (int stage = 0; stage < kStageCount; stage++)
+		stream.writeString(String::format(",%s_us", getStageName((Stage)stage)));
+	stream.writeByte('\n');
+
+	for (uint i = 0; i < _count; i++) {
+		const Frame &frame = getFrame(i);
+		stream.writeString(String::format("%u", i));
+		for (int stage = 0; stage < kStageCount; stage++)
+			stream.writeString(String::format(",%u", frame.times[stage]));
+		stream.writeByte('\n');
+	}
+}
+
+const char *FrameTimings::getStageName(Stage stage) {
+	switch (stage) {
+	case kStageEngine:
+		return "engine";
+	case kStageConvert:
+		return "convert";
+	case kStagePresent:
+		return "present";
+	case kStageSleep:
+		return "sleep";
+	default:
+		return "unknown";
+	}
+}
+
+} // End of namespace Common
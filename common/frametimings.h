@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_FRAMETIMINGS_H
+#define COMMON_FRAMETIMINGS_H
+
+#include "common/array.h"
+#include "common/scummsys.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * @defgroup common_frametimings Frame timings
+ * @ingroup common
+ *
+ * @brief Records where the time of each frame is spent.
+ * @{
+ */
+
+/**
+ * Ring buffer of the durations of the stages of the last frames, for finding
+ * the cause of stutter. The backend marks the end of each frame when the
+ * screen is updated, the graphics managers and frame limiters add the time
+ * spent converting the screen and sleeping, and the engine time is what is
+ * left between two screen updates.
+ *
+ * All the durations are in microseconds.
+ */
+class FrameTimings {
+public:
+	enum Stage {
+		kStageEngine,  ///< Time between two screen updates, without sleeping
+		kStageConvert, ///< Scaling, converting and uploading the screen
+		kStagePresent, ///< Rest of the screen update, including waiting for vsync
+		kStageSleep,   ///< Time spent sleeping in frame limiters
+		kStageCount
+	};
+
+	struct Frame {
+		uint32 times[kStageCount];
+	};
+
+	FrameTimings(uint numFrames = 1024);
+
+	/** Add time spent in a stage to the current frame. */
+	void addTime(Stage stage, uint32 micros);
+
+	/**
+	 * End the current frame, with the times at which the screen update
+	 * started and finished.
+	 */
+	void endFrame(uint64 updateStart, uint64 updateEnd);
+
+	/** Forget all the recorded frames. */
+	void clear();
+
+	/** Return the number of recorded frames. */
+	uint size() const { return _count; }
+
+	/** Return a recorded frame, the oldest one being 0. */
+	const Frame &getFrame(uint index) const;
+
+	/**
+	 * Return the duration of a stage that the given percentage of the
+	 * recorded frames do not exceed.
+	 */
+	uint32 getPercentile(Stage stage, uint percent) const;
+
+	/** Write the recorded frames as CSV, oldest first. */
+	void writeCSV(WriteStream &stream) const;
+
+	static const char *getStageName(Stage stage);
+
+private:
+	Array<Frame> _frames;
+	uint _next;
+	uint _count;
+
+	Frame _current;
+	uint64 _lastUpdateEnd;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
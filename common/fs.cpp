@@ -52,7 +52,7 @@ FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNo
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStream() const {
-	return _fsNode.createReadStream();
+	return _fsNode.createDataReadStream();
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStreamForAltStream(AltStreamType altStreamType) const {
@@ -233,6 +233,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStats(int64 &size, int64 &mtime) const {
+	return _realNode && _realNode->getFileStats(size, mtime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -248,6 +252,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createDataReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createDataReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createDataReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createDataReadStream();
+}
+
 SeekableReadStream *FSNode::createReadStreamForAltStream(AltStreamType altStreamType) const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -383,7 +402,7 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 
 	debug(5, "FSDirectory::createReadStreamForMember('%s') -> '%s'", path.toString(Common::Path::kNativeSeparator).c_str(), node->getPath().toString(Common::Path::kNativeSeparator).c_str());
 
-	SeekableReadStream *stream = node->createReadStream();
+	SeekableReadStream *stream = node->createDataReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", Common::toPrintable(path.toString(Common::Path::kNativeSeparator)).c_str());
 
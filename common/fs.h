@@ -252,6 +252,16 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the last modification time of the file referred
+	 * by this node, without opening it. The modification time is only meant
+	 * to be compared with earlier values for the same file.
+	 *
+	 * @return True if successful, false if the backend does not support this
+	 *         or the file cannot be accessed.
+	 */
+	bool getFileStats(int64 &size, int64 &mtime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +271,16 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance for game data, which nothing
+	 * writes to while it is read. The backend may read it in a faster way,
+	 * e.g. by mapping the file into memory. Files which may change, such as
+	 * savefiles, must use createReadStream() instead.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createDataReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
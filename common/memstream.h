@@ -93,6 +93,12 @@ public:
 	int64 size() const { return _size; }
 
 	bool seek(int64 offs, int whence = SEEK_SET);
+
+	const byte *getRange(int64 offset, uint32 dataSize) const {
+		if (offset < 0 || offset > _size || dataSize > _size - offset)
+			return nullptr;
+		return _ptrOrig.get() + offset;
+	}
 };
 
 
@@ -13,6 +13,7 @@ MODULE_OBJS := \
 	error.o \
 	events.o \
 	file.o \
+	frametimings.o \
 	fs.o \
 	gui_options.o \
 	hashmap.o \
@@ -41,6 +42,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	thread.o \
 	tokenizer.o \
 	translation.o \
 	unicode-bidi.o \
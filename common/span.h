@@ -24,6 +24,7 @@
 
 #include "common/file.h"
 #include "common/memstream.h"
+#include "common/noncopyable.h"
 #include "common/safe-bool.h"
 #include "common/scummsys.h"
 #include "common/type_traits.h"
@@ -995,6 +996,80 @@ public:
 	inline reference operator[](const index_type index) { return _span[index]; }
 };
 
+#pragma mark -
+#pragma mark StreamSpan
+
+/**
+ * A read-only Span of data read from a stream.
+ *
+ * If the stream holds its data in memory (see SeekableReadStream::getRange),
+ * the data is borrowed from the stream without copying it, and stays valid
+ * for as long as the stream exists. Otherwise, the data is read into a
+ * buffer owned by the StreamSpan, which is reused by subsequent reads.
+ */
+class StreamSpan : NonCopyable {
+public:
+	typedef Span<const byte> span_type;
+	typedef span_type::size_type size_type;
+	typedef span_type::index_type index_type;
+
+	inline StreamSpan() : _span(), _buffer(nullptr), _bufferSize(0) {}
+
+	inline ~StreamSpan() {
+		delete[] _buffer;
+	}
+
+	/**
+	 * Fills the span with the next @p numBytes bytes of the stream (or the
+	 * rest of the stream), and moves the stream position past them.
+	 *
+	 * @return false if the stream ended before all the data could be read.
+	 */
+	bool readFromStream(SeekableReadStream &stream, size_type numBytes = kSpanMaxSize) {
+		const int64 pos = stream.pos();
+		if (numBytes == kSpanMaxSize) {
+			const int64 remaining = stream.size() - pos;
+			numBytes = remaining > 0 ? remaining : 0;
+		}
+
+		const byte *data = stream.getRange(pos, numBytes);
+		if (data && stream.skip(numBytes)) {
+			_span = span_type(data, numBytes);
+			return true;
+		}
+
+		if (numBytes > _bufferSize) {
+			delete[] _buffer;
+			_buffer = new byte[numBytes];
+			_bufferSize = numBytes;
+		}
+
+		const uint32 bytesRead = stream.read(_buffer, numBytes);
+		_span = span_type(_buffer, bytesRead);
+		return bytesRead == numBytes;
+	}
+
+	/**
+	 * Returns whether the data is borrowed from the stream rather than
+	 * owned by this StreamSpan.
+	 */
+	inline bool isBorrowed() const { return _span.data() && _span.data() != _buffer; }
+
+	/**
+	 * Empties the span. The buffer is kept for subsequent reads.
+	 */
+	inline void clear() { _span.clear(); }
+
+	inline const span_type &operator*() const { return _span; }
+	inline const span_type *operator->() const { return &_span; }
+	inline const byte &operator[](const index_type index) const { return _span[index]; }
+
+private:
+	span_type _span;
+	byte *_buffer;
+	size_type _bufferSize;
+};
+
 } // End of namespace Common
 
 #endif
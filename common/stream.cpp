@@ -292,6 +292,13 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getRange(int64 offset, uint32 dataSize) const {
+	if (offset < 0 || offset > size() || dataSize > size() - offset)
+		return nullptr;
+
+	return _parentStream->getRange(_begin + offset, dataSize);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
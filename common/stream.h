@@ -792,6 +792,22 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Obtain a pointer to a range of the stream data without copying it.
+	 *
+	 * This is only supported by streams whose whole data is directly
+	 * accessible in memory, such as MemoryReadStream or memory-mapped
+	 * files. The returned pointer stays valid for as long as the stream
+	 * exists. The stream position indicator is not affected.
+	 *
+	 * @param offset	Offset in bytes from the start of the stream.
+	 * @param dataSize	Size of the range in bytes.
+	 *
+	 * @return A pointer to the data, or nullptr if the stream does not
+	 *         support this or the range is out of bounds.
+	 */
+	virtual const byte *getRange(int64 offset, uint32 dataSize) const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
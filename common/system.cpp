@@ -25,6 +25,7 @@
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/file.h"
+#include "common/frametimings.h"
 #include "common/printman.h"
 #include "common/savefile.h"
 #include "common/str.h"
@@ -61,6 +62,7 @@ OSystem::OSystem() {
 #endif
 	_fsFactory = nullptr;
 	_dlcStore = nullptr;
+	_frameTimings = nullptr;
 	_backendInitialized = false;
 }
 
@@ -103,6 +105,9 @@ OSystem::~OSystem() {
 
 	delete _dlcStore;
 	_dlcStore = nullptr;
+
+	delete _frameTimings;
+	_frameTimings = nullptr;
 }
 
 void OSystem::initBackend() {
@@ -279,6 +284,19 @@ bool OSystem::isConnectionLimited() {
 	return false;
 }
 
+uint64 OSystem::getMicros() {
+	return (uint64)getMillis(true) * 1000;
+}
+
+void OSystem::setFrameTimingsEnabled(bool enable) {
+	if (enable && !_frameTimings) {
+		_frameTimings = new Common::FrameTimings();
+	} else if (!enable) {
+		delete _frameTimings;
+		_frameTimings = nullptr;
+	}
+}
+
 Common::TimerManager *OSystem::getTimerManager() {
 	return _timerManager;
 }
@@ -56,7 +56,10 @@ class Store;
 
 namespace Common {
 class EventManager;
+class FrameTimings;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -279,6 +282,14 @@ protected:
 	 */
 	DLC::Store *_dlcStore;
 
+	/**
+	 * Timings of the last frames, only allocated while they are being
+	 * recorded. Backends add the end of each frame in updateScreen().
+	 *
+	 * @note _frameTimings is deleted by the OSystem destructor.
+	 */
+	Common::FrameTimings *_frameTimings;
+
 	/**
 	 * Used by the default clipboard implementation, for backends that don't
 	 * implement clipboard support.
@@ -1576,6 +1587,29 @@ public:
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
+	/**
+	 * Get a time in microseconds, for measuring short durations.
+	 *
+	 * The value is not recorded by the event recorder. The default
+	 * implementation only has the precision of getMillis().
+	 */
+	virtual uint64 getMicros();
+
+	/**
+	 * Start or stop recording the timings of each frame. Stopping
+	 * discards the frames recorded so far.
+	 */
+	void setFrameTimingsEnabled(bool enable);
+
+	/**
+	 * Return the timings of the last frames, or nullptr if they are not
+	 * being recorded.
+	 *
+	 * Code which waits between frames should add the time it sleeps with
+	 * Common::FrameTimings::kStageSleep.
+	 */
+	Common::FrameTimings *getFrameTimings() { return _frameTimings; }
+
 	/**
 	 * Get the current time and date, in the local timezone.
 	 *
@@ -1658,6 +1692,42 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create a new thread running the given procedure.
+	 *
+	 * Unlike mutexes, threads are optional. Code which uses them has to
+	 * handle this method returning nullptr by doing the work itself, and
+	 * backends do not have to implement it.
+	 *
+	 * @param proc Procedure to run on the new thread.
+	 * @param data Parameter passed to the procedure.
+	 * @param name Name of the thread, for debugging purposes.
+	 *
+	 * @return The newly created thread, or nullptr if threads are not
+	 *         supported or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *data), void *data, const char *name) { return nullptr; }
+
+	/**
+	 * Create a new semaphore.
+	 *
+	 * Backends which implement createThread() must implement this as well.
+	 *
+	 * @param initialValue The initial value of the semaphore.
+	 *
+	 * @return The newly created semaphore, or nullptr if threads are not
+	 *         supported or an error occurred.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue) { return nullptr; }
+
+	/**
+	 * Return the number of processor cores available for running threads.
+	 *
+	 * @return The number of cores, or 1 if threads are not supported or
+	 *         the number is not known.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
 	/** @} */
 
 
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/thread.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Common {
+
+Thread::Thread() : _thread(nullptr) {
+}
+
+Thread::~Thread() {
+	join();
+}
+
+bool Thread::start(ThreadProc proc, void *data, const char *name) {
+	assert(g_system);
+	assert(!_thread);
+	_thread = g_system->createThread(proc, data, name);
+	return _thread != nullptr;
+}
+
+void Thread::join() {
+	if (!_thread)
+		return;
+
+	_thread->join();
+	delete _thread;
+	_thread = nullptr;
+}
+
+void Thread::detach() {
+	delete _thread;
+	_thread = nullptr;
+}
+
+
+#pragma mark -
+
+
+Semaphore::Semaphore(uint initialValue) {
+	assert(g_system);
+	_semaphore = g_system->createSemaphore(initialValue);
+}
+
+Semaphore::~Semaphore() {
+	delete _semaphore;
+}
+
+void Semaphore::post() {
+	if (_semaphore)
+		_semaphore->post();
+}
+
+void Semaphore::wait() {
+	if (_semaphore)
+		_semaphore->wait();
+}
+
+
+#pragma mark -
+
+
+ThreadPool::ThreadPool(uint numThreads, const char *name) : _workers(nullptr), _numWorkers(0), _quit(false),
+		_next(0), _count(0), _proc(nullptr), _data(nullptr) {
+	assert(g_system);
+	if (numThreads == 0)
+		numThreads = g_system->getCPUCount();
+	if (numThreads <= 1)
+		return;
+
+	_workers = new Thread[numThreads - 1];
+	while (_numWorkers < numThreads - 1 && _workers[_numWorkers].start(workerProc, this, name))
+		_numWorkers++;
+}
+
+ThreadPool::~ThreadPool() {
+	_quit = true;
+	for (uint i = 0; i < _numWorkers; i++)
+		_wake.post();
+	delete[] _workers;
+}
+
+void ThreadPool::run(uint count, TaskProc proc, void *data) {
+	_proc = proc;
+	_data = data;
+	_count = count;
+	_next = 0;
+
+	// Every worker signals _done once it runs out of tasks. A worker might
+	// be woken up more than once while another one keeps sleeping, but the
+	// number of signals stays the same.
+	const uint numWorkers = MIN(_numWorkers, count > 0 ? count - 1 : 0);
+	for (uint i = 0; i < numWorkers; i++)
+		_wake.post();
+
+	runTasks();
+
+	for (uint i = 0; i < numWorkers; i++)
+		_done.wait();
+}
+
+void ThreadPool::runTasks() {
+	for (uint index = _next++; index < _count; index = _next++)
+		_proc(_data, index);
+}
+
+void ThreadPool::workerProc(void *data) {
+	ThreadPool *pool = (ThreadPool *)data;
+	for (;;) {
+		pool->_wake.wait();
+		if (pool->_quit)
+			return;
+
+		pool->runTasks();
+		pool->_done.post();
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+#include "common/system.h"
+
+#include <atomic>
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief API for optional worker threads.
+ *
+ * Threads are not available on every backend. Code using them must check
+ * whether Thread::start() succeeded and fall back to doing the work on the
+ * calling thread otherwise.
+ * @{
+ */
+
+typedef void (*ThreadProc)(void *data);
+
+class ThreadInternal {
+public:
+	/**
+	 * Destroying a thread which has not been joined detaches it.
+	 */
+	virtual ~ThreadInternal() {}
+
+	/**
+	 * Wait until the thread procedure has returned.
+	 */
+	virtual void join() = 0;
+};
+
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	virtual void post() = 0;
+	virtual void wait() = 0;
+};
+
+/**
+ * Wrapper class around the OSystem thread functions.
+ */
+class Thread : NonCopyable {
+	ThreadInternal *_thread;
+
+public:
+	Thread();
+	/** Joins the thread if it is still running. */
+	~Thread();
+
+	/**
+	 * Start a new thread.
+	 *
+	 * @param proc Procedure to run on the new thread.
+	 * @param data Parameter passed to the procedure.
+	 * @param name Name of the thread, for debugging purposes.
+	 * @return True if the thread was started, false if threads are not
+	 *         supported by the backend or an error occurred.
+	 */
+	bool start(ThreadProc proc, void *data, const char *name);
+
+	/**
+	 * Wait until the thread procedure has returned.
+	 */
+	void join();
+
+	/**
+	 * Let the thread finish on its own, without waiting for it.
+	 */
+	void detach();
+
+	bool isRunning() const { return _thread != nullptr; }
+};
+
+/**
+ * Wrapper class around the OSystem semaphore functions.
+ *
+ * If the backend does not support threads, there is nobody to wait for
+ * and all operations do nothing.
+ */
+class Semaphore : NonCopyable {
+	SemaphoreInternal *_semaphore;
+
+public:
+	explicit Semaphore(uint initialValue = 0);
+	~Semaphore();
+
+	/** Increment the semaphore, waking up a waiting thread. */
+	void post();
+	/** Wait until the semaphore is non-zero, then decrement it. */
+	void wait();
+};
+
+/**
+ * A fixed set of worker threads for splitting work into independent tasks.
+ *
+ * If the backend does not support threads, all tasks are run on the
+ * calling thread.
+ */
+class ThreadPool : NonCopyable {
+public:
+	typedef void (*TaskProc)(void *data, uint index);
+
+	/**
+	 * Create the pool and start its worker threads.
+	 *
+	 * @param numThreads Number of threads running the tasks, including the
+	 *                   calling thread. If 0, the number of CPU cores is used.
+	 * @param name       Name of the worker threads, for debugging purposes.
+	 */
+	explicit ThreadPool(uint numThreads = 0, const char *name = "ScummVM worker");
+	/** Stops and joins the worker threads. */
+	~ThreadPool();
+
+	/** Return the number of threads running tasks, including the calling thread. */
+	uint getNumThreads() const { return _numWorkers + 1; }
+
+	/**
+	 * Call proc(data, index) for each index from 0 to count - 1, spread
+	 * over the worker threads and the calling thread. Returns once all of
+	 * the calls have returned. The order of the calls is undefined.
+	 */
+	void run(uint count, TaskProc proc, void *data);
+
+private:
+	static void workerProc(void *data);
+	void runTasks();
+
+	Thread *_workers;
+	uint _numWorkers;
+	Semaphore _wake;
+	Semaphore _done;
+	bool _quit;
+
+	std::atomic<uint> _next;
+	uint _count;
+	TaskProc _proc;
+	void *_data;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -429,6 +429,7 @@ Common::Error AdvancedMetaEngineDetectionBase::identifyGame(DetectedGame &game,
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.flushFileCache();
 
 	if (!agdDesc.desc)
 		return Common::kNoGameDataFoundError;
@@ -490,6 +491,169 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define DETECTION_CACHE_HEADER "# ScummVM detection cache v2"
+
+// Tabs and line breaks separate the fields and the entries of the cache
+static Common::String escapeCacheField(const Common::String &field) {
+	Common::String ret;
+	for (uint i = 0; i < field.size(); i++) {
+		switch (field[i]) {
+		case '\\':
+			ret += "\\\\";
+			break;
+		case '\t':
+			ret += "\\t";
+			break;
+		case '\n':
+			ret += "\\n";
+			break;
+		case '\r':
+			ret += "\\r";
+			break;
+		default:
+			ret += field[i];
+		}
+	}
+	return ret;
+}
+
+static Common::String unescapeCacheField(const Common::String &field) {
+	Common::String ret;
+	for (uint i = 0; i < field.size(); i++) {
+		if (field[i] != '\\' || i + 1 == field.size()) {
+			ret += field[i];
+			continue;
+		}
+
+		switch (field[++i]) {
+		case 't':
+			ret += '\t';
+			break;
+		case 'n':
+			ret += '\n';
+			break;
+		case 'r':
+			ret += '\r';
+			break;
+		default:
+			ret += field[i];
+		}
+	}
+	return ret;
+}
+
+Common::Path AdvancedDetectorCacheManager::getFileCachePath() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+	return configFile.getParent().appendComponent("detection-cache.txt");
+}
+
+void AdvancedDetectorCacheManager::loadFileCache() {
+	_fileCacheLoaded = true;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(Common::FSNode(getFileCachePath()).createReadStream());
+	if (!stream || stream->readLine() != DETECTION_CACHE_HEADER)
+		return;
+
+	// Each line holds the MD5 properties, the path, the size and the
+	// modification time of the file, then the size of the hashed data and
+	// its MD5, separated by tabs. The path is escaped.
+	uint pruned = 0;
+	while (!stream->eos() && !stream->err()) {
+		Common::String line = stream->readLine();
+		Common::StringTokenizer tok(line, "\t");
+
+		Common::String key = tok.nextToken();
+		FileCacheEntry entry;
+		entry.path = Common::Path::fromConfig(unescapeCacheField(tok.nextToken()));
+		entry.fileSize = (int64)tok.nextToken().asUint64();
+		entry.mtime = (int64)tok.nextToken().asUint64();
+		entry.size = (int64)tok.nextToken().asUint64();
+		entry.md5 = tok.nextToken();
+
+		if (key.empty() || entry.path.empty() || entry.md5.empty())
+			continue;
+
+		// Forget the files which were removed since
+		if (!Common::FSNode(entry.path).exists()) {
+			pruned++;
+			continue;
+		}
+
+		_fileCache.setVal(key + ':' + entry.path.toConfig(), entry);
+	}
+
+	if (pruned)
+		_fileCacheDirty = true;
+
+	debugC(2, kDebugGlobalDetection, "Loaded %d entries from the detection cache, %d were removed", _fileCache.size(), pruned);
+}
+
+bool AdvancedDetectorCacheManager::getFileMD5(const Common::FSNode &node, const Common::String &key, Common::String &md5, int64 &size) {
+	if (!ConfMan.getBool("detection_cache"))
+		return false;
+	if (!_fileCacheLoaded)
+		loadFileCache();
+
+	int64 fileSize, mtime;
+	if (!node.getFileStats(fileSize, mtime))
+		return false;
+
+	FileCacheMap::const_iterator i = _fileCache.find(key + ':' + node.getPath().toConfig());
+	if (i == _fileCache.end() || i->_value.fileSize != fileSize || i->_value.mtime != mtime)
+		return false;
+
+	md5 = i->_value.md5;
+	size = i->_value.size;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setFileMD5(const Common::FSNode &node, const Common::String &key, const Common::String &md5, int64 size) {
+	if (!ConfMan.getBool("detection_cache"))
+		return;
+	if (!_fileCacheLoaded)
+		loadFileCache();
+
+	FileCacheEntry entry;
+	if (!node.getFileStats(entry.fileSize, entry.mtime))
+		return;
+	entry.key = key;
+	entry.path = node.getPath();
+	entry.size = size;
+	entry.md5 = md5;
+
+	_fileCache.setVal(key + ':' + node.getPath().toConfig(), entry);
+	_fileCacheDirty = true;
+}
+
+void AdvancedDetectorCacheManager::flushFileCache(bool force) {
+	if (!_fileCacheDirty)
+		return;
+
+	const uint32 time = g_system->getMillis();
+	if (!force && _fileCacheFlushTime != 0 && time - _fileCacheFlushTime < 5000)
+		return;
+
+	Common::ScopedPtr<Common::WriteStream> stream(Common::FSNode(getFileCachePath()).createWriteStream());
+	if (!stream) {
+		warning("Failed to write the detection cache to '%s'", getFileCachePath().toString(Common::Path::kNativeSeparator).c_str());
+		_fileCacheDirty = false;
+		return;
+	}
+
+	stream->writeString(DETECTION_CACHE_HEADER "\n");
+	for (const auto &entry : _fileCache) {
+		stream->writeString(Common::String::format("%s\t%s\t%llu\t%llu\t%llu\t%s\n", entry._value.key.c_str(),
+			escapeCacheField(entry._value.path.toConfig()).c_str(), (unsigned long long)entry._value.fileSize,
+			(unsigned long long)entry._value.mtime, (unsigned long long)entry._value.size, entry._value.md5.c_str()));
+	}
+	stream->finalize();
+
+	_fileCacheDirty = false;
+	_fileCacheFlushTime = time;
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -563,16 +727,114 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
+	// The MD5s of plain files are also kept in the persistent cache. Files
+	// in archives and Mac forks depend on more than a single file on disk.
+	const Common::FSNode *node = nullptr;
+	Common::String fileKey;
+	if (!(md5prop & (kMD5MacResFork | kMD5MacDataFork | kMD5Archive)) && allFiles.contains(fname)) {
+		node = &allFiles[fname];
+		fileKey = Common::String::format("%s:%d", md5PropToCachePrefix(md5prop).c_str(), _md5Bytes);
+
+		if (ADCacheMan.getFileMD5(*node, fileKey, fileProps.md5, fileProps.size)) {
+			fileProps.md5prop = (MD5Properties)(md5prop & kMD5Tail);
+			ADCacheMan.setMD5(hashname, fileProps.md5);
+			ADCacheMan.setSize(hashname, fileProps.size);
+			return true;
+		}
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+		if (node)
+			ADCacheMan.setFileMD5(*node, fileKey, fileProps.md5, fileProps.size);
 	}
 
 	return res;
 }
 
+namespace {
+
+/** A plain file whose MD5 is computed ahead of the detection. */
+class ADPrefetchFile : public DetectionPrefetchFile {
+public:
+	ADPrefetchFile(const Common::String &hashname, const Common::FSNode &node, const Common::String &fileKey, uint32 numBytes, bool atTail) :
+		DetectionPrefetchFile(hashname, numBytes, atTail), _node(node), _fileKey(fileKey) {
+	}
+
+	Common::SeekableReadStream *open() override {
+		return _node.createReadStream();
+	}
+
+	void store() override {
+		Common::String md5;
+		for (int i = 0; i < 16; i++)
+			md5 += Common::String::format("%02x", digest[i]);
+
+		ADCacheMan.setMD5(key, md5);
+		ADCacheMan.setSize(key, size);
+		ADCacheMan.setFileMD5(_node, _fileKey, md5, size);
+	}
+
+private:
+	Common::FSNode _node;
+	Common::String _fileKey;
+};
+
+} // End of anonymous namespace
+
+void AdvancedMetaEngineDetectionBase::prefetchDetection(const Common::FSList &fslist, DetectionPrefetchList &files) {
+	if (fslist.empty())
+		return;
+
+	preprocessDescriptions();
+
+	FileMap allFiles;
+	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+
+	// Only plain files are hashed ahead. Archives are shared through the
+	// cache manager and Mac forks may need more than one file, so both are
+	// left to the detection itself.
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+			if (md5prop & (kMD5MacResFork | kMD5MacDataFork | kMD5Archive))
+				continue;
+
+			Common::Path fname(fileDesc->fileName);
+			if (!allFiles.contains(fname))
+				continue;
+
+			Common::String hashname = md5PropToCachePrefix(md5prop);
+			hashname += ':';
+			hashname += fname.toString('/');
+			hashname += ':';
+			hashname += Common::String::format("%d", _md5Bytes);
+
+			if (ADCacheMan.containsMD5(hashname))
+				continue;
+
+			// Entries of the persistent cache go straight to the one of
+			// this detection run
+			const Common::FSNode &node = allFiles[fname];
+			Common::String fileKey = Common::String::format("%s:%d", md5PropToCachePrefix(md5prop).c_str(), _md5Bytes);
+			Common::String md5;
+			int64 size;
+			if (ADCacheMan.getFileMD5(node, fileKey, md5, size)) {
+				ADCacheMan.setMD5(hashname, md5);
+				ADCacheMan.setSize(hashname, size);
+				continue;
+			}
+
+			files.push_back(new ADPrefetchFile(hashname, node, fileKey, _md5Bytes, (md5prop & kMD5Tail) != 0));
+		}
+	}
+}
+
 bool AdvancedMetaEngineBase::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
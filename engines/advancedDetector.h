@@ -515,6 +515,12 @@ public:
 	 */
 	DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) override;
 
+	/**
+	 * Queue the plain files referenced by the detection entries whose MD5s
+	 * are not cached yet, so that detectGames() finds them in the cache.
+	 */
+	void prefetchDetection(const Common::FSList &fslist, DetectionPrefetchList &files) override;
+
 	uint getMD5Bytes() const override final { return _md5Bytes; }
 
 	int getGameVariantCount() const override final {
@@ -746,6 +752,12 @@ private:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * Besides the MD5s of the current detection run, which are keyed by the
+ * file names used in the detection tables, this also keeps a persistent
+ * cache of the MD5s of plain files, keyed by their full path. It is stored
+ * next to the configuration file, and its entries remain valid as long as
+ * the size and the modification time of the files do not change.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -786,7 +798,31 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up the MD5 of a file in the persistent cache.
+	 *
+	 * @param node  The file the MD5 was computed for.
+	 * @param key   The MD5 properties and amount of bytes hashed, as a string.
+	 * @param md5   Set to the cached MD5 if found.
+	 * @param size  Set to the cached size of the hashed data if found.
+	 *
+	 * @return True if the cache contains an up to date entry for the file.
+	 */
+	bool getFileMD5(const Common::FSNode &node, const Common::String &key, Common::String &md5, int64 &size);
+
+	/**
+	 * Store the MD5 of a file in the persistent cache.
+	 */
+	void setFileMD5(const Common::FSNode &node, const Common::String &key, const Common::String &md5, int64 size);
+
+	/**
+	 * Write the persistent cache to disk if it has changed. Unless @p force
+	 * is set, this is skipped when it was written a few seconds ago, so that
+	 * scanning many directories in a row does not rewrite it for each of them.
+	 */
+	void flushFileCache(bool force = false);
+
+	AdvancedDetectorCacheManager() : _fileCacheLoaded(false), _fileCacheDirty(false), _fileCacheFlushTime(0) {
 		clear();
 	}
 
@@ -812,6 +848,24 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	struct FileCacheEntry {
+		Common::String key;
+		Common::Path path;
+		int64 fileSize;
+		int64 mtime;
+		int64 size;
+		Common::String md5;
+	};
+	typedef Common::HashMap<Common::String, FileCacheEntry> FileCacheMap;
+
+	static Common::Path getFileCachePath();
+	void loadFileCache();
+
+	FileCacheMap _fileCache;
+	bool _fileCacheLoaded;
+	bool _fileCacheDirty;
+	uint32 _fileCacheFlushTime;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
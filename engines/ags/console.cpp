@@ -25,6 +25,7 @@
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/gfx/allegro_bitmap.h"
 #include "ags/shared/script/cc_common.h"
+#include "ags/engine/script/cc_instance.h"
 #include "graphics/palette.h"
 #include "image/png.h"
 
@@ -34,6 +35,7 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_debug_groups_list",   WRAP_METHOD(AGSConsole, Cmd_listDebugGroups));
 	registerCmd("ags_debug_groups_set",  WRAP_METHOD(AGSConsole, Cmd_setDebugGroupLevel));
 	registerCmd("ags_set_script_dump", WRAP_METHOD(AGSConsole, Cmd_SetScriptDump));
+	registerCmd("ags_script_profile", WRAP_METHOD(AGSConsole, Cmd_ScriptProfile));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
 
@@ -185,6 +187,35 @@ bool AGSConsole::Cmd_SetScriptDump(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_ScriptProfile(int argc, const char **argv) {
+	if (argc < 2 || argc > 3) {
+		debugPrintf("Usage: %s [on|off|reset|show [count]]\n", argv[0]);
+		debugPrintf("Profiling is %s\n", AGS3::ccGetScriptProfiling() ? "on" : "off");
+		return true;
+	}
+
+	if (strcmp(argv[1], "on") == 0) {
+		AGS3::ccSetScriptProfiling(true);
+	} else if (strcmp(argv[1], "off") == 0) {
+		AGS3::ccSetScriptProfiling(false);
+	} else if (strcmp(argv[1], "reset") == 0) {
+		AGS3::ccResetScriptProfile();
+	} else if (strcmp(argv[1], "show") == 0) {
+		const uint count = (argc == 3) ? atoi(argv[2]) : 20;
+		Std::vector<AGS3::ScriptFunctionProfile> profile;
+		AGS3::ccGetScriptProfile(profile);
+
+		debugPrintf("%10s %12s %10s  %s\n", "Time (ms)", "Instructions", "Calls", "Function");
+		for (uint i = 0; i < profile.size() && i < count; i++) {
+			debugPrintf("%10.3f %12llu %10u  %s\n", profile[i].TimeUs / 1000.0, (unsigned long long)profile[i].Instructions,
+			            profile[i].Calls, profile[i].Name.GetCStr());
+		}
+	} else {
+		debugPrintf("Unknown option '%s'\n", argv[1]);
+	}
+	return true;
+}
+
 bool AGSConsole::Cmd_getSpriteInfo(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Usage: %s SpriteNumber\n", argv[0]);
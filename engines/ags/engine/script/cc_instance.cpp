@@ -20,6 +20,7 @@
  */
 
 #include "common/debug-channels.h"
+#include "common/system.h"
 #include "ags/shared/ac/common.h"
 #include "ags/engine/ac/dynobj/cc_dynamic_array.h"
 #include "ags/engine/ac/dynobj/managed_object_pool.h"
@@ -542,6 +543,15 @@ inline bool FixupArgument(RuntimeScriptValue &arg, const int fixup, const uintpt
 	}
 }
 
+// Charges the time since the last switch to the profiled function, and
+// continues with the next one
+inline void SwitchFunctionProfile(ScriptFunctionProfile *&profile, uint64_t &profile_time, ScriptFunctionProfile *next) {
+	const uint64_t now = g_system->getMicros();
+	profile->TimeUs += now - profile_time;
+	profile_time = now;
+	profile = next;
+}
+
 #define MAXNEST 50  // number of recursive function calls allowed
 int ccInstance::Run(int32_t curpc) {
 	pc = curpc;
@@ -561,7 +571,22 @@ int ccInstance::Run(int32_t curpc) {
 	funcstart[0] = pc;
 	ccInstance *codeInst = runningInst;
 	ScriptOperation codeOp;
+	int arg_fixup = FIXUP_NOFIXUP; // fixup of the second argument left to apply
 	FunctionCallStack func_callstack;
+
+	if (!codeInst->decoded->Built)
+		codeInst->DecodeCode();
+	const uint32_t decoded_size = codeInst->decoded->Index.size();
+	const uint32_t *decoded_index = codeInst->decoded->Index.data();
+	const DecodedInstruction *decoded_instructions = codeInst->decoded->Instructions.data();
+
+	ScriptFunctionProfile *profile = nullptr;
+	uint64_t profile_time = 0;
+	if (_G(scriptProfiling)) {
+		profile = codeInst->GetFunctionProfile(pc);
+		profile->Calls++;
+		profile_time = g_system->getMicros();
+	}
 #if DEBUG_CC_EXEC
 	const bool dump_opcodes = (ccGetOption(SCOPT_DEBUGRUN) != 0) ||
 							  (gDebugLevel > 0 && DebugMan.isDebugChannelEnabled(::AGS::kDebugScript));
@@ -583,34 +608,68 @@ int ccInstance::Run(int32_t curpc) {
 		//
 		/* Read operation */
 		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+		const uint32_t decoded_at = (static_cast<uint32_t>(pc) < decoded_size) ? decoded_index[pc] : 0;
+		if (decoded_at) {
+			// Already checked and decoded, see DecodeCode()
+			const DecodedInstruction &inst = decoded_instructions[decoded_at - 1];
+			codeOp.Instruction = inst.Instruction;
+			codeOp.ArgCount = inst.ArgCount;
+			switch (inst.ArgCount) {
+			case 3:
+				codeOp.Args[2].SetInt32(inst.Args[2]);
+				/* fall-through */
+			case 2:
+				codeOp.Args[1].SetInt32(inst.Args[1]);
+				/* fall-through */
+			case 1:
+				codeOp.Args[0].SetInt32(inst.Args[0]);
+				break;
+			default:
+				break;
+			}
 
-		CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-							"invalid instruction %d found in code stream", codeOp.Instruction.Code);
+			arg_fixup = inst.Fixup;
+			if (inst.FixedArg) {
+				if (inst.Fixup == FIXUP_GLOBALDATA)
+					codeOp.Args[1].SetGlobalVar(static_cast<RuntimeScriptValue *>(inst.FixedArg));
+				else
+					codeOp.Args[1].SetStringLiteral(static_cast<char *>(inst.FixedArg));
+				arg_fixup = FIXUP_NOFIXUP;
+			}
+		} else {
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
 
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+			CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
+								"invalid instruction %d found in code stream", codeOp.Instruction.Code);
 
-		CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
-							"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+			codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
 
+			CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
+								"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
 
-		// Read arguments; use switch as it proved to be faster than the loop
 
-		switch (codeOp.ArgCount) {
-		case 3:
-			codeOp.Args[2].SetInt32(static_cast<int32_t>(codeInst->code[pc + 3]));
-			/* fall-through */
-		case 2:
-			codeOp.Args[1].SetInt32(static_cast<int32_t>(codeInst->code[pc + 2]));
-			/* fall-through */
-		case 1:
-			codeOp.Args[0].SetInt32(static_cast<int32_t>(codeInst->code[pc + 1]));
-			break;
-		default:
-			break;
+			// Read arguments; use switch as it proved to be faster than the loop
+
+			switch (codeOp.ArgCount) {
+			case 3:
+				codeOp.Args[2].SetInt32(static_cast<int32_t>(codeInst->code[pc + 3]));
+				/* fall-through */
+			case 2:
+				codeOp.Args[1].SetInt32(static_cast<int32_t>(codeInst->code[pc + 2]));
+				/* fall-through */
+			case 1:
+				codeOp.Args[0].SetInt32(static_cast<int32_t>(codeInst->code[pc + 1]));
+				break;
+			default:
+				break;
+			}
+			arg_fixup = (codeOp.ArgCount >= 2) ? codeInst->code_fixups[pc + 2] : FIXUP_NOFIXUP;
 		}
+
+		if (profile)
+			profile->Instructions++;
 		//---------------------------------------------------------------------
 		/* End read operation */
 		//=====================================================================
@@ -692,7 +751,7 @@ int ccInstance::Run(int32_t curpc) {
 			// be only up to 4 bytes large;
 			// I guess that's an obsolete way to do WRITE, WRITEW and WRITEB
 			const auto arg_size = codeOp.Arg1i();
-			FixupArgument(codeOp.Args[1], codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
+			FixupArgument(codeOp.Args[1], arg_fixup, codeInst->code[pc + 2], this->stack, codeInst->strings);
 			ASSERT_CC_ERROR();
 			const auto &arg_value = codeOp.Arg2();
 			switch (arg_size) {
@@ -721,15 +780,19 @@ int ccInstance::Run(int32_t curpc) {
 			curnest--;
 			pc = rval.IValue;
 			if (pc == 0) {
+				if (profile)
+					profile->TimeUs += g_system->getMicros() - profile_time;
 				returnValue = registers[SREG_AX].IValue;
 				return 0;
 			}
+			if (profile)
+				SwitchFunctionProfile(profile, profile_time, codeInst->GetFunctionProfile(funcstart[curnest]));
 			POP_CALL_STACK;
 			continue; // continue so that the PC doesn't get overwritten
 		}
 		case SCMD_LITTOREG: {
 			auto &reg1 = registers[codeOp.Arg1i()];
-			FixupArgument(codeOp.Args[1], codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
+			FixupArgument(codeOp.Args[1], arg_fixup, codeInst->code[pc + 2], this->stack, codeInst->strings);
 			ASSERT_CC_ERROR();
 			const auto &arg_value = codeOp.Arg2();
 			reg1 = arg_value;
@@ -893,6 +956,11 @@ int ccInstance::Run(int32_t curpc) {
 			curnest++;
 			thisbase[curnest] = 0;
 			funcstart[curnest] = pc;
+
+			if (profile) {
+				SwitchFunctionProfile(profile, profile_time, codeInst->GetFunctionProfile(pc));
+				profile->Calls++;
+			}
 			continue; // continue so that the PC doesn't get overwritten
 		}
 		case SCMD_MEMREADB: {
@@ -1168,10 +1236,16 @@ int ccInstance::Run(int32_t curpc) {
 			}
 			callAddr /= sizeof(uintptr_t); // size of ccScript::code elements
 
+			// The called function is profiled by its own Run()
+			if (profile)
+				profile->TimeUs += g_system->getMicros() - profile_time;
+
 			if (Run(static_cast<int32_t>(callAddr)))
 				return -1;
 
 			runningInst = wasRunning;
+			if (profile)
+				profile_time = g_system->getMicros();
 
 			if ((flags & INSTF_ABORTED) == 0)
 				ASSERT_STACK_UNWINDED(oldstack, oldstackdata);
@@ -1466,6 +1540,9 @@ int ccInstance::Run(int32_t curpc) {
 
 		pc += codeOp.ArgCount + 1;
 	}
+
+	if (profile)
+		profile->TimeUs += g_system->getMicros() - profile_time;
 	return 0;
 }
 
@@ -1598,6 +1675,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 		globaldata = joined->globaldata;
 		code = joined->code;
 		codesize = joined->codesize;
+		decoded = joined->decoded;
 	} else {
 		// create own memory space
 		// NOTE: globalvars are created in CreateGlobalVars()
@@ -1618,6 +1696,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 			for (int i = 0; i < codesize; ++i)
 				code[i] = scri->code[i];
 		}
+		decoded.reset(new DecodedCode());
 	}
 
 	// just use the pointer to the strings since they don't change
@@ -1723,6 +1802,7 @@ void ccInstance::Free() {
 			free(code);
 	}
 	globalvars.reset();
+	decoded.reset();
 	globaldata = nullptr;
 	code = nullptr;
 	strings = nullptr;
@@ -1933,6 +2013,8 @@ bool ccInstance::CreateRuntimeCodeFixups(const ccScript *scri) {
 }
 
 bool ccInstance::ResolveImportFixups(const ccScript *scri) {
+	// The code is about to change, decode it again when run
+	decoded->Clear();
 	for (int fixup_idx = 0; fixup_idx < scri->numfixups; ++fixup_idx) {
 		if (scri->fixuptypes[fixup_idx] != FIXUP_IMPORT)
 			continue;
@@ -1953,6 +2035,101 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 	return true;
 }
 
+void ccInstance::DecodeCode() {
+	DecodedCode &dc = *decoded;
+	dc.Clear();
+	dc.Index.resize(codesize);
+	dc.Built = true;
+
+	for (int32_t at = 0; at < codesize;) {
+		DecodedInstruction inst;
+		inst.Instruction.Code       = code[at];
+		inst.Instruction.InstanceId = (inst.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+		inst.Instruction.Code      &= INSTANCE_ID_REMOVEMASK;
+		// Stop at the first bad instruction, Run() reports it if it gets there
+		if (inst.Instruction.Code < 0 || inst.Instruction.Code >= CC_NUM_SCCMDS)
+			break;
+		inst.ArgCount = (*g_commands)[inst.Instruction.Code].ArgCount;
+		if (at + inst.ArgCount >= codesize)
+			break;
+		for (int i = 0; i < inst.ArgCount; ++i)
+			inst.Args[i] = static_cast<int32_t>(code[at + 1 + i]);
+
+		// Only these apply a fixup to their second argument. The imports and
+		// the stack addresses are left to resolve when running.
+		inst.Fixup = FIXUP_NOFIXUP;
+		if (inst.Instruction.Code == SCMD_LITTOREG || inst.Instruction.Code == SCMD_WRITELIT) {
+			inst.Fixup = code_fixups[at + 2];
+			switch (inst.Fixup) {
+			case FIXUP_GLOBALDATA:
+				inst.FixedArg = &reinterpret_cast<ScriptVariable *>(code[at + 2])->RValue;
+				break;
+			case FIXUP_STRING:
+				inst.FixedArg = strings + code[at + 2];
+				break;
+			case FIXUP_FUNCTION:
+				// Already read as the integer value
+				inst.Fixup = FIXUP_NOFIXUP;
+				break;
+			default:
+				break;
+			}
+		}
+
+		dc.Instructions.push_back(inst);
+		dc.Index[at] = dc.Instructions.size();
+		at += inst.ArgCount + 1;
+	}
+}
+
+ScriptFunctionProfile *ccInstance::GetFunctionProfile(int32_t funcstart) const {
+	const char *section = instanceof->GetSectionName(funcstart);
+	const String key = String::FromFormat("%s:%d", section, funcstart);
+	auto it = _GP(scriptProfile).find(key);
+	if (it != _GP(scriptProfile).end())
+		return &it->_value;
+
+	ScriptFunctionProfile &profile = _GP(scriptProfile)[key];
+	for (int k = 0; k < instanceof->numexports; k++) {
+		const int32_t etype = (instanceof->export_addr[k] >> 24L) & 0x000ff;
+		const int32_t eaddr = (instanceof->export_addr[k] & 0x00ffffff);
+		if (etype == EXPORT_FUNCTION && eaddr == funcstart) {
+			profile.Name = String::FromFormat("%s: %s", section, instanceof->exports[k]);
+			return &profile;
+		}
+	}
+	profile.Name = String::FromFormat("%s: function at %d", section, funcstart);
+	return &profile;
+}
+
+void ccSetScriptProfiling(bool enable) {
+	_G(scriptProfiling) = enable;
+}
+
+bool ccGetScriptProfiling() {
+	return _G(scriptProfiling);
+}
+
+void ccResetScriptProfile() {
+	// The entries are kept, running scripts may still point to them
+	for (auto &entry : _GP(scriptProfile)) {
+		entry._value.Calls = 0;
+		entry._value.Instructions = 0;
+		entry._value.TimeUs = 0;
+	}
+}
+
+void ccGetScriptProfile(std::vector<ScriptFunctionProfile> &profile) {
+	profile.clear();
+	for (const auto &entry : _GP(scriptProfile)) {
+		if (entry._value.Instructions > 0)
+			profile.push_back(entry._value);
+	}
+	std::sort(profile.begin(), profile.end(), [](const ScriptFunctionProfile &a, const ScriptFunctionProfile &b) {
+		return a.TimeUs > b.TimeUs;
+	});
+}
+
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval) {
 	// Write value to the stack tail and advance stack ptr
 	registers[SREG_SP].WriteValue(rval);
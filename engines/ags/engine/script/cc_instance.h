@@ -24,6 +24,7 @@
 
 #include "common/std/memory.h"
 #include "common/std/map.h"
+#include "common/std/vector.h"
 #include "ags/engine/ac/timer.h"
 #include "ags/shared/script/cc_internal.h"
 #include "ags/shared/script/cc_script.h"  // ccScript
@@ -83,6 +84,39 @@ struct ScriptOperation {
 	inline int Arg3i() const { return Args[2].IValue; }
 };
 
+// An instruction decoded ahead of running the script, see ccInstance::DecodeCode()
+struct DecodedInstruction {
+	ScriptInstruction Instruction;
+	int32_t ArgCount = 0;
+	int32_t Args[MAX_SCMD_ARGS] = {};
+	// The fixup of the second argument which is left to apply when running,
+	// or FIXUP_NOFIXUP if there is none or FixedArg already points to its value
+	int32_t Fixup = 0;
+	void *FixedArg = nullptr;
+};
+
+// The byte-code of a script instance decoded into instructions, shared with its forks
+struct DecodedCode {
+	bool Built = false;
+	// For each code position, the index of the instruction starting there + 1, or 0
+	std::vector<uint32_t> Index;
+	std::vector<DecodedInstruction> Instructions;
+
+	void Clear() {
+		Built = false;
+		Index.clear();
+		Instructions.clear();
+	}
+};
+
+// Instructions run and time spent in a script function, see ccSetScriptProfiling()
+struct ScriptFunctionProfile {
+	Shared::String Name;
+	uint32_t Calls = 0;
+	uint64_t Instructions = 0;
+	uint64_t TimeUs = 0; // not including the time of the functions it calls
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -154,6 +188,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// code decoded into instructions, built when first run
+	std::shared_ptr<DecodedCode> decoded;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -208,6 +244,11 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decode the code into instructions with their fixups resolved where
+	// they don't depend on the running state
+	void    DecodeCode();
+	// Get the profile of the function starting at the given code position
+	ScriptFunctionProfile *GetFunctionProfile(int32_t funcstart) const;
 
 	// Begin executing script starting from the given bytecode index
 	int     Run(int32_t curpc);
@@ -235,6 +276,13 @@ private:
 	AGS_Clock::time_point _lastAliveTs;
 };
 
+// Count the instructions run and the time spent in each script function
+extern void ccSetScriptProfiling(bool enable);
+extern bool ccGetScriptProfiling();
+extern void ccResetScriptProfile();
+// Get the profiled functions, sorted by decreasing time
+extern void ccGetScriptProfile(std::vector<ScriptFunctionProfile> &profile);
+
 extern void script_commands_init();
 extern void script_commands_free();
 
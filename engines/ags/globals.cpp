@@ -140,6 +140,7 @@ Globals::Globals() {
 	// cc_instance.cpp globals
 	_InstThreads = new std::deque<ccInstance *>();
 	_GlobalReturnValue = new RuntimeScriptValue();
+	_scriptProfile = new std::unordered_map<String, ScriptFunctionProfile>();
 
 	// cc_options.cpp globals
 	_ccCompOptions = SCOPT_LEFTTORIGHT;
@@ -434,6 +435,7 @@ Globals::~Globals() {
 	delete _InstThreads;
 	delete _GlobalReturnValue;
 	delete _scriptDumpFile;
+	delete _scriptProfile;
 
 	// cc_serializer.cpp globals
 	delete _ccUnserializer;
@@ -167,6 +167,7 @@ struct ScriptDialog;
 struct ScriptDialogOptionsRendering;
 struct ScriptDrawingSurface;
 struct ScriptError;
+struct ScriptFunctionProfile;
 struct ScriptGUI;
 struct ScriptHotspot;
 struct ScriptInvItem;
@@ -396,6 +397,9 @@ public:
 	// Of 2012-12-20: now used only for plugin exports
 	RuntimeScriptValue *_GlobalReturnValue;
 	Common::DumpFile *_scriptDumpFile = nullptr;
+	// Script functions profiled by ccInstance::Run(), by section and start position
+	bool _scriptProfiling = false;
+	std::unordered_map<String, ScriptFunctionProfile> *_scriptProfile;
 
 	/**@}*/
 
@@ -25,6 +25,7 @@
 #include "bladerunner/time.h"
 
 #include "common/debug.h"
+#include "common/frametimings.h"
 #include "common/system.h"
 
 namespace BladeRunner {
@@ -55,11 +56,15 @@ void Framelimiter::wait() {
 	uint32 frameDuration = timeNow - _timeFrameStart;
 	if (frameDuration < _speedLimitMs) {
 		uint32 waittime = _speedLimitMs - frameDuration;
+		Common::FrameTimings *frameTimings = _vm->_system->getFrameTimings();
+		const uint64 sleepStart = frameTimings ? _vm->_system->getMicros() : 0;
 		if (_vm->_noDelayMillisFramelimiter) {
 			while (_vm->_time->currentSystem() - timeNow < waittime) { }
 		} else {
 			_vm->_system->delayMillis(waittime);
 		}
+		if (frameTimings)
+			frameTimings->addTime(Common::FrameTimings::kStageSleep, (uint32)(_vm->_system->getMicros() - sleepStart));
 		timeNow += waittime;
 	}
 	// debug("frametime %i ms", timeNow - _timeFrameStart);
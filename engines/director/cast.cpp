@@ -76,6 +76,9 @@ Cast::Cast(Movie *movie, uint16 castLibID, bool isShared, bool isExternal, uint1
 	_loadMutex = true;
 
 	_lingoArchive = new LingoArchive(this);
+	// The handlers of the movie change with its casts
+	if (g_lingo)
+		g_lingo->invalidateHandlerCache();
 
 	_castArrayStart = _castArrayEnd = 0;
 	_castArrayStartForChecksum = _castArrayEndForChecksum = 0;
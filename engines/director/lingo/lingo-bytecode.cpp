@@ -439,6 +439,7 @@ void LC::cb_hilite() {
 }
 
 void LC::cb_localcall() {
+	const inst *site = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	int functionId = g_lingo->readInt();
 
 	Datum nargs = g_lingo->pop();
@@ -447,7 +448,7 @@ void LC::cb_localcall() {
 		if (debugChannelSet(3, kDebugLingoExec))
 			g_lingo->printArgs(name.c_str(), nargs.u.i, "localcall:");
 
-		LC::call(name, nargs.u.i, nargs.type == ARGC);
+		LC::call(name, nargs.u.i, nargs.type == ARGC, site);
 
 	} else {
 		warning("cb_localcall: first arg should be of type ARGC or ARGCNORET, not %s", nargs.type2str());
@@ -554,11 +555,12 @@ void LC::cb_proplist() {
 
 
 void LC::cb_call() {
+	const inst *site = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name = g_lingo->readString();
 
 	Datum nargs = g_lingo->pop();
 	if ((nargs.type == ARGC) || (nargs.type == ARGCNORET)) {
-		LC::call(name, nargs.u.i, nargs.type == ARGC);
+		LC::call(name, nargs.u.i, nargs.type == ARGC, site);
 
 	} else {
 		warning("cb_call: first arg should be of type ARGC or ARGCNORET, not %s", nargs.type2str());
@@ -569,10 +571,8 @@ void LC::cb_call() {
 
 void LC::cb_globalpush() {
 	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = GLOBALREF;
 	debugC(3, kDebugLingoExec, "cb_globalpush: pushing %s to stack", name.c_str());
-	Datum result = g_lingo->varFetch(target);
+	Datum result = g_lingo->varFetch(GLOBALREF, name);
 	g_lingo->push(result);
 }
 
@@ -1700,6 +1700,7 @@ ScriptContext *LingoCompiler::compileLingoV4(Common::SeekableReadStreamEndian &s
 			}
 		}
 	}
+	g_lingo->invalidateHandlerCache();
 
 	if (!skipdump && ConfMan.getBool("dump_scripts")) {
 		out.flush();
@@ -523,27 +523,23 @@ void LC::c_proprefpush() {
 }
 
 void LC::c_varpush() {
-	LC::c_varrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(VARREF, name));
 }
 
 void LC::c_globalpush() {
-	LC::c_globalrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(GLOBALREF, name));
 }
 
 void LC::c_localpush() {
-	LC::c_localrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(LOCALREF, name));
 }
 
 void LC::c_proppush() {
-	LC::c_proprefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(PROPREF, name));
 }
 
 void LC::c_stackpeek() {
@@ -1601,22 +1597,24 @@ void LC::c_telldone() {
 //************************
 
 void LC::c_callcmd() {
+	const inst *site = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name(g_lingo->readString());
 
 	int nargs = g_lingo->readInt();
 
-	LC::call(name, nargs, false);
+	LC::call(name, nargs, false, site);
 }
 
 void LC::c_callfunc() {
+	const inst *site = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name(g_lingo->readString());
 
 	int nargs = g_lingo->readInt();
 
-	LC::call(name, nargs, true);
+	LC::call(name, nargs, true, site);
 }
 
-void LC::call(const Common::String &name, int nargs, bool allowRetVal) {
+void LC::call(const Common::String &name, int nargs, bool allowRetVal, const inst *site) {
 	if (debugChannelSet(3, kDebugLingoExec))
 		g_lingo->printArgs(name.c_str(), nargs, "call:");
 
@@ -1681,30 +1679,18 @@ void LC::call(const Common::String &name, int nargs, bool allowRetVal) {
 		}
 	}
 
-	// Handler
-	funcSym = g_lingo->getHandler(name);
+	// Handler, or builtin
+	Symbol listSym;
+	funcSym = g_lingo->getCallSiteHandler(site, name, allowRetVal, listSym);
 
-	if (g_lingo->_builtinListHandlers.contains(name) && nargs >= 1) {
+	if (listSym.type != VOIDSYM && nargs >= 1) {
 		// Lingo builtin functions in the "List" category have very strange override mechanics.
 		// If the first argument is an ARRAY or PARRAY, it will use the builtin.
 		// Otherwise, it will fall back to whatever handler is defined globally.
 		Datum firstArg = g_lingo->peek(nargs - 1);
 		if (firstArg.type == ARRAY || firstArg.type == PARRAY ||
 				firstArg.type == POINT || firstArg.type == RECT) {
-			funcSym = g_lingo->_builtinListHandlers[name];
-		}
-	}
-
-	if (funcSym.type == VOIDSYM) { // The built-ins could be overridden
-		// Builtin
-		if (allowRetVal) {
-			if (g_lingo->_builtinFuncs.contains(name)) {
-				funcSym = g_lingo->_builtinFuncs[name];
-			}
-		} else {
-			if (g_lingo->_builtinCmds.contains(name)) {
-				funcSym = g_lingo->_builtinCmds[name];
-			}
+			funcSym = listSym;
 		}
 	}
 
@@ -124,7 +124,8 @@ void c_callcmd();
 void c_callfunc();
 
 void call(const Symbol &targetSym, int nargs, bool allowRetVal);
-void call(const Common::String &name, int nargs, bool allowRetVal);
+// The handler found by name is cached for the call site, if given
+void call(const Common::String &name, int nargs, bool allowRetVal, const inst *site = nullptr);
 
 void c_procret();
 void procret();
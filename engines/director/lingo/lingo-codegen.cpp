@@ -257,6 +257,7 @@ ScriptContext *LingoCompiler::compileLingo(const Common::U32String &code, LingoA
 			}
 		}
 	}
+	g_lingo->invalidateHandlerCache();
 
 	delete _methodVars;
 	_methodVars = nullptr;
@@ -565,9 +565,14 @@ void LM::m_dispose(int nargs) {
 ScriptContext::ScriptContext(Common::String name, ScriptType type, int id, uint16 castLibHint, uint16 parentNumber, int scriptId)
 	: Object<ScriptContext>(name), _scriptType(type), _id(id), _castLibHint(castLibHint), _parentNumber(parentNumber), _scriptId(scriptId) {
 	_objType = kScriptObj;
+	// A new context may get the address of a deleted one
+	if (g_lingo)
+		g_lingo->invalidateHandlerCache();
 }
 
 ScriptContext::ScriptContext(const ScriptContext &sc) : Object<ScriptContext>(sc) {
+	if (g_lingo)
+		g_lingo->invalidateHandlerCache();
 	_scriptType = sc._scriptType;
 	_functionNames = sc._functionNames;
 	for (auto &it : sc._functionHandlers) {
@@ -612,6 +617,7 @@ Symbol ScriptContext::define(const Common::String &name, ScriptData *code, Commo
 	}
 
 	_functionHandlers[name] = sym;
+	g_lingo->invalidateHandlerCache();
 	if (g_lingo->_eventHandlerTypeIds.contains(name)) {
 		_eventHandlers[g_lingo->_eventHandlerTypeIds[name]] = sym;
 	}
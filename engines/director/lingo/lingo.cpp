@@ -179,6 +179,7 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 
 	_state = nullptr;
 	_globalCounter = 0;
+	_callSiteHandlersStale = false;
 	_freezeState = false;
 	_freezePlay = false;
 	_playDone = false;
@@ -354,6 +355,38 @@ Symbol Lingo::getHandler(const Common::String &name) {
 	return sym;
 }
 
+Symbol Lingo::getCallSiteHandler(const inst *site, const Common::String &name, bool allowRetVal, Symbol &listHandler) {
+	if (_callSiteHandlersStale) {
+		_callSiteHandlers.clear();
+		_callSiteHandlersStale = false;
+	}
+
+	// The same call site may run in another movie, or in another copy of its script
+	CallSiteHandler uncached;
+	CallSiteHandler &entry = site ? _callSiteHandlers[site] : uncached;
+	Movie *movie = g_director->getCurrentMovie();
+	if (!entry.valid || entry.context != _state->context || entry.movie != movie || entry.allowRetVal != allowRetVal) {
+		entry.handler = getHandler(name);
+		if (entry.handler.type == VOIDSYM) { // The built-ins could be overridden
+			SymbolHash &builtins = allowRetVal ? _builtinFuncs : _builtinCmds;
+			SymbolHash::iterator it = builtins.find(name);
+			if (it != builtins.end())
+				entry.handler = it->_value;
+		}
+
+		SymbolHash::iterator it = _builtinListHandlers.find(name);
+		entry.listHandler = (it != _builtinListHandlers.end()) ? it->_value : Symbol();
+
+		entry.valid = true;
+		entry.context = _state->context;
+		entry.movie = movie;
+		entry.allowRetVal = allowRetVal;
+	}
+
+	listHandler = entry.listHandler;
+	return entry.handler;
+}
+
 
 void LingoArchive::patchCode(const Common::U32String &code, ScriptType type, uint16 id, const char *scriptName, uint32 preprocFlags) {
 	debugC(1, kDebugCompile, "LingoArchive::patchCode: Patching code for type %s(%d) with id %d in '%s%s'\n"
@@ -377,6 +410,7 @@ void LingoArchive::patchCode(const Common::U32String &code, ScriptType type, uin
 		}
 		sc->_functionHandlers.clear();
 		delete sc;
+		g_lingo->invalidateHandlerCache();
 	}
 }
 
@@ -411,6 +445,8 @@ void LingoArchive::removeCode(ScriptType type, uint16 id) {
 	if (!ctx)
 		return;
 
+	g_lingo->invalidateHandlerCache();
+
 	ctx->decRefCount();
 	scriptContexts[type].erase(id);
 }
@@ -818,6 +854,7 @@ void Lingo::resetLingoGo() {
 
 void Lingo::cleanupLingo() {
 	g_director->_wm->removeMenu();
+	invalidateHandlerCache();
 
 	while (_state->callstack.size()) {
 		popContext(true);
@@ -894,26 +931,27 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool equality) {
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Datum &d) {
 	type = d.type;
 	u = d.u;
-	refCount = d.refCount;
-	*refCount += 1;
+	refCount = d.shareRefCount();
 	ignoreGlobal = false;
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d && (refCount != d.refCount || !refCount)) {
+		// Take the new value first, d could be part of our payload
+		int *newRefCount = d.shareRefCount();
+		const DatumType newType = d.type;
+		const decltype(u) newU = d.u;
 		reset();
-		type = d.type;
-		u = d.u;
-		refCount = d.refCount;
-		*refCount += 1;
+		type = newType;
+		u = newU;
+		refCount = newRefCount;
 	}
 	ignoreGlobal = false;
 	return *this;
@@ -922,16 +960,14 @@ Datum& Datum::operator=(const Datum &d) {
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -951,8 +987,7 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -965,8 +1000,7 @@ Datum::Datum(CastMember *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -1001,9 +1035,32 @@ Datum::Datum(const Common::Rect &rect) {
 	ignoreGlobal = false;
 }
 
+int *Datum::shareRefCount() const {
+	if (!refCount) {
+		if (isImmediate())
+			return nullptr;
+
+		// A payload was put in a value which had no reference count yet,
+		// it was its only owner until now
+		if (type == OBJECT || type == MEDIA) {
+			refCount = u.obj->getRefCount();
+		} else {
+			refCount = new int;
+			*refCount = 0;
+		}
+		*refCount += 1;
+	}
+
+	*refCount += 1;
+	return refCount;
+}
+
 void Datum::reset() {
-	if (!refCount)
+	if (!refCount) {
+		if (!isImmediate() && type != OBJECT && type != MEDIA)
+			freePayload();
 		return;
+	}
 
 	*refCount -= 1;
 	// Coverity thinks that we always free memory, as it assumes
@@ -1011,68 +1068,72 @@ void Datum::reset() {
 	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
 	if (*refCount <= 0) {
-		switch (type) {
-		case VOID:
-		case INT:
-		case FLOAT:
-		case ARGC:
-		case ARGCNORET:
-		case CASTLIBREF:
-		case SPRITEREF:
-			break;
-		case VARREF:
-		case GLOBALREF:
-		case LOCALREF:
-		case PROPREF:
-		case STRING:
-		case SYMBOL:
-			delete u.s;
-			break;
-		case ARRAY:
-		case POINT:
-		case RECT:
-			delete u.farr;
-			break;
-		case PARRAY:
-			delete u.parr;
-			break;
-		case MEDIA:
-			delete u.obj;
-			break;
-		case OBJECT:
-			if (u.obj->getObjType() == kWindowObj) {
-				// Window has an override for decRefCount, use it directly
-				*refCount += 1;
-				static_cast<Window *>(u.obj)->decRefCount();
-			} else {
-				// *refCount is copied between the Datum and the Object,
-				// so should be safe to delete the Object
-				delete u.obj;
-			}
-			break;
-		case CHUNKREF:
-			delete u.cref;
-			break;
-		case CASTREF:
-		case FIELDREF:
-			delete u.cast;
-			break;
-		case MENUREF:
-			delete u.menu;
-			break;
-		case PICTUREREF:
-			delete u.picture;
-			break;
-		default:
-			warning("Datum::reset(): Unprocessed REF type %d", type);
-			break;
-		}
+		freePayload();
 		if (type != OBJECT && type != MEDIA) // object owns refCount
 			delete refCount;
 	}
 #endif
 }
 
+void Datum::freePayload() {
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+	case CASTLIBREF:
+	case SPRITEREF:
+		break;
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+	case STRING:
+	case SYMBOL:
+		delete u.s;
+		break;
+	case ARRAY:
+	case POINT:
+	case RECT:
+		delete u.farr;
+		break;
+	case PARRAY:
+		delete u.parr;
+		break;
+	case MEDIA:
+		delete u.obj;
+		break;
+	case OBJECT:
+		if (u.obj->getObjType() == kWindowObj) {
+			// Window has an override for decRefCount, use it directly
+			*refCount += 1;
+			static_cast<Window *>(u.obj)->decRefCount();
+		} else {
+			// *refCount is copied between the Datum and the Object,
+			// so should be safe to delete the Object
+			delete u.obj;
+		}
+		break;
+	case CHUNKREF:
+		delete u.cref;
+		break;
+	case CASTREF:
+	case FIELDREF:
+		delete u.cast;
+		break;
+	case MENUREF:
+		delete u.menu;
+		break;
+	case PICTUREREF:
+		delete u.picture;
+		break;
+	default:
+		warning("Datum::reset(): Unprocessed REF type %d", type);
+		break;
+	}
+}
+
 Datum Datum::eval() const {
 	if (isRef()) {
 		return g_lingo->varFetch(*this);
@@ -1576,6 +1637,9 @@ void Lingo::runTests() {
 	Common::sort(fileList.begin(), fileList.end());
 
 	int counter = 1;
+	int executed = 0;
+	// Execution times, to compare the speed of the interpreter between builds
+	uint64 totalTime = 0;
 
 	for (uint i = 0; i < fileList.size(); i++) {
 		Common::SeekableReadStream *const  stream = SearchMan.createReadStreamForMember(fileList[i]);
@@ -1591,10 +1655,16 @@ void Lingo::runTests() {
 			mainArchive->addCode(Common::U32String(script, Common::kMacRoman), kTestScript, counter);
 
 			if (!debugChannelSet(-1, kDebugCompileOnly)) {
-				if (!_compiler->_hadError)
+				if (!_compiler->_hadError) {
+					uint64 start = g_system->getMicros();
 					executeScript(kTestScript, CastMemberID(counter, DEFAULT_CAST_LIB));
-				else
+					uint64 time = g_system->getMicros() - start;
+					debug(">> Executed in %u us", (uint)time);
+					totalTime += time;
+					executed++;
+				} else {
 					debug(">> Skipping execution");
+				}
 			}
 
 			free(script);
@@ -1604,6 +1674,9 @@ void Lingo::runTests() {
 
 		inFile.close();
 	}
+
+	if (executed)
+		debug(">> Executed %d scripts in %u us", executed, (uint)totalTime);
 }
 
 void Lingo::executeImmediateScripts(Frame *frame) {
@@ -1838,20 +1911,44 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 
 	switch (var.type) {
 	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+		return varFetch(var.type, *var.u.s, silent);
+	case FIELDREF:
+	case CASTREF:
+	case CHUNKREF:
 		{
-			Datum d;
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
+			Common::String chunk(evalChunkRef(var), Common::kUtf8);
+			result = Datum(chunk);
+		}
+		break;
+	default:
+		warning("varFetch: fetch from non-variable");
+		break;
+	}
 
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
+	return result;
+}
+
+Datum Lingo::varFetch(DatumType type, const Common::String &name, bool silent) {
+	Datum result;
+	g_debugger->varReadHook(name);
+
+	switch (type) {
+	case VARREF:
+		{
+			if (_state->localVars) {
+				DatumHash::const_iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end())
+					return it->_value;
 			}
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				return _state->me.u.obj->getProp(name);
 			}
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end())
+				return it->_value;
 
 			if (!silent)
 				debugC(1, kDebugLingoExec, "varFetch: variable %s not found", name.c_str());
@@ -1860,21 +1957,19 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 		break;
 	case GLOBALREF:
 		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end())
+				return it->_value;
 			debugC(1, kDebugLingoExec, "varFetch: global variable %s not defined", name.c_str());
 			return result;
 		}
 		break;
 	case LOCALREF:
 		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
+			if (_state->localVars) {
+				DatumHash::const_iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end())
+					return it->_value;
 			}
 			debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
 			return result;
@@ -1882,8 +1977,6 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 		break;
 	case PROPREF:
 		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				return _state->me.u.obj->getProp(name);
 			}
@@ -1891,14 +1984,6 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 			return result;
 		}
 		break;
-	case FIELDREF:
-	case CASTREF:
-	case CHUNKREF:
-		{
-			Common::String chunk(evalChunkRef(var), Common::kUtf8);
-			result = Datum(chunk);
-		}
-		break;
 	default:
 		warning("varFetch: fetch from non-variable");
 		break;
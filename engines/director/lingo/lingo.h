@@ -143,7 +143,9 @@ struct Datum {	/* interpreter stack type */
 		PictureReference *picture; /* PICTUREREF */
 	} u;
 
-	int *refCount;
+	// Shared by the copies of a value pointing to a payload. The values
+	// held in the union itself (see isImmediate()) don't have one.
+	mutable int *refCount;
 
 	bool ignoreGlobal; // True if this Datum should be ignored by showGlobals and clearGlobals
 
@@ -178,6 +180,10 @@ struct Datum {	/* interpreter stack type */
 	bool isArray() const;
 	bool isNumeric() const;
 	bool isVoid() const { return type == VOID; }
+	bool isImmediate() const {
+		return type == VOID || type == INT || type == FLOAT || type == ARGC || type == ARGCNORET ||
+			type == CASTLIBREF || type == SPRITEREF;
+	}
 
 	const char *type2str(bool ilk = false) const;
 
@@ -189,6 +195,10 @@ struct Datum {	/* interpreter stack type */
 	bool operator<(const Datum &d) const;
 	bool operator>=(const Datum &d) const;
 	bool operator<=(const Datum &d) const;
+
+private:
+	int *shareRefCount() const;
+	void freePayload();
 };
 
 struct ChunkReference {
@@ -413,6 +423,11 @@ private:
 public:
 	ScriptType event2script(LEvent ev);
 	Symbol getHandler(const Common::String &name);
+	// Resolve the handler or builtin called by name from the given call site,
+	// along with the builtin list handler which may override it, see LC::call()
+	Symbol getCallSiteHandler(const inst *site, const Common::String &name, bool allowRetVal, Symbol &listHandler);
+	// Forget the handlers resolved at call sites, after handlers were defined or removed
+	void invalidateHandlerCache() { _callSiteHandlersStale = true; }
 
 	void processEvents(Common::Queue<LingoEvent> &queue, bool isInputEvent);
 
@@ -427,6 +442,8 @@ public:
 	void cleanLocalVars();
 	void varAssign(const Datum &var, const Datum &value);
 	Datum varFetch(const Datum &var, bool silent = false);
+	// Fetch a variable of the given reference type without making a reference to it
+	Datum varFetch(DatumType type, const Common::String &name, bool silent = false);
 	Common::U32String evalChunkRef(const Datum &var);
 	Datum findVarV4(int varType, const Datum &id);
 	CastMemberID resolveCastMember(const Datum &memberID, const Datum &castLib, CastType type);
@@ -531,6 +548,17 @@ public:
 	SymbolHash _builtinFuncs;
 	SymbolHash _builtinConsts;
 	SymbolHash _builtinListHandlers;
+
+	struct CallSiteHandler {
+		bool valid = false;
+		ScriptContext *context = nullptr;
+		Movie *movie = nullptr;
+		bool allowRetVal = false;
+		Symbol handler;
+		Symbol listHandler;
+	};
+	Common::HashMap<const inst *, CallSiteHandler> _callSiteHandlers;
+	bool _callSiteHandlersStale;
 	SymbolHash _methods;
 	XLibOpenerFuncHash _xlibOpeners;
 	XLibCloserFuncHash _xlibClosers;
@@ -429,6 +429,7 @@ void Movie::clearSharedCast() {
 
 	delete _sharedCast;
 	_sharedCast = nullptr;
+	g_lingo->invalidateHandlerCache();
 }
 
 void Movie::loadSharedCastsFrom(Common::Path &filename) {
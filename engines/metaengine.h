@@ -41,6 +41,7 @@ class Keymap;
 class FSList;
 class OutSaveFile;
 class String;
+class ThreadPool;
 
 typedef SeekableReadStream InSaveFile;
 }
@@ -113,6 +114,37 @@ struct ExtendedSavegameHeader {
 	}
 };
 
+/**
+ * A file whose MD5 is computed ahead of the detection, see
+ * MetaEngineDetection::prefetchDetection().
+ *
+ * open() and store() are called on the main thread. In between, a worker
+ * thread computes the MD5 of the opened stream, and only touches the stream
+ * and the plain data fields below.
+ */
+class DetectionPrefetchFile {
+public:
+	DetectionPrefetchFile(const Common::String &fileKey, uint32 numBytes, bool atTail) :
+		key(fileKey), md5Bytes(numBytes), tail(atTail), stream(nullptr), computed(false), size(0) {}
+	virtual ~DetectionPrefetchFile() {}
+
+	/** Open the file, or return nullptr if it can't be read. */
+	virtual Common::SeekableReadStream *open() = 0;
+	/** Keep the computed MD5 where detectGames() finds it. */
+	virtual void store() = 0;
+
+	const Common::String key; ///< Files with the same key are only computed once, only used on the main thread
+	const uint32 md5Bytes; ///< The number of bytes hashed, or 0 for the whole file
+	const bool tail; ///< Whether the bytes at the end of the file are hashed
+
+	Common::SeekableReadStream *stream; ///< The file returned by open()
+	bool computed; ///< Whether the worker thread computed the MD5
+	int64 size; ///< The size of the file
+	uint8 digest[16]; ///< The MD5 of the file
+};
+
+typedef Common::Array<DetectionPrefetchFile *> DetectionPrefetchList;
+
 /**
  * A meta engine factory for Engine instances with the
  * added ability of listing and detecting supported games.
@@ -164,6 +196,16 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false) = 0;
 
+	/**
+	 * Queue the files whose MD5s detectGames() will compute for the given
+	 * list of files, so that they are computed ahead of time on several
+	 * threads, and the following call to detectGames() is faster.
+	 *
+	 * This is called on the main thread, before detectGames(). The default
+	 * implementation queues nothing.
+	 */
+	virtual void prefetchDetection(const Common::FSList &fslist, DetectionPrefetchList &files) {}
+
 	/** Returns the number of bytes used for MD5-based detection, or 0 if not supported. */
 	virtual uint getMD5Bytes() const = 0;
 
@@ -641,6 +683,19 @@ public:
 	Common::String generateUniqueDomain(const Common::String &gameId);
 
 private:
+	friend class Common::Singleton<SingletonBaseType>;
+	EngineManager();
+	~EngineManager();
+
+	/**
+	 * Compute the MD5s queued by MetaEngineDetection::prefetchDetection() for
+	 * all the plugins on worker threads.
+	 */
+	void prefetchDetection(const PluginList &plugins, const Common::FSList &fslist);
+
+	/** Worker threads used for detection, created on first use. */
+	Common::ThreadPool *_detectionThreads;
+
 	/** Find a game across all loaded plugins. */
 	QualifiedGameList findGameInLoadedPlugins(const Common::String &gameId) const;
 
@@ -85,6 +85,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",	&engine->_gamestate->incrementalGC);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
 	registerCmd("speed_throttle",   WRAP_METHOD(Console, cmdSpeedThrottle));
@@ -163,6 +164,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -233,6 +235,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("vm_bench",			WRAP_METHOD(Console, cmdVMBench));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -262,6 +265,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.seeking = kDebugSeekNothing;
 	_debugState.seekLevel = 0;
 	_debugState.runningStep = 0;
+	_debugState.recordingSteps = 0;
 	_debugState.stopOnEvent = false;
 	_debugState.debugging = false;
 	_debugState.breakpointWasHit = false;
@@ -319,6 +323,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("---------\n");
 	debugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	debugPrintf("gc_incremental: Whether garbage collections run in steps between kernel calls\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
 	debugPrintf("speed_throttle: Displays or changes kGameIsRestarting maximum delay\n");
@@ -398,6 +403,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows how long the garbage collections paused the game\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -447,6 +453,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" vm_bench - Records executed instructions and replays them, or times sending a message\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -2934,6 +2941,32 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && scumm_stricmp(argv[1], "reset"))) {
+		debugPrintf("Shows statistics about the garbage collections, with\n");
+		debugPrintf("the pauses in microseconds. The incremental ones run\n");
+		debugPrintf("in steps between kernel calls.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	GCStats &stats = _engine->_gamestate->_gc->getStats();
+	if (argc == 2) {
+		stats.reset();
+		return true;
+	}
+
+	debugPrintf("Collections: %u full, %u incremental in %u steps\n", stats.fullCollections, stats.cycles, stats.steps);
+	debugPrintf("Last collection: %u steps, longest pause %u, %u references found, %u entries freed\n",
+	            stats.lastSteps, stats.lastPause, stats.lastMarked, stats.lastFreed);
+	debugPrintf("Longest pause: %u, total time: %u ms, %u entries freed\n",
+	            stats.maxPause, (uint32)(stats.totalTime / 1000), stats.totalFreed);
+	if (_engine->_gamestate->_gc->isRunning())
+		debugPrintf("An incremental collection is in progress\n");
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3436,6 +3469,192 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdVMBench(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Records the next executed instructions and replays them, decoding them\n");
+		debugPrintf("every time or once per script. Or sends a message to an object several\n");
+		debugPrintf("times, and shows how long the scripts took to run. Pick one which doesn't\n");
+		debugPrintf("change the game state. The decoded instructions can be kept or not.\n");
+		debugPrintf("Usage: %s record [<count>]\n", argv[0]);
+		debugPrintf("       %s replay [<iterations>]\n", argv[0]);
+		debugPrintf("       %s send <count> <object> <selector name> <param1> <param2> ... <paramn>\n", argv[0]);
+		debugPrintf("       %s cache on|off\n", argv[0]);
+		debugPrintf("Example: %s send 1000 ?ego canBeHere\n", argv[0]);
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "record"))
+		return vmBenchRecord(argc, argv);
+	if (!scumm_stricmp(argv[1], "replay"))
+		return vmBenchReplay(argc, argv);
+	if (!scumm_stricmp(argv[1], "send"))
+		return vmBenchSend(argc, argv);
+
+	if (!scumm_stricmp(argv[1], "cache") && argc == 3) {
+		Script::setInstructionCache(!scumm_stricmp(argv[2], "on"));
+		debugPrintf("Decoded instructions are %s\n", Script::getInstructionCache() ? "kept" : "not kept");
+		return true;
+	}
+
+	debugPrintf("Unknown action: %s\n", argv[1]);
+	return true;
+}
+
+bool Console::vmBenchRecord(int argc, const char **argv) {
+	int count = 100000;
+	if (argc > 2 && (!parseInteger(argv[2], count) || count <= 0)) {
+		debugPrintf("Invalid count: %s\n", argv[2]);
+		return true;
+	}
+
+	// The debugger sees every instruction, see SciEngine::scriptDebug()
+	_debugState.recordedSteps.clear();
+	_debugState.recordingSteps = count;
+	_debugState.debugging = true;
+	return cmdExit(0, nullptr);
+}
+
+bool Console::vmBenchReplay(int argc, const char **argv) {
+	int iterations = 100;
+	if (argc > 2 && (!parseInteger(argv[2], iterations) || iterations <= 0)) {
+		debugPrintf("Invalid number of iterations: %s\n", argv[2]);
+		return true;
+	}
+
+	const Common::Array<reg_t> &steps = _debugState.recordedSteps;
+	if (steps.empty()) {
+		debugPrintf("No instructions recorded, use %s record first\n", argv[0]);
+		return true;
+	}
+
+	// The scripts unloaded since are skipped
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	Common::Array<Script *> scripts(steps.size());
+	for (uint i = 0; i < steps.size(); i++) {
+		Script *script = segMan->getScriptIfLoaded(steps[i].getSegment());
+		scripts[i] = script && steps[i].getOffset() < script->getBufSize() ? script : nullptr;
+	}
+
+	const bool instructionCache = Script::getInstructionCache();
+	uint32 times[2];
+	uint32 checksums[2];
+	uint superInstructions = 0;
+
+	for (int cache = 0; cache < 2; cache++) {
+		Script::setInstructionCache(cache != 0);
+		checksums[cache] = 0;
+
+		const uint64 start = g_system->getMicros();
+		for (int n = 0; n < iterations; n++) {
+			for (uint i = 0; i < steps.size(); i++) {
+				if (!scripts[i])
+					continue;
+
+				const PMachineInstruction &instruction = scripts[i]->getInstruction(steps[i].getOffset());
+				checksums[cache] += instruction.extOpcode + instruction.size + instruction.opparams[0];
+
+				// The pairs which ran one after the other run as one
+				if (cache && instruction.superOpcode && i + 1 < steps.size() &&
+					steps[i + 1] == steps[i] + instruction.size) {
+					if (n == 0)
+						superInstructions++;
+					i++;
+				}
+			}
+		}
+		times[cache] = g_system->getMicros() - start;
+	}
+
+	Script::setInstructionCache(instructionCache);
+
+	debugPrintf("%u instructions, %u pairs of them run as superinstructions\n", steps.size(), superInstructions);
+	debugPrintf("Decoding them %d times: %u us every time, %u us once per script\n", iterations, times[0], times[1]);
+	return true;
+}
+
+bool Console::vmBenchSend(int argc, const char **argv) {
+	if (argc < 5) {
+		debugPrintf("Usage: %s send <count> <object> <selector name> <param1> <param2> ... <paramn>\n", argv[0]);
+		return true;
+	}
+
+	int count;
+	if (!parseInteger(argv[2], count) || count <= 0) {
+		debugPrintf("Invalid count: %s\n", argv[2]);
+		return true;
+	}
+
+	EngineState *s = _engine->_gamestate;
+	reg_t object;
+
+	if (parse_reg_t(s, argv[3], &object)) {
+		debugPrintf("Invalid address \"%s\" passed.\n", argv[3]);
+		debugPrintf("Check the \"addresses\" command on how to use addresses\n");
+		return true;
+	}
+
+	const char *selectorName = argv[4];
+	int selectorId = _engine->getKernel()->findSelector(selectorName);
+
+	if (selectorId < 0) {
+		debugPrintf("Unknown selector: \"%s\"\n", selectorName);
+		return true;
+	}
+
+	if (s->_segMan->getObject(object) == nullptr) {
+		debugPrintf("Address \"%04x:%04x\" is not an object\n", PRINT_REG(object));
+		return true;
+	}
+
+	if (lookupSelector(s->_segMan, object, selectorId, nullptr, nullptr) != kSelectorMethod) {
+		debugPrintf("Object has no method \"%s\"\n", selectorName);
+		return true;
+	}
+
+	// everything after the selector name is passed as an argument to the send
+	const int send_argc = argc - 5;
+	Common::Array<reg_t> params(send_argc);
+	for (int i = 0; i < send_argc; i++) {
+		if (parse_reg_t(s, argv[5 + i], &params[i])) {
+			debugPrintf("Invalid address \"%s\" passed.\n", argv[5 + i]);
+			debugPrintf("Check the \"addresses\" command on how to use addresses\n");
+			return true;
+		}
+	}
+
+	const reg_t old_acc = s->r_acc;
+	const int oldStepCounter = s->scriptStepCounter;
+	ExecStack *old_xstack = &s->_executionStack.back();
+	int sent = 0;
+
+	const uint64 start = g_system->getMicros();
+	for (; sent < count && s->abortScriptProcessing == kAbortNone; sent++) {
+		// Create the data block for send_selector() at the top of the stack:
+		// [selector_number][argument_counter][arguments...]
+		StackPtr stackframe = old_xstack->sp;
+		stackframe[0] = make_reg(0, selectorId);
+		stackframe[1] = make_reg(0, send_argc);
+		for (int i = 0; i < send_argc; i++)
+			stackframe[2 + i] = params[i];
+
+		if (send_selector(s, object, object, stackframe + 2 + send_argc,
+		                  2 + send_argc, stackframe) != old_xstack) {
+			s->_executionStackPosChanged = true;
+			run_vm(s);
+			s->xs = old_xstack;
+		}
+	}
+	const uint64 time = g_system->getMicros() - start;
+
+	const uint32 steps = s->scriptStepCounter - oldStepCounter;
+	s->r_acc = old_acc;
+
+	debugPrintf("Sent %d messages in %u us, %u us each, %s the decoded instructions\n", sent, (uint32)time,
+	            (uint32)(time / MAX(sent, 1)), Script::getInstructionCache() ? "keeping" : "without keeping");
+	debugPrintf("%u instructions ran, %u per ms\n", steps, (uint32)(steps * 1000ULL / MAX<uint64>(time, 1)));
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("Shows all objects inside a specified script.\n");
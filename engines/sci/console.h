@@ -113,6 +113,7 @@ private:
 	bool cmdGCShowReachable(int argc, const char **argv);
 	bool cmdGCShowFreeable(int argc, const char **argv);
 	bool cmdGCNormalize(int argc, const char **argv);
+	bool cmdGCStats(int argc, const char **argv);
 	// Music/SFX
 	bool cmdSongLib(int argc, const char **argv);
 	bool cmdSongInfo(int argc, const char **argv);
@@ -160,6 +161,10 @@ private:
 	bool cmdBreakpointAddress(int argc, const char **argv);
 	// VM
 	bool cmdScriptSteps(int argc, const char **argv);
+	bool cmdVMBench(int argc, const char **argv);
+	bool vmBenchRecord(int argc, const char **argv);
+	bool vmBenchReplay(int argc, const char **argv);
+	bool vmBenchSend(int argc, const char **argv);
 	bool cmdScriptObjects(int argc, const char **argv);
 	bool cmdScriptStrings(int argc, const char **argv);
 	bool cmdScriptSaid(int argc, const char **argv);
@@ -22,6 +22,7 @@
 #ifndef SCI_DEBUG_H
 #define SCI_DEBUG_H
 
+#include "common/array.h"
 #include "common/list.h"
 #include "sci/engine/vm_types.h"	// for StackPtr
 
@@ -83,6 +84,8 @@ struct DebugState {
 	bool stopOnEvent;
 	DebugSeeking seeking;		// Stepping forward until some special condition is met
 	int runningStep;			// Set to > 0 to allow multiple stepping
+	int recordingSteps;			// Set to > 0 to record the addresses of the next instructions
+	Common::Array<reg_t> recordedSteps;	// The recorded addresses, replayed by the vm_bench command
 	int seekLevel;				// Used for seekers that want to check their exec stack depth
 	int seekSpecial;			// Used for special seeks
 	int old_pc_offset;
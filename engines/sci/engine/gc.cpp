@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -67,6 +68,14 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 		push(*it);
 }
 
+void WorklistManager::rescan(reg_t reg) {
+	if (!reg.getSegment())
+		return;
+
+	_map.setVal(reg, true);
+	_worklist.push_back(reg);
+}
+
 static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
 	AddrSet *normal_map = new AddrSet();
 
@@ -83,26 +92,44 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 	return normal_map;
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+/**
+ * Follows the references in the worklist, and the ones they lead to
+ * @param budget		The number of references to follow before returning, or 0
+ *						to follow all of them
+ * @param skipFreed		Whether to skip the entries which were freed since they
+ *						were added, which only happens between the steps of an
+ *						incremental collection
+ * @return The number of references followed
+ */
+static uint processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap, uint budget = 0, bool skipFreed = false) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
-	while (!wm._worklist.empty()) {
+	uint count = 0;
+	while (!wm._worklist.empty() && (!budget || count < budget)) {
 		reg_t reg = wm._worklist.back();
 		wm._worklist.pop_back();
+		count++;
 		if (reg.getSegment() != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
 			if (reg.getSegment() < heap.size() && heap[reg.getSegment()]) {
+				SegmentObj *mobj = heap[reg.getSegment()];
+				if (skipFreed && !mobj->isValidOffset(reg.getOffset()))
+					continue;
+
 				// Valid heap object? Find its outgoing references!
-				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
+				wm.pushArray(mobj->listAllOutgoingReferences(reg));
 			}
 		}
 	}
+	return count;
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+/**
+ * Adds the registers, the value stack and the execution stack to the
+ * worklist
+ */
+static void pushStackReferences(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -138,35 +165,49 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished adding execution stack");
+}
 
-	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
-	uint heapSize = heap.size();
-
-	for (uint i = 1; i < heapSize; i++) {
-		if (heap[i]) {
-			// Init: Explicitly loaded scripts
-			if (heap[i]->getType() == SEG_TYPE_SCRIPT) {
-				Script *script = (Script *)heap[i];
+/**
+ * Adds the objects of a segment which are always in use to the worklist:
+ * the ones of explicitly loaded scripts, and the bitmaps which opted out of
+ * garbage collection
+ */
+static void pushSegmentRoots(SegmentObj *mobj, SegmentId seg, WorklistManager &wm) {
+	// Init: Explicitly loaded scripts
+	if (mobj->getType() == SEG_TYPE_SCRIPT) {
+		Script *script = (Script *)mobj;
 
-				if (script->getLockers()) { // Explicitly loaded?
-					wm.pushArray(script->listObjectReferences());
-				}
-			}
+		if (script->getLockers()) { // Explicitly loaded?
+			wm.pushArray(script->listObjectReferences());
+		}
+	}
 
 #ifdef ENABLE_SCI32
-			// Init: Explicitly opted-out bitmaps
-			else if (heap[i]->getType() == SEG_TYPE_BITMAP) {
-				BitmapTable *bt = static_cast<BitmapTable *>(heap[i]);
-
-				for (uint j = 0; j < bt->_table.size(); j++) {
-					if (bt->_table[j].data && bt->_table[j].data->getShouldGC() == false) {
-						wm.push(make_reg(i, j));
-					}
-				}
+	// Init: Explicitly opted-out bitmaps
+	else if (mobj->getType() == SEG_TYPE_BITMAP) {
+		BitmapTable *bt = static_cast<BitmapTable *>(mobj);
+
+		for (uint j = 0; j < bt->_table.size(); j++) {
+			if (bt->_table[j].data && bt->_table[j].data->getShouldGC() == false) {
+				wm.push(make_reg(seg, j));
 			}
-#endif
 		}
 	}
+#endif
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushStackReferences(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+	uint heapSize = heap.size();
+
+	for (uint i = 1; i < heapSize; i++) {
+		if (heap[i])
+			pushSegmentRoots(heap[i], i, wm);
+	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
 
@@ -180,6 +221,11 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint64 start = g_system->getMicros();
+	uint32 freed = 0;
+
+	// This collection replaces the one in progress
+	s->_gc->cancel();
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -213,6 +259,7 @@ void run_gc(EngineState *s) {
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -232,6 +279,193 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	s->_gc->addFullCollection(g_system->getMicros() - start, freed);
+}
+
+#pragma mark -
+
+// The amount of work done by each step of an incremental collection
+enum {
+	kGCRootSegments = 64,		///< Segments to gather references from
+	kGCMarkReferences = 256,	///< References to follow
+	kGCSweepEntries = 1024		///< Entries to check, in whole segments
+};
+
+void GCStats::reset() {
+	fullCollections = 0;
+	cycles = 0;
+	steps = 0;
+	lastPause = 0;
+	lastSteps = 0;
+	maxPause = 0;
+	totalTime = 0;
+	lastMarked = 0;
+	lastFreed = 0;
+	totalFreed = 0;
+}
+
+IncrementalGC::IncrementalGC() :
+	_phase(kPhaseIdle),
+	_segMan(nullptr),
+	_activeRefs(nullptr),
+	_segment(0),
+	_cycleSteps(0),
+	_cyclePause(0),
+	_cycleFreed(0) {
+}
+
+IncrementalGC::~IncrementalGC() {
+	// The segment manager may already be gone
+	delete _activeRefs;
+}
+
+void IncrementalGC::step(EngineState *s) {
+	const uint64 start = g_system->getMicros();
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+
+	switch (_phase) {
+	case kPhaseIdle:
+		debugC(kDebugLevelGC, "[GC] Starting an incremental collection");
+		_segMan = s->_segMan;
+		_segMan->setIncrementalGC(this);
+		_segment = 1;
+		_cycleSteps = 0;
+		_cyclePause = 0;
+		_cycleFreed = 0;
+		_phase = kPhaseRoots;
+		// fall through
+
+	case kPhaseRoots: {
+		const uint end = MIN<uint>(_segment + kGCRootSegments, heap.size());
+		for (; _segment < end; _segment++) {
+			if (heap[_segment])
+				pushSegmentRoots(heap[_segment], _segment, _wm);
+		}
+		if (_segment >= heap.size())
+			_phase = kPhaseMark;
+		break;
+	}
+
+	case kPhaseMark:
+		if (!_wm._worklist.empty())
+			processWorkList(_segMan, _wm, heap, kGCMarkReferences, true);
+		else
+			finishMarking(s);
+		break;
+
+	case kPhaseSweep: {
+		uint entries = 0;
+		for (; _segment < heap.size() && entries < kGCSweepEntries; _segment++) {
+			SegmentObj *mobj = heap[_segment];
+			if (!mobj)
+				continue;
+
+			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(_segment);
+			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+				const reg_t addr = *it;
+				if (!_activeRefs->contains(addr)) {
+					mobj->freeAtAddress(_segMan, addr);
+					_cycleFreed++;
+					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+				}
+			}
+			entries += tmp.size() + 1;
+		}
+		break;
+	}
+	}
+
+	const uint32 pause = g_system->getMicros() - start;
+	_cyclePause = MAX(_cyclePause, pause);
+	_cycleSteps++;
+	_stats.steps++;
+	_stats.totalTime += pause;
+
+	if (_phase == kPhaseSweep && _segment >= heap.size())
+		end();
+}
+
+void IncrementalGC::finishMarking(EngineState *s) {
+	const Common::Array<SegmentObj *> &heap = _segMan->getSegments();
+
+	// The registers and the stacks change all the time, so they are only
+	// added now, along with the scripts which were loaded in the meantime
+	pushStackReferences(s, _wm);
+	for (uint i = 1; i < heap.size(); i++) {
+		if (heap[i])
+			pushSegmentRoots(heap[i], i, _wm);
+	}
+
+	processWorkList(_segMan, _wm, heap, 0, true);
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+
+	_activeRefs = normalizeAddresses(_segMan, _wm._map);
+	_stats.lastMarked = _activeRefs->size();
+	_wm._map.clear();
+	_wm._worklist.clear();
+
+	debugC(kDebugLevelGC, "[GC] Marking done, %d references found", _stats.lastMarked);
+	_segment = 1;
+	_phase = kPhaseSweep;
+}
+
+void IncrementalGC::end() {
+	debugC(kDebugLevelGC, "[GC] Incremental collection done, %d entries freed", _cycleFreed);
+
+	_stats.cycles++;
+	_stats.lastPause = _cyclePause;
+	_stats.lastSteps = _cycleSteps;
+	_stats.maxPause = MAX(_stats.maxPause, _cyclePause);
+	_stats.lastFreed = _cycleFreed;
+	_stats.totalFreed += _cycleFreed;
+
+	cancel();
+}
+
+void IncrementalGC::cancel() {
+	if (_segMan)
+		_segMan->setIncrementalGC(nullptr);
+	_segMan = nullptr;
+
+	_wm._map.clear();
+	_wm._worklist.clear();
+	delete _activeRefs;
+	_activeRefs = nullptr;
+	_phase = kPhaseIdle;
+}
+
+void IncrementalGC::shade(reg_t reg) {
+	if (_phase == kPhaseRoots || _phase == kPhaseMark)
+		_wm.push(reg);
+}
+
+void IncrementalGC::rescan(reg_t reg) {
+	if (_phase == kPhaseRoots || _phase == kPhaseMark)
+		_wm.rescan(reg);
+}
+
+void IncrementalGC::allocated(reg_t addr) {
+	if (_phase == kPhaseSweep) {
+		// New entries are canonical addresses
+		_activeRefs->setVal(addr, true);
+	} else {
+		// Scanned later, so that the references stored into it before
+		// the next step are found
+		_wm.rescan(addr);
+	}
+}
+
+void IncrementalGC::addFullCollection(uint32 pause, uint32 freed) {
+	_stats.fullCollections++;
+	_stats.lastPause = pause;
+	_stats.lastSteps = 1;
+	_stats.maxPause = MAX(_stats.maxPause, pause);
+	_stats.totalTime += pause;
+	_stats.lastFreed = freed;
+	_stats.totalFreed += freed;
 }
 
 } // End of namespace Sci
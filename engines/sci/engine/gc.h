@@ -60,6 +60,88 @@ struct WorklistManager {
 
 	void push(reg_t reg);
 	void pushArray(const Common::Array<reg_t> &tmp);
+	/** Adds a reference to scan again, even if it was already dealt with */
+	void rescan(reg_t reg);
+};
+
+/** Statistics about the garbage collections, shown by the gc_stats console command */
+struct GCStats {
+	uint32 fullCollections;	///< Number of collections run at once
+	uint32 cycles;			///< Number of collections run in steps
+	uint32 steps;			///< Number of steps of these collections
+	uint32 lastPause;		///< Longest pause of the last collection, in microseconds
+	uint32 lastSteps;		///< Number of steps of the last collection
+	uint32 maxPause;		///< Longest pause of all collections, in microseconds
+	uint64 totalTime;		///< Time spent in all collections, in microseconds
+	uint32 lastMarked;		///< Number of references found by the last collection
+	uint32 lastFreed;		///< Number of entries freed by the last collection
+	uint32 totalFreed;		///< Number of entries freed by all collections
+
+	GCStats() { reset(); }
+	void reset();
+};
+
+/**
+ * A garbage collection run in steps before kernel calls, so that games with
+ * large heaps don't stop for the whole collection.
+ *
+ * The references are first gathered from the scripts, and followed a few
+ * at a time. Meanwhile, the SegManager reports the references stored into
+ * objects, locals, lists and arrays (its write barrier), and the entries it
+ * allocates. The last marking step adds the registers and the stacks, which
+ * change all the time, and follows the remaining references at once. The
+ * entries which weren't found are then freed a few segments at a time.
+ */
+class IncrementalGC {
+public:
+	IncrementalGC();
+	~IncrementalGC();
+
+	/** Whether a collection is in progress */
+	bool isRunning() const { return _phase != kPhaseIdle; }
+
+	/**
+	 * Runs the next step of the collection, starting a new one if none is
+	 * in progress
+	 */
+	void step(EngineState *s);
+
+	/** Stops the collection in progress, without freeing anything */
+	void cancel();
+
+	/** Adds a reference stored into the heap while marking */
+	void shade(reg_t reg);
+	/** Adds an object whose references changed while marking */
+	void rescan(reg_t reg);
+	/** Keeps an entry allocated during the collection */
+	void allocated(reg_t addr);
+
+	GCStats &getStats() { return _stats; }
+
+	/** Records a collection run at once */
+	void addFullCollection(uint32 pause, uint32 freed);
+
+private:
+	enum Phase {
+		kPhaseIdle,
+		kPhaseRoots,	///< Gathering the references from the scripts
+		kPhaseMark,		///< Following the references
+		kPhaseSweep		///< Freeing the entries which weren't found
+	};
+
+	void finishMarking(EngineState *s);
+	void end();
+
+	Phase _phase;
+	SegManager *_segMan;
+	WorklistManager _wm;
+	AddrSet *_activeRefs;	///< The normalized references, while sweeping
+	uint _segment;			///< The next segment to gather references from or to sweep
+	uint32 _cycleSteps;
+	uint32 _cyclePause;
+	uint32 _cycleFreed;
+
+	GCStats _stats;
 };
 
 
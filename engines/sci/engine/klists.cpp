@@ -207,6 +207,9 @@ static void addToFront(EngineState *s, reg_t listRef, reg_t nodeRef) {
 	checkListPointer(s->_segMan, listRef);
 #endif
 
+	s->_segMan->gcWriteBarrier(list->first);
+	s->_segMan->gcWriteBarrier(nodeRef);
+
 	newNode->pred = NULL_REG;
 	newNode->succ = list->first;
 
@@ -233,6 +236,9 @@ static void addToEnd(EngineState *s, reg_t listRef, reg_t nodeRef) {
 	checkListPointer(s->_segMan, listRef);
 #endif
 
+	s->_segMan->gcWriteBarrier(list->last);
+	s->_segMan->gcWriteBarrier(nodeRef);
+
 	newNode->pred = list->last;
 	newNode->succ = NULL_REG;
 
@@ -323,6 +329,7 @@ reg_t kAddAfter(EngineState *s, int argc, reg_t *argv) {
 
 	if (firstNode) { // We're really appending after
 		const reg_t oldNext = firstNode->succ;
+		s->_segMan->gcWriteBarrier(oldNext);
 
 		newNode->pred = argv[1];
 		firstNode->succ = argv[2];
@@ -365,6 +372,7 @@ reg_t kAddBefore(EngineState *s, int argc, reg_t *argv) {
 
 	if (firstNode) { // We're really appending before
 		const reg_t oldPred = firstNode->pred;
+		s->_segMan->gcWriteBarrier(oldPred);
 
 		newNode->succ = argv[1];
 		firstNode->pred = argv[2];
@@ -430,6 +438,9 @@ reg_t kDeleteKey(EngineState *s, int argc, reg_t *argv) {
 	}
 #endif
 
+	s->_segMan->gcWriteBarrier(n->succ);
+	s->_segMan->gcWriteBarrier(n->pred);
+
 	if (list->first == node_pos)
 		list->first = n->succ;
 	if (list->last == node_pos)
@@ -881,6 +892,7 @@ reg_t kArrayCopy(EngineState *s, int argc, reg_t *argv) {
 		target.copy(source, sourceIndex, targetIndex, count);
 	} else {
 		target.copy(*s->_segMan->lookupArray(argv[2]), sourceIndex, targetIndex, count);
+		s->_segMan->gcRescan(argv[0]);
 	}
 
 	return argv[0];
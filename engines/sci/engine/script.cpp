@@ -74,6 +74,71 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructionIndex.clear();
+	_instructions.clear();
+}
+
+bool Script::_instructionCache = true;
+
+const PMachineInstruction &Script::decodeInstruction(uint32 offset) {
+	PMachineInstruction instruction;
+	byte extOpcode;
+	const int size = readPMachineInstruction(getBuf(offset), extOpcode, instruction.opparams);
+	instruction.extOpcode = extOpcode;
+	instruction.size = size;
+	instruction.superOpcode = 0;
+	instruction.nextSize = 0;
+	instruction.nextParam = 0;
+	instruction.lofsOffset = 0;
+	instruction.propertyIndex = -1;
+
+	// The instructions of the superinstructions are at most 3 bytes long
+	if (_instructionCache && offset + size + 3 <= getBufSize()) {
+		const byte superOpcode = getSuperOpcode(extOpcode >> 1, *getBuf(offset + size) >> 1);
+		if (superOpcode) {
+			byte nextExtOpcode;
+			int16 nextParams[4];
+			instruction.superOpcode = superOpcode;
+			instruction.nextSize = readPMachineInstruction(getBuf(offset + size), nextExtOpcode, nextParams);
+			instruction.nextParam = nextParams[0];
+		}
+	}
+
+	switch (extOpcode >> 1) {
+	case op_lofsa:
+	case op_lofss:
+		instruction.lofsOffset = findOffset(instruction.opparams[0], this, offset + size);
+		break;
+	case op_pToa:
+	case op_aTop:
+	case op_pTos:
+	case op_sTop:
+	case op_ipToa:
+	case op_dpToa:
+	case op_ipTos:
+	case op_dpTos:
+		// SCI3 properties are found by selector in each object, by the VM
+		if (getSciVersion() != SCI_VERSION_3)
+			instruction.propertyIndex = instruction.opparams[0] >> 1;
+		break;
+	default:
+		break;
+	}
+
+	// Debug instructions with a file name, and the rest of the very large
+	// SCI3 scripts, are decoded every time
+	if (!_instructionCache || size > 0xFF || _instructions.size() >= 0xFFFF || offset >= getBufSize()) {
+		instruction.superOpcode = 0;
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(getBufSize());
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
 }
 
 enum {
@@ -68,6 +68,22 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * An instruction decoded by readPMachineInstruction(), which the script keeps
+ * with its resolved operands so that the VM doesn't work them out again
+ * whenever it runs.
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint32 lofsOffset; ///< The offset loaded by lofsa and lofss, see findOffset()
+	mutable int propertyIndex; ///< The property of the property opcodes, the last one found in SCI3
+	byte extOpcode;
+	byte size;
+	byte superOpcode; ///< The superinstruction running this one and the next, or 0, see getSuperOpcode()
+	byte nextSize;    ///< The size of the next instruction, if there is a superinstruction
+	int16 nextParam;  ///< The first parameter of the next instruction, if there is a superinstruction
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -93,6 +109,14 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For each offset of the buffer, the index + 1 in _instructions of the
+	 * instruction at this offset, or 0 if it wasn't decoded yet
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	PMachineInstruction _uncachedInstruction; /**< An instruction too long to keep */
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -131,6 +155,36 @@ public:
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 	}
 
+	/**
+	 * Returns the instruction at the given offset, which is decoded the first
+	 * time only. The code of a script doesn't change once it is loaded.
+	 * @param offset	The offset of the instruction
+	 * @return The instruction, valid until the next call
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset) {
+		if (_instructionCache && offset < _instructionIndex.size() && _instructionIndex[offset])
+			return _instructions[_instructionIndex[offset] - 1];
+		return decodeInstruction(offset);
+	}
+
+	/**
+	 * Returns the number of instructions decoded so far.
+	 */
+	uint getInstructionCount() const { return _instructions.size(); }
+
+	/**
+	 * Sets whether the scripts keep their decoded instructions. Otherwise,
+	 * instructions are decoded every time, without superinstructions. This
+	 * is meant for comparing both in the vm_bench console command.
+	 */
+	static void setInstructionCache(bool enable) { _instructionCache = enable; }
+	static bool getInstructionCache() { return _instructionCache; }
+
+private:
+	const PMachineInstruction &decodeInstruction(uint32 offset);
+
+	static bool _instructionCache;
+
 public:
 	Script();
 	~Script() override;
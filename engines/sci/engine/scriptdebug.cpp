@@ -450,6 +450,16 @@ bool isJumpOpcode(EngineState *s, reg_t pos, reg_t& jumpTarget) {
 
 void SciEngine::scriptDebug() {
 	EngineState *s = _gamestate;
+	if (_debugState.recordingSteps) {
+		_debugState.recordedSteps.push_back(s->xs->addr.pc);
+		if (--_debugState.recordingSteps)
+			return;
+
+		_debugState.debugging = false;
+		_console->attach("Recorded the executed instructions, replay them with vm_bench\n");
+		return;
+	}
+
 	if (_debugState.seeking && !_debugState.breakpointWasHit) { // Are we looking for something special?
 		if (_debugState.seeking == kDebugSeekStepOver) {
 			// are we above seek-level? resume then
@@ -21,6 +21,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/seg_manager.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
 #ifdef ENABLE_SCI32
@@ -31,7 +32,7 @@ namespace Sci {
 
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
-	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	: _resMan(resMan), _scriptPatcher(scriptPatcher), _gc(nullptr) {
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -55,6 +56,10 @@ SegManager::~SegManager() {
 }
 
 void SegManager::resetSegMan() {
+	// The collection in progress knows nothing about the new segments
+	if (_gc)
+		_gc->cancel();
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -122,10 +127,25 @@ SegmentId SegManager::allocSegment(SegmentObj *mobj) {
 		_heap.push_back(0);
 	}
 	_heap[id] = mobj;
+	gcAllocated(make_reg(id, 0));
 
 	return id;
 }
 
+void SegManager::gcShade(reg_t value) {
+	_gc->shade(value);
+}
+
+void SegManager::gcRescan(reg_t addr) {
+	if (_gc)
+		_gc->rescan(addr);
+}
+
+void SegManager::gcAllocated(reg_t addr) {
+	if (_gc)
+		_gc->allocated(addr);
+}
+
 Script *SegManager::allocateScript(int script_nr, SegmentId &segid) {
 	// Check if the script already has an allocated segment. If it
 	// does, return that segment.
@@ -461,6 +481,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	int offset = table->allocEntry();
 
 	reg_t addr = make_reg(_hunksSegId, offset);
+	gcAllocated(addr);
 	Hunk &h = table->at(offset);
 
 	h.mem = malloc(size);
@@ -494,6 +515,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	gcAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -510,6 +532,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	gcAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -526,6 +549,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	gcAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -952,6 +976,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	gcAllocated(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -1008,6 +1033,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	gcAllocated(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
@@ -44,6 +44,7 @@ enum ScriptLoadType {
 };
 
 class Script;
+class IncrementalGC;
 
 class SegManager : public Common::Serializable {
 	friend class Console;
@@ -460,7 +461,34 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Sets the incremental garbage collection in progress, which needs to
+	 * know about the references stored into the heap and the new entries.
+	 * @param gc	The collection, or nullptr once it is done
+	 */
+	void setIncrementalGC(IncrementalGC *gc) { _gc = gc; }
+
+	/**
+	 * Write barrier of the incremental garbage collection, to call when
+	 * storing a reference into an object, a list, a node or local variables.
+	 * @param value	The stored value
+	 */
+	void gcWriteBarrier(reg_t value) {
+		if (_gc && value.getSegment())
+			gcShade(value);
+	}
+
+	/**
+	 * Tells the incremental garbage collection that many references of an
+	 * entry changed at once, like when copying into an array.
+	 * @param addr	The address of the entry
+	 */
+	void gcRescan(reg_t addr);
+
 private:
+	void gcShade(reg_t value);
+	void gcAllocated(reg_t addr);
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
@@ -468,6 +496,7 @@ private:
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
+	IncrementalGC *_gc; ///< The garbage collection in progress, if any
 
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
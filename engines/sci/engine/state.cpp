@@ -24,6 +24,7 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/features.h"
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -68,6 +69,8 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
+	_gc(new IncrementalGC()),
+	incrementalGC(true),
 	_msgState(nullptr),
 	_dirseeker() {
 
@@ -75,6 +78,7 @@ EngineState::EngineState(SegManager *segMan) :
 }
 
 EngineState::~EngineState() {
+	delete _gc;
 	delete _msgState;
 }
 
@@ -104,6 +108,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	_gc->cancel();
 
 	_eventCounter = 0;
 	_paletteSetIntensityCounter = 0;
@@ -44,6 +44,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+class IncrementalGC;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -188,6 +189,8 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	IncrementalGC *_gc; /**< Collects garbage in steps between kernel calls */
+	bool incrementalGC; /**< Whether gcs run in steps rather than all at once */
 
 	MessageState *_msgState;
 	void initMessageState();
@@ -60,11 +60,6 @@ static reg_t &validate_property(EngineState *s, Object *obj, int index) {
 	if (!obj)
 		error("validate_property: Sending to disposed object");
 
-	if (getSciVersion() == SCI_VERSION_3)
-		index = obj->locateVarSelector(s->_segMan, index);
-	else
-		index >>= 1;
-
 	// Validate the property index. SSCI does no validation; it just adds the offset
 	// to the object's address. If a script contains an invalid offset, usually due
 	// to the script compiler accepting an invalid property symbol, then OOB memory
@@ -80,6 +75,19 @@ static reg_t &validate_property(EngineState *s, Object *obj, int index) {
 	return obj->getVariableRef(index);
 }
 
+static reg_t &validate_property(EngineState *s, Object *obj, const PMachineInstruction &instruction) {
+	// Objects of the same class have their properties in the same order, so
+	// the SCI3 property selector is usually found where it was the last time
+	int index = instruction.propertyIndex;
+	if (obj && getSciVersion() == SCI_VERSION_3 &&
+		(index < 0 || (uint)index >= obj->getVarCount() || obj->getVarSelector(index) != instruction.opparams[0])) {
+		index = obj->locateVarSelector(s->_segMan, instruction.opparams[0]);
+		instruction.propertyIndex = index;
+	}
+
+	return validate_property(s, obj, index);
+}
+
 static StackPtr validate_stack_addr(EngineState *s, StackPtr sp) {
 	if (sp >= s->stack_base && sp < s->stack_top)
 		return sp;
@@ -174,6 +182,8 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 			value.setSegment(0);
 
 		s->variables[type][index] = value;
+		if (type == VAR_GLOBAL || type == VAR_LOCAL)
+			s->_segMan->gcWriteBarrier(value);
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
@@ -223,6 +233,7 @@ static void _exec_varselectors(EngineState *s) {
 			// varselector access?
 			if (xs.argc) { // write?
 				*var = xs.variables_argp[1];
+				s->_segMan->gcWriteBarrier(*var);
 
 #ifdef ENABLE_SCI32
 				updateInfoFlagViewVisible(s->_segMan->getObject(xs.addr.varp.obj), xs.addr.varp.varindex);
@@ -514,6 +525,22 @@ int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4])
 	return offset;
 }
 
+byte getSuperOpcode(byte opcode, byte nextOpcode) {
+	switch (opcode) {
+	case op_lofsa:
+		return nextOpcode == op_send ? op_lofsa_send : 0;
+	case op_ldi:
+		// SCI3 properties are found by selector in each object
+		return nextOpcode == op_aTop && getSciVersion() != SCI_VERSION_3 ? op_ldi_aTop : 0;
+	case op_pushi:
+		if (nextOpcode == op_pushi)
+			return op_pushi_pushi;
+		return nextOpcode == op_push0 ? op_pushi_push0 : 0;
+	default:
+		return 0;
+	}
+}
+
 uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffset) {
 	uint32 offset;
 
@@ -625,9 +652,18 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
-		const byte opcode = extOpcode >> 1;
+		const PMachineInstruction *instruction = &scr->getInstruction(s->xs->addr.pc.getOffset());
+
+		// Copied, since running the instruction may decode others
+		memcpy(opparams, instruction->opparams, sizeof(opparams));
+		const byte extOpcode = instruction->extOpcode;
+		s->xs->addr.pc.incOffset(instruction->size);
+		byte opcode = extOpcode >> 1;
+
+		// Superinstructions run two instructions at once, so they aren't
+		// used while the debugger has to see every instruction
+		if (instruction->superOpcode && !g_sci->_debugState.debugging && !g_sci->_debugState._activeBreakpointTypes)
+			opcode = instruction->superOpcode;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -852,9 +888,14 @@ void run_vm(EngineState *s) {
 
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
+			if (s->_gc->isRunning()) {
+				s->_gc->step(s);
+			} else if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->incrementalGC)
+					s->_gc->step(s);
+				else
+					run_gc(s);
 			}
 
 			// Call kernel function
@@ -869,6 +910,12 @@ void run_vm(EngineState *s) {
 			if (!oldScriptHeader)
 				argc += s->r_rest;
 
+			// The kernel function may store its arguments into the heap
+			if (s->_gc->isRunning()) {
+				for (int i = 1; i <= argc; i++)
+					s->_segMan->gcWriteBarrier(s->xs->sp[i]);
+			}
+
 			callKernelFunc(s, opparams[0], argc);
 
 			if (!oldScriptHeader)
@@ -935,6 +982,7 @@ void run_vm(EngineState *s) {
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
 						*var = old_xs->variables_argp[1];
+						s->_segMan->gcWriteBarrier(*var);
 
 #ifdef ENABLE_SCI32
 						updateInfoFlagViewVisible(s->_segMan->getObject(old_xs->addr.varp.obj), old_xs->addr.varp.varindex);
@@ -961,6 +1009,23 @@ void run_vm(EngineState *s) {
 
 			break;
 
+		case op_lofsa_send:
+			// Load offset to accumulator, like lofsa, then send to it
+			r_temp.setSegment(s->xs->addr.pc.getSegment());
+			if (local_script == scr)
+				r_temp.setOffset(instruction->lofsOffset);
+			else
+				r_temp.setOffset(findOffset(opparams[0], local_script, s->xs->addr.pc.getOffset()));
+			if (r_temp.getOffset() >= scr->getBufSize())
+				error("VM: lofsa/lofss operation overflowed: %04x:%04x beyond end"
+						  " of script (at %04x)", PRINT_REG(r_temp), scr->getBufSize());
+			s->r_acc = r_temp;
+
+			s->xs->addr.pc.incOffset(instruction->nextSize);
+			opparams[0] = instruction->nextParam;
+			++s->scriptStepCounter;
+			// fall through
+
 		case op_send: // 0x25 (37)
 			// Send for one or more selectors
 			s_temp = s->xs->sp;
@@ -1101,19 +1166,22 @@ void run_vm(EngineState *s) {
 			break;
 
 		case op_pToa: // 0x31 (49)
+			{
 			// Property To Accumulator
+			reg_t &opProperty = validate_property(s, obj, *instruction);
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORREAD) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
-				                    validate_property(s, obj, opparams[0]), NULL_REG,
+				                    opProperty, NULL_REG,
 				                    s->_segMan, BREAK_SELECTORREAD);
 			}
-			s->r_acc = validate_property(s, obj, opparams[0]);
+			s->r_acc = opProperty;
 			break;
+		}
 
 		case op_aTop: // 0x32 (50)
 			{
 			// Accumulator To Property
-			reg_t &opProperty = validate_property(s, obj, opparams[0]);
+			reg_t &opProperty = validate_property(s, obj, *instruction);
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
 				                    opProperty, s->r_acc,
@@ -1121,6 +1189,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->gcWriteBarrier(s->r_acc);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1130,7 +1199,7 @@ void run_vm(EngineState *s) {
 		case op_pTos: // 0x33 (51)
 			{
 			// Property To Stack
-			reg_t value = validate_property(s, obj, opparams[0]);
+			reg_t value = validate_property(s, obj, *instruction);
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORREAD) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
 				                    value, NULL_REG,
@@ -1144,13 +1213,14 @@ void run_vm(EngineState *s) {
 			{
 			// Stack To Property
 			reg_t newValue = POP32();
-			reg_t &opProperty = validate_property(s, obj, opparams[0]);
+			reg_t &opProperty = validate_property(s, obj, *instruction);
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
 				                    opProperty, newValue,
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->gcWriteBarrier(newValue);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1164,7 +1234,7 @@ void run_vm(EngineState *s) {
 			{
 			// Increment/decrement a property and copy to accumulator,
 			// or push to stack
-			reg_t &opProperty = validate_property(s, obj, opparams[0]);
+			reg_t &opProperty = validate_property(s, obj, *instruction);
 			reg_t oldValue = opProperty;
 
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORREAD) {
@@ -1199,7 +1269,10 @@ void run_vm(EngineState *s) {
 			// Load offset to accumulator or push to stack
 
 			r_temp.setSegment(s->xs->addr.pc.getSegment());
-			r_temp.setOffset(findOffset(opparams[0], local_script, s->xs->addr.pc.getOffset()));
+			if (local_script == scr)
+				r_temp.setOffset(instruction->lofsOffset);
+			else
+				r_temp.setOffset(findOffset(opparams[0], local_script, s->xs->addr.pc.getOffset()));
 			if (r_temp.getOffset() >= scr->getBufSize())
 				error("VM: lofsa/lofss operation overflowed: %04x:%04x beyond end"
 						  " of script (at %04x)", PRINT_REG(r_temp), scr->getBufSize());
@@ -1382,6 +1455,31 @@ void run_vm(EngineState *s) {
 			write_var(s, var_type, var_number, r_temp);
 			break;
 
+		case op_ldi_aTop:
+			// Load data immediate, then store it in a property
+			s->r_acc = make_reg(0, opparams[0]);
+			validate_property(s, obj, instruction->nextParam >> 1) = s->r_acc;
+#ifdef ENABLE_SCI32
+			updateInfoFlagViewVisible(obj, instruction->nextParam, true);
+#endif
+			s->xs->addr.pc.incOffset(instruction->nextSize);
+			++s->scriptStepCounter;
+			break;
+
+		case op_pushi_pushi:
+			PUSH(opparams[0]);
+			PUSH(instruction->nextParam);
+			s->xs->addr.pc.incOffset(instruction->nextSize);
+			++s->scriptStepCounter;
+			break;
+
+		case op_pushi_push0:
+			PUSH(opparams[0]);
+			PUSH(0);
+			s->xs->addr.pc.incOffset(instruction->nextSize);
+			++s->scriptStepCounter;
+			break;
+
 		default:
 			error("run_vm(): illegal opcode %x", opcode);
 
@@ -328,6 +328,18 @@ enum SciOpcodes {
 	op_minusspi = 0x7f	// 127
 };
 
+/**
+ * Superinstructions, which run two instructions that often follow each other
+ * in one step of the VM. They aren't part of the scripts: the VM runs them in
+ * place of the first instruction of the pair, see getSuperOpcode().
+ */
+enum SciSuperOpcodes {
+	op_lofsa_send  = 0x80,	// lofsa, then send to the object
+	op_ldi_aTop    = 0x81,	// ldi, then store it in a property
+	op_pushi_pushi = 0x82,	// pushi twice, e.g. a selector and its parameter count
+	op_pushi_push0 = 0x83	// pushi, then push0, e.g. a selector without parameters
+};
+
 void script_adjust_opcode_formats();
 
 /**
@@ -416,6 +428,15 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * Finds the superinstruction which runs the given pair of instructions.
+ *
+ * @param[in] opcode		the opcode of the first instruction
+ * @param[in] nextOpcode	the opcode of the instruction after it
+ * @return the superinstruction, or 0 if there is none for this pair
+ */
+byte getSuperOpcode(byte opcode, byte nextOpcode);
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
@@ -1263,7 +1263,7 @@ bool AdGame::scSetProperty(const char *name, ScValue *value) {
 
 
 //////////////////////////////////////////////////////////////////////////
-bool AdGame::externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, char *name) {
+bool AdGame::externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, const char *name) {
 	ScValue *thisObj;
 
 	//////////////////////////////////////////////////////////////////////////
@@ -153,7 +153,7 @@ public:
 	bool loadItemsFile(const char *filename, bool merge = false);
 	bool loadItemsBuffer(char *buffer, bool merge = false);
 
-	bool externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, char *name) override;
+	bool externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, const char *name) override;
 
 	// scripting interface
 	ScValue *scGetProperty(const char *name) override;
@@ -28,6 +28,7 @@
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_engine.h"
+#include "engines/wintermute/base/scriptables/script_names.h"
 #include "engines/wintermute/wintermute.h"
 #include "engines/wintermute/system/sys_class_registry.h"
 #include "engines/wintermute/platform_osystem.h"
@@ -44,6 +45,7 @@ BaseEngine::BaseEngine() {
 	_fileManager = nullptr;
 	_gameRef = nullptr;
 	_classReg = nullptr;
+	_nameTable = nullptr;
 	_rnd = nullptr;
 	_gameId = "";
 	_language = Common::UNK_LANG;
@@ -57,12 +59,14 @@ void BaseEngine::init() {
 	_rnd = new Common::RandomSource("Wintermute");
 	_classReg = new SystemClassRegistry();
 	_classReg->registerClasses();
+	_nameTable = new ScNameTable();
 }
 
 BaseEngine::~BaseEngine() {
 	delete _fileManager;
 	delete _rnd;
 	delete _classReg;
+	delete _nameTable;
 }
 
 void BaseEngine::createInstance(const Common::String &targetName, const Common::String &gameId, Common::Language lang, WMETargetExecutable targetExecutable, uint32 flags) {
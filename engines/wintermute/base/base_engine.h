@@ -43,6 +43,7 @@ class BaseGame;
 class BaseSoundMgr;
 class BaseRenderer;
 class SystemClassRegistry;
+class ScNameTable;
 class Timer;
 class BaseEngine : public Common::Singleton<Wintermute::BaseEngine> {
 	void init();
@@ -53,6 +54,7 @@ class BaseEngine : public Common::Singleton<Wintermute::BaseEngine> {
 	// We need random numbers
 	Common::RandomSource *_rnd;
 	SystemClassRegistry *_classReg;
+	ScNameTable *_nameTable;
 	Common::Language _language;
 	WMETargetExecutable _targetExecutable;
 	uint32 _flags;
@@ -67,6 +69,7 @@ public:
 	uint32 randInt(int from, int to);
 
 	SystemClassRegistry *getClassRegistry() { return _classReg; }
+	ScNameTable *getNameTable() { return _nameTable; }
 	BaseGame *getGameRef() { return _gameRef; }
 	BaseFileManager *getFileManager() { return _fileManager; }
 	BaseSoundMgr *getSoundMgr();
@@ -3824,7 +3824,7 @@ bool BaseGame::validObject(BaseObject *object) {
 }
 
 //////////////////////////////////////////////////////////////////////////
-bool BaseGame::externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, char *name) {
+bool BaseGame::externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, const char *name) {
 	ScValue *thisObj;
 
 	//////////////////////////////////////////////////////////////////////////
@@ -258,7 +258,7 @@ public:
 	bool invalidateDeviceObjects() override;
 	bool restoreDeviceObjects() override;
 
-	virtual bool externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, char *name);
+	virtual bool externalCall(ScScript *script, ScStack *stack, ScStack *thisStack, const char *name);
 
 	// scripting interface
 	ScValue *scGetProperty(const char *name) override;
@@ -30,6 +30,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/scriptables/script_engine.h"
+#include "engines/wintermute/base/scriptables/script_names.h"
 #include "engines/wintermute/base/scriptables/script_stack.h"
 #include "engines/wintermute/base/gfx/base_renderer.h"
 #include "engines/wintermute/ext/externals.h"
@@ -187,11 +188,12 @@ bool ScScript::initTables() {
 	// load symbol table
 	_iP = _header.symbolTable;
 
+	ScNameTable *names = BaseEngine::instance().getNameTable();
 	_numSymbols = getDWORD();
-	_symbols = new char*[_numSymbols];
+	_symbols = new const char *[_numSymbols];
 	for (uint32 i = 0; i < _numSymbols; i++) {
 		uint32 index = getDWORD();
-		_symbols[index] = getString();
+		_symbols[index] = names->intern(getString());
 	}
 
 	// load functions table
@@ -743,7 +745,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_VAR: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getInternedVar(_symbols[getDWORD()]);
 		// Disabled in original code
 		/*if (false && var->_type==VAL_OBJECT || var->_type == VAL_NATIVE) {
 			_operand->setReference(var);
@@ -755,15 +757,15 @@ bool ScScript::executeInstruction() {
 	}
 
 	case II_PUSH_VAR_REF: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = getInternedVar(_symbols[getDWORD()]);
 		_operand->setReference(var);
 		_stack->push(_operand);
 		break;
 	}
 
 	case II_POP_VAR: {
-		char *varName = _symbols[getDWORD()];
-		ScValue *var = getVar(varName);
+		const char *varName = _symbols[getDWORD()];
+		ScValue *var = getInternedVar(varName);
 		if (var) {
 			ScValue *val = _stack->pop();
 			if (!val) {
@@ -801,7 +803,12 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_STRING:
-		_stack->pushString(getString());
+		str = getString();
+		if (strlen(str) <= ScNameTable::kMaxLiteralLength) {
+			_stack->getPushValue()->setInternedString(BaseEngine::instance().getNameTable()->intern(str));
+		} else {
+			_stack->pushString(str);
+		}
 		break;
 
 	case II_PUSH_NULL:
@@ -814,7 +821,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_THIS:
-		_operand->setReference(getVar(_symbols[getDWORD()]));
+		_operand->setReference(getInternedVar(_symbols[getDWORD()]));
 		_thisStack->push(_operand);
 		break;
 
@@ -1173,28 +1180,29 @@ uint32 ScScript::getMethodPos(const char *name) {
 
 
 //////////////////////////////////////////////////////////////////////////
-ScValue *ScScript::getVar(char *name) {
+ScValue *ScScript::getVar(const char *name) {
+	const char *internedName = BaseEngine::instance().getNameTable()->find(name);
+	return getInternedVar(internedName ? internedName : name);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::getInternedVar(const char *name) {
 	ScValue *ret = nullptr;
 
 	// scope locals
 	if (_scopeStack->_sP >= 0) {
-		if (_scopeStack->getTop()->propExists(name)) {
-			ret = _scopeStack->getTop()->getProp(name);
-		}
+		ret = _scopeStack->getTop()->getInternedProp(name);
 	}
 
 	// script globals
 	if (ret == nullptr) {
-		if (_globals->propExists(name)) {
-			ret = _globals->getProp(name);
-		}
+		ret = _globals->getInternedProp(name);
 	}
 
 	// engine globals
 	if (ret == nullptr) {
-		if (_engine->_globals->propExists(name)) {
-			ret = _engine->_globals->getProp(name);
-		}
+		ret = _engine->_globals->getInternedProp(name);
 	}
 
 	if (ret == nullptr) {
@@ -1453,7 +1461,7 @@ bool ScScript::resume() {
 
 
 //////////////////////////////////////////////////////////////////////////
-ScScript::TExternalFunction *ScScript::getExternal(char *name) {
+ScScript::TExternalFunction *ScScript::getExternal(const char *name) {
 	for (uint32 i = 0; i < _numExternals; i++) {
 		if (strcmp(name, _externals[i].name) == 0) {
 			return &_externals[i];
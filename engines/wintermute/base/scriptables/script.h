@@ -77,7 +77,9 @@ public:
 	ScScript *_waitScript;
 	TScriptState _state;
 	TScriptState _origState;
-	ScValue *getVar(char *name);
+	ScValue *getVar(const char *name);
+	/** Like getVar(), for a name returned by ScNameTable::intern() if the name was interned. */
+	ScValue *getInternedVar(const char *name);
 	uint32 getFuncPos(const char *name);
 	uint32 getEventPos(const char *name);
 	uint32 getMethodPos(const char *name);
@@ -140,7 +142,8 @@ public:
 	ScScript(BaseGame *inGame, ScEngine *engine);
 	~ScScript() override;
 	char *_filename;
-	char **_symbols;
+	/** The names of the variables, as interned by ScNameTable. */
+	const char **_symbols;
 	uint32 _numSymbols;
 	TFunctionPos *_functions;
 	TMethodPos *_methods;
@@ -154,7 +157,7 @@ public:
 	bool _methodThread;
 	char *_threadEvent;
 	BaseScriptHolder *_owner;
-	ScScript::TExternalFunction *getExternal(char *name);
+	ScScript::TExternalFunction *getExternal(const char *name);
 	bool externalCall(ScStack *stack, ScStack *thisStack, ScScript::TExternalFunction *function);
 private:
 
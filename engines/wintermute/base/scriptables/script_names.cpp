@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/wintermute/base/scriptables/script_names.h"
+
+namespace Wintermute {
+
+//////////////////////////////////////////////////////////////////////////
+int32 ScPropertyLayout::findSlot(const char *name) const {
+	if (_names.size() <= kMaxUnhashedSize) {
+		for (uint32 i = 0; i < _names.size(); i++) {
+			if (_names[i] == name) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	Common::HashMap<const char *, uint32, ScNameHash>::const_iterator it = _slots.find(name);
+	return it != _slots.end() ? (int32)it->_value : -1;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScPropertyLayout::add(const char *name) {
+	_names.push_back(name);
+
+	if (_names.size() == kMaxUnhashedSize + 1) {
+		for (uint32 i = 0; i < _names.size(); i++) {
+			_slots[_names[i]] = i;
+		}
+	} else if (_names.size() > kMaxUnhashedSize) {
+		_slots[name] = _names.size() - 1;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScPropertyLayout *ScPropertyLayout::copy(ScPropertyLayout *layout) {
+	if (layout && !layout->_shared) {
+		return new ScPropertyLayout(*layout, false);
+	}
+	return layout;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScPropertyLayout::release(ScPropertyLayout *layout) {
+	if (layout && !layout->_shared) {
+		delete layout;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScNameTable::ScNameTable() : _emptyLayout(true) {
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScNameTable::~ScNameTable() {
+	for (uint32 i = 0; i < _layouts.size(); i++) {
+		delete _layouts[i];
+	}
+
+	Common::HashMap<const char *, char *, Common::Hash<const char *>, NameEqualTo>::iterator it;
+	for (it = _names.begin(); it != _names.end(); ++it) {
+		delete[] it->_value;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+const char *ScNameTable::intern(const char *name) {
+	const char *ret = find(name);
+	if (ret) {
+		return ret;
+	}
+
+	size_t nameSize = strlen(name) + 1;
+	char *copy = new char[nameSize];
+	Common::strcpy_s(copy, nameSize, name);
+	_names[copy] = copy;
+	return copy;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+const char *ScNameTable::find(const char *name) const {
+	return _names.getValOrDefault(name);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScPropertyLayout *ScNameTable::addProperty(ScPropertyLayout *layout, const char *name) {
+	if (!layout) {
+		layout = &_emptyLayout;
+	}
+
+	if (!layout->_shared || layout->getSize() >= kMaxSharedProperties) {
+		if (layout->_shared) {
+			layout = new ScPropertyLayout(*layout, false);
+		}
+		layout->add(name);
+		return layout;
+	}
+
+	ScPropertyLayout *&next = layout->_next.getOrCreateVal(name);
+	if (!next) {
+		next = new ScPropertyLayout(*layout, true);
+		next->add(name);
+		_layouts.push_back(next);
+	}
+	return next;
+}
+
+} // End of namespace Wintermute
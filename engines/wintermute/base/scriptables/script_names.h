@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WINTERMUTE_SCNAMES_H
+#define WINTERMUTE_SCNAMES_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-ptr.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Wintermute {
+
+/**
+ * Hashes interned names by their address, as they are only compared with
+ * other interned names.
+ */
+struct ScNameHash {
+	uint operator()(const char *name) const {
+		return Common::Hash<const void *>()(name);
+	}
+};
+
+/**
+ * The names of the properties of a script value, in the order they were
+ * added, which give the slots of their values. The values which got the
+ * same properties in the same order share their layout.
+ */
+class ScPropertyLayout {
+public:
+	uint32 getSize() const { return _names.size(); }
+	const char *getName(uint32 slot) const { return _names[slot]; }
+
+	/** Returns the slot of an interned name, or -1. */
+	int32 findSlot(const char *name) const;
+
+	/** Returns the layout for a copy of a value, which is a new one if the layout isn't shared. */
+	static ScPropertyLayout *copy(ScPropertyLayout *layout);
+	/** Frees the layout of a value if it isn't shared. */
+	static void release(ScPropertyLayout *layout);
+
+private:
+	friend class ScNameTable;
+
+	enum {
+		// Smaller layouts are searched without hashing
+		kMaxUnhashedSize = 8
+	};
+
+	ScPropertyLayout(bool shared) : _shared(shared) {}
+	ScPropertyLayout(const ScPropertyLayout &layout, bool shared) : _names(layout._names), _slots(layout._slots), _shared(shared) {}
+
+	void add(const char *name);
+
+	Common::Array<const char *> _names;
+	Common::HashMap<const char *, uint32, ScNameHash> _slots;
+	/** The shared layouts which follow this one, by the name of the added property. */
+	Common::HashMap<const char *, ScPropertyLayout *, ScNameHash> _next;
+	bool _shared;
+};
+
+/**
+ * The interned property names and string literals of the scripts, and the
+ * shared property layouts.
+ */
+class ScNameTable {
+public:
+	enum {
+		// Longer string literals are usually texts, which aren't interned
+		kMaxLiteralLength = 32,
+		// Values with more properties get a layout of their own
+		kMaxSharedProperties = 32
+	};
+
+	ScNameTable();
+	~ScNameTable();
+
+	/** Returns the copy of a name which is kept by the table. */
+	const char *intern(const char *name);
+	/** Returns the copy of a name kept by the table, or nullptr if it was never interned. */
+	const char *find(const char *name) const;
+
+	/**
+	 * Returns the layout of a value after adding an interned name to its
+	 * layout, or to no layout. A layout which isn't shared is extended.
+	 */
+	ScPropertyLayout *addProperty(ScPropertyLayout *layout, const char *name);
+
+	uint32 getNumNames() const { return _names.size(); }
+	uint32 getNumLayouts() const { return _layouts.size(); }
+
+private:
+	struct NameEqualTo {
+		bool operator()(const char *x, const char *y) const { return strcmp(x, y) == 0; }
+	};
+
+	Common::HashMap<const char *, char *, Common::Hash<const char *>, NameEqualTo> _names;
+	ScPropertyLayout _emptyLayout;
+	Common::Array<ScPropertyLayout *> _layouts;
+};
+
+} // End of namespace Wintermute
+
+#endif
@@ -27,9 +27,11 @@
 
 #include "engines/wintermute/platform_osystem.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
+#include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/base/scriptables/script.h"
+#include "engines/wintermute/base/scriptables/script_names.h"
 #include "engines/wintermute/utils/string_util.h"
 #include "engines/wintermute/base/base_scriptable.h"
 
@@ -50,9 +52,11 @@ ScValue::ScValue(BaseGame *inGame) : BaseClass(inGame) {
 	_valFloat = 0.0f;
 	_valNative = nullptr;
 	_valString = nullptr;
+	_valStringInterned = false;
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propLayout = nullptr;
 }
 
 
@@ -65,9 +69,11 @@ ScValue::ScValue(BaseGame *inGame, bool val) : BaseClass(inGame) {
 	_valFloat = 0.0f;
 	_valNative = nullptr;
 	_valString = nullptr;
+	_valStringInterned = false;
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propLayout = nullptr;
 }
 
 
@@ -80,9 +86,11 @@ ScValue::ScValue(BaseGame *inGame, int32 val) : BaseClass(inGame) {
 	_valBool = false;
 	_valNative = nullptr;
 	_valString = nullptr;
+	_valStringInterned = false;
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propLayout = nullptr;
 }
 
 
@@ -95,9 +103,11 @@ ScValue::ScValue(BaseGame *inGame, double val) : BaseClass(inGame) {
 	_valBool = false;
 	_valNative = nullptr;
 	_valString = nullptr;
+	_valStringInterned = false;
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propLayout = nullptr;
 }
 
 
@@ -105,6 +115,7 @@ ScValue::ScValue(BaseGame *inGame, double val) : BaseClass(inGame) {
 ScValue::ScValue(BaseGame *inGame, const char *val) : BaseClass(inGame) {
 	_type = VAL_STRING;
 	_valString = nullptr;
+	_valStringInterned = false;
 	setStringVal(val);
 
 	_valBool = false;
@@ -114,6 +125,7 @@ ScValue::ScValue(BaseGame *inGame, const char *val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	_propLayout = nullptr;
 }
 
 
@@ -121,7 +133,7 @@ ScValue::ScValue(BaseGame *inGame, const char *val) : BaseClass(inGame) {
 void ScValue::cleanup(bool ignoreNatives) {
 	deleteProps();
 
-	if (_valString) {
+	if (_valString && !_valStringInterned) {
 		delete[] _valString;
 	}
 
@@ -142,6 +154,7 @@ void ScValue::cleanup(bool ignoreNatives) {
 	_valFloat = 0.0f;
 	_valNative = nullptr;
 	_valString = nullptr;
+	_valStringInterned = false;
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
@@ -180,24 +193,84 @@ ScValue *ScValue::getProp(const char *name) {
 	}
 
 	if (ret == nullptr) {
-		_valIter = _valObject.find(name);
-		if (_valIter != _valObject.end()) {
-			ret = _valIter->_value;
+		ScValue **val = findProp(name);
+		if (val) {
+			ret = *val;
 		}
 	}
 	return ret;
 }
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScValue::getInternedProp(const char *name) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->getInternedProp(name);
+	}
+
+	ScValue **val = findProp(name, name);
+	return val ? *val : nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScValue **ScValue::findProp(const char *name) {
+	if (!_propLayout && _dynamicProps.empty()) {
+		return nullptr;
+	}
+
+	// A name which was never interned isn't the name of any property in the layout
+	return findProp(name, BaseEngine::instance().getNameTable()->find(name));
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScValue **ScValue::findProp(const char *name, const char *internedName) {
+	if (internedName && _propLayout) {
+		int32 slot = _propLayout->findSlot(internedName);
+		if (slot >= 0) {
+			return &_propValues[slot];
+		}
+	}
+
+	// The property may also have been added before its name was interned
+	if (!_dynamicProps.empty()) {
+		Common::HashMap<Common::String, ScValue *>::iterator it = _dynamicProps.find(name);
+		if (it != _dynamicProps.end()) {
+			return &it->_value;
+		}
+	}
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *&ScValue::getPropRef(const char *name) {
+	ScNameTable *names = BaseEngine::instance().getNameTable();
+	const char *internedName = names->find(name);
+
+	ScValue **val = findProp(name, internedName);
+	if (val) {
+		return *val;
+	}
+
+	// Only the names in the scripts are interned, the ones they make up while
+	// running would fill the table
+	if (!internedName) {
+		return _dynamicProps[name];
+	}
+
+	_propLayout = names->addProperty(_propLayout, internedName);
+	_propValues.push_back(nullptr);
+	return _propValues.back();
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::deleteProp(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->deleteProp(name);
 	}
 
-	_valIter = _valObject.find(name);
-	if (_valIter != _valObject.end()) {
-		delete _valIter->_value;
-		_valIter->_value = nullptr;
+	ScValue **val = findProp(name);
+	if (val) {
+		delete *val;
+		*val = nullptr;
 	}
 
 	return STATUS_OK;
@@ -217,21 +290,16 @@ bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAs
 	}
 
 	if (DID_FAIL(ret)) {
-		ScValue *newVal = nullptr;
-
-		_valIter = _valObject.find(name);
-		if (_valIter != _valObject.end()) {
-			newVal = _valIter->_value;
-		}
-		if (!newVal) {
-			newVal = new ScValue(_game);
+		ScValue *&prop = getPropRef(name);
+		if (!prop) {
+			prop = new ScValue(_game);
 		} else {
-			newVal->cleanup();
+			prop->cleanup();
 		}
 
+		ScValue *newVal = prop;
 		newVal->copy(val, copyWhole);
 		newVal->_isConstVar = setAsConst;
-		_valObject[name] = newVal;
 
 		if (_type != VAL_NATIVE) {
 			_type = VAL_OBJECT;
@@ -261,31 +329,44 @@ bool ScValue::propExists(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
 		return _valRef->propExists(name);
 	}
-	_valIter = _valObject.find(name);
 
-	return (_valIter != _valObject.end());
+	return findProp(name) != nullptr;
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 void ScValue::deleteProps() {
-	_valIter = _valObject.begin();
-	while (_valIter != _valObject.end()) {
-		delete(ScValue *)_valIter->_value;
-		_valIter++;
+	for (uint32 i = 0; i < _propValues.size(); i++) {
+		delete _propValues[i];
 	}
-	_valObject.clear();
+	_propValues.clear();
+
+	ScPropertyLayout::release(_propLayout);
+	_propLayout = nullptr;
+
+	Common::HashMap<Common::String, ScValue *>::iterator it;
+	for (it = _dynamicProps.begin(); it != _dynamicProps.end(); ++it) {
+		delete it->_value;
+	}
+	_dynamicProps.clear();
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 void ScValue::cleanProps(bool includingNatives) {
-	_valIter = _valObject.begin();
-	while (_valIter != _valObject.end()) {
-		if (!_valIter->_value->_isConstVar && (!_valIter->_value->isNative() || includingNatives)) {
-			_valIter->_value->setNULL();
+	for (uint32 i = 0; i < _propValues.size(); i++) {
+		ScValue *val = _propValues[i];
+		if (val && !val->_isConstVar && (!val->isNative() || includingNatives)) {
+			val->setNULL();
+		}
+	}
+
+	Common::HashMap<Common::String, ScValue *>::iterator it;
+	for (it = _dynamicProps.begin(); it != _dynamicProps.end(); ++it) {
+		ScValue *val = it->_value;
+		if (val && !val->_isConstVar && (!val->isNative() || includingNatives)) {
+			val->setNULL();
 		}
-		_valIter++;
 	}
 }
 
@@ -444,9 +525,32 @@ void ScValue::setString(const Common::String &val) {
 	setString(val.c_str());
 }
 
+//////////////////////////////////////////////////////////////////////////
+void ScValue::setInternedString(const char *val) {
+	if (_type == VAL_VARIABLE_REF) {
+		_valRef->setInternedString(val);
+		return;
+	}
+
+	if (_type == VAL_NATIVE) {
+		_valNative->scSetString(val);
+		return;
+	}
+
+	if (!_valStringInterned) {
+		delete[] _valString;
+	}
+	_valString = val;
+	_valStringInterned = true;
+	_type = VAL_STRING;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void ScValue::setStringVal(const char *val) {
-	delete[] _valString;
+	if (!_valStringInterned) {
+		delete[] _valString;
+	}
+	_valStringInterned = false;
 
 	if (val == nullptr) {
 		_valString = nullptr;
@@ -454,8 +558,9 @@ void ScValue::setStringVal(const char *val) {
 	}
 
 	size_t valSize = strlen(val) + 1;
-	_valString = new char[valSize];
-	Common::strcpy_s(_valString, valSize, val);
+	char *str = new char[valSize];
+	Common::strcpy_s(str, valSize, val);
+	_valString = str;
 }
 
 
@@ -721,7 +826,12 @@ void ScValue::copy(ScValue *orig, bool copyWhole) {
 	_valBool = orig->_valBool;
 	_valInt = orig->_valInt;
 	_valFloat = orig->_valFloat;
-	setStringVal(orig->_valString);
+	if (orig->_valStringInterned) {
+		_valString = orig->_valString;
+		_valStringInterned = true;
+	} else {
+		setStringVal(orig->_valString);
+	}
 
 	_valRef = orig->_valRef;
 	_persistent = orig->_persistent;
@@ -732,16 +842,27 @@ void ScValue::copy(ScValue *orig, bool copyWhole) {
 	}
 //!!!! ref->native++
 
-	// copy properties
-	if (orig->_type == VAL_OBJECT && orig->_valObject.size() > 0) {
-		orig->_valIter = orig->_valObject.begin();
-		while (orig->_valIter != orig->_valObject.end()) {
-			_valObject[orig->_valIter->_key] = new ScValue(_game);
-			_valObject[orig->_valIter->_key]->copy(orig->_valIter->_value);
-			orig->_valIter++;
+	// copy properties, which keep the same layout
+	if (orig->_type == VAL_OBJECT && orig->_propValues.size() > 0) {
+		_propLayout = ScPropertyLayout::copy(orig->_propLayout);
+		_propValues.resize(orig->_propValues.size());
+		for (uint32 i = 0; i < orig->_propValues.size(); i++) {
+			if (orig->_propValues[i]) {
+				_propValues[i] = new ScValue(_game);
+				_propValues[i]->copy(orig->_propValues[i]);
+			}
+		}
+	}
+	if (orig->_type == VAL_OBJECT && orig->_dynamicProps.size() > 0) {
+		Common::HashMap<Common::String, ScValue *>::iterator it;
+		for (it = orig->_dynamicProps.begin(); it != orig->_dynamicProps.end(); ++it) {
+			ScValue *val = nullptr;
+			if (it->_value) {
+				val = new ScValue(_game);
+				val->copy(it->_value);
+			}
+			_dynamicProps[it->_key] = val;
 		}
-	} else {
-		_valObject.clear();
 	}
 }
 
@@ -794,30 +915,39 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 	int32 size;
 	const char *str;
 	if (persistMgr->getIsSaving()) {
-		size = _valObject.size();
+		size = _propValues.size() + _dynamicProps.size();
 		persistMgr->transferSint32("", &size);
-		_valIter = _valObject.begin();
-		while (_valIter != _valObject.end()) {
-			str = _valIter->_key.c_str();
+		for (uint32 i = 0; i < _propValues.size(); i++) {
+			str = _propLayout->getName(i);
 			persistMgr->transferConstChar("", &str);
-			persistMgr->transferPtr("", &_valIter->_value);
-
-			_valIter++;
+			persistMgr->transferPtr("", &_propValues[i]);
+		}
+		Common::HashMap<Common::String, ScValue *>::iterator it;
+		for (it = _dynamicProps.begin(); it != _dynamicProps.end(); ++it) {
+			str = it->_key.c_str();
+			persistMgr->transferConstChar("", &str);
+			persistMgr->transferPtr("", &it->_value);
 		}
 	} else {
+		_propLayout = nullptr;
+
 		ScValue *val = nullptr;
 		persistMgr->transferSint32("", &size);
 		for (int i = 0; i < size; i++) {
 			persistMgr->transferConstChar("", &str);
 			persistMgr->transferPtr("", &val);
 
-			_valObject[str] = val;
+			getPropRef(str) = val;
 			delete[] str;
 		}
 	}
 
 	persistMgr->transferPtr(TMEMBER_PTR(_valRef));
-	persistMgr->transferCharPtr(TMEMBER(_valString));
+	persistMgr->transferConstChar(TMEMBER(_valString));
+
+	if (!persistMgr->getIsSaving()) {
+		_valStringInterned = false;
+	}
 
 	if (!persistMgr->getIsSaving() && !persistMgr->checkVersion(1,2,2)) {
 		// Savegames prior to 1.2.2 stored empty strings as NULL.
@@ -825,8 +955,9 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 		// strings if _type is VAL_STRING instead of VAL_NULL.
 
 		if (_type == VAL_STRING && !_valString) {
-			_valString = new char[1];
-			_valString[0] = '\0';
+			char *emptyStr = new char[1];
+			emptyStr[0] = '\0';
+			_valString = emptyStr;
 		}
 	}
 	/*
@@ -876,14 +1007,25 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::saveAsText(BaseDynamicBuffer *buffer, int indent) {
-	_valIter = _valObject.begin();
-	while (_valIter != _valObject.end()) {
+	for (uint32 i = 0; i < _propValues.size(); i++) {
+		if (!_propValues[i]) {
+			continue;
+		}
 		buffer->putTextIndent(indent, "PROPERTY {\n");
-		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", _valIter->_key.c_str());
-		buffer->putTextIndent(indent + 2, "VALUE=\"%s\"\n", _valIter->_value->getString());
+		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", _propLayout->getName(i));
+		buffer->putTextIndent(indent + 2, "VALUE=\"%s\"\n", _propValues[i]->getString());
 		buffer->putTextIndent(indent, "}\n\n");
+	}
 
-		_valIter++;
+	Common::HashMap<Common::String, ScValue *>::iterator it;
+	for (it = _dynamicProps.begin(); it != _dynamicProps.end(); ++it) {
+		if (!it->_value) {
+			continue;
+		}
+		buffer->putTextIndent(indent, "PROPERTY {\n");
+		buffer->putTextIndent(indent + 2, "NAME=\"%s\"\n", it->_key.c_str());
+		buffer->putTextIndent(indent + 2, "VALUE=\"%s\"\n", it->_value->getString());
+		buffer->putTextIndent(indent, "}\n\n");
 	}
 	return STATUS_OK;
 }
@@ -32,12 +32,16 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/str.h"
 
 namespace Wintermute {
 
 class ScScript;
 class BaseScriptable;
+class ScPropertyLayout;
 
 class ScValue : public BaseClass {
 public:
@@ -69,6 +73,8 @@ public:
 	void setFloat(double val);
 	void setString(const char *val);
 	void setString(const Common::String &val);
+	/** Sets a string returned by ScNameTable::intern(), which is shared instead of copied. */
+	void setInternedString(const char *val);
 	void setNULL();
 	void setNative(BaseScriptable *val, bool persistent = false);
 	void setObject();
@@ -82,12 +88,18 @@ public:
 	bool isObject();
 	bool setProp(const char *name, ScValue *val, bool copyWhole = false, bool setAsConst = false);
 	ScValue *getProp(const char *name);
+	/**
+	 * Looks up a property without trying the native ones, by a name returned
+	 * by ScNameTable::intern() if the name was interned.
+	 */
+	ScValue *getInternedProp(const char *name);
 	BaseScriptable *_valNative;
 	ScValue *_valRef;
 	bool _valBool;
 	int32 _valInt;
 	double _valFloat;
-	char *_valString;
+	const char *_valString;
+	bool _valStringInterned;
 	TValType _type;
 	ScValue(BaseGame *inGame);
 	ScValue(BaseGame *inGame, bool val);
@@ -95,14 +107,23 @@ public:
 	ScValue(BaseGame *inGame, double val);
 	ScValue(BaseGame *inGame, const char *val);
 	~ScValue() override;
-	Common::HashMap<Common::String, ScValue *> _valObject;
-	Common::HashMap<Common::String, ScValue *>::iterator _valIter;
 
 	bool setProperty(const char *propName, int32 value);
 	bool setProperty(const char *propName, const char *value);
 	bool setProperty(const char *propName, double value);
 	bool setProperty(const char *propName, bool value);
 	bool setProperty(const char *propName);
+
+private:
+	ScValue **findProp(const char *name);
+	ScValue **findProp(const char *name, const char *internedName);
+	ScValue *&getPropRef(const char *name);
+
+	/** The interned names of the properties, which give the slots of their values. */
+	ScPropertyLayout *_propLayout;
+	Common::Array<ScValue *> _propValues;
+	/** The properties whose names were made up by the scripts, and aren't interned. */
+	Common::HashMap<Common::String, ScValue *> _dynamicProps;
 };
 
 } // End of namespace Wintermute
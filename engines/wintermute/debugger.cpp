@@ -22,6 +22,9 @@
 #include "engines/wintermute/debugger.h"
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_file_manager.h"
+#include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/base/scriptables/script_engine.h"
+#include "engines/wintermute/base/scriptables/script_names.h"
 #include "engines/wintermute/base/scriptables/script_value.h"
 #include "engines/wintermute/debugger/debugger_controller.h"
 #include "engines/wintermute/wintermute.h"
@@ -32,6 +35,7 @@ namespace Wintermute {
 
 Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("bench_script", WRAP_METHOD(Console, Cmd_BenchScript));
 #if EXTENDED_DEBUGGER_ENABLED
 	registerCmd("help", WRAP_METHOD(Console, Cmd_Help));
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
@@ -341,6 +345,71 @@ bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_BenchScript(int argc, const char **argv) {
+	if (argc != 2 && argc != 3) {
+		debugPrintf("Usage: %s <compiled script path> [<number of runs>]\n", argv[0]);
+		return true;
+	}
+
+	BaseGame *game = BaseEngine::instance().getGameRef();
+	if (!game || !game->_scEngine) {
+		debugPrintf("No game is running\n");
+		return true;
+	}
+
+	ScEngine *scEngine = game->_scEngine;
+	uint32 size;
+	byte *compBuffer = scEngine->getCompiledScript(argv[1], &size);
+	if (!compBuffer) {
+		debugPrintf("Script '%s' not found or not compiled\n", argv[1]);
+		return true;
+	}
+
+	// The cached buffer may be dropped when the script runs other ones
+	byte *buffer = new byte[size];
+	memcpy(buffer, compBuffer, size);
+
+	const int runs = argc == 3 ? MAX(atoi(argv[2]), 1) : 1;
+	uint32 instructions = 0;
+	uint32 startTime = g_system->getMillis();
+
+	for (int i = 0; i < runs; i++) {
+		ScScript *script = new ScScript(game, scEngine);
+		if (DID_FAIL(script->create(argv[1], buffer, size, nullptr))) {
+			debugPrintf("Script '%s' can't be run\n", argv[1]);
+			delete script;
+			break;
+		}
+
+		ScValue self(game);
+		script->_globals->setProp("self", &self);
+		script->_globals->setProp("this", &self);
+
+		// Only the instructions up to the first wait are run
+		while (script->_state == SCRIPT_RUNNING) {
+			scEngine->_currentScript = script;
+			script->executeInstruction();
+			instructions++;
+		}
+		scEngine->_currentScript = nullptr;
+
+		if (script->_state == SCRIPT_ERROR) {
+			debugPrintf("Script '%s' failed at line %d\n", argv[1], script->_currentLine);
+			delete script;
+			break;
+		}
+		delete script;
+	}
+
+	debugPrintf("%d runs of '%s': %u instructions in %u ms\n", runs, argv[1], instructions, g_system->getMillis() - startTime);
+
+	ScNameTable *names = BaseEngine::instance().getNameTable();
+	debugPrintf("%u interned names, %u shared property layouts\n", names->getNumNames(), names->getNumLayouts());
+
+	delete[] buffer;
+	return true;
+}
+
 #if EXTENDED_DEBUGGER_ENABLED
 
 bool Console::Cmd_SourcePath(int argc, const char **argv) {
@@ -69,6 +69,11 @@ public:
 	bool Cmd_Help(int argc, const char **argv);
 	bool Cmd_ShowFps(int argc, const char **argv);
 	bool Cmd_DumpFile(int argc, const char **argv);
+	/**
+	 * Run a compiled script to its end a number of times, and print the
+	 * time it took.
+	 */
+	bool Cmd_BenchScript(int argc, const char **argv);
 
 #if EXTENDED_DEBUGGER_ENABLED
 	/**
@@ -46,7 +46,7 @@ BaseScriptable *makeSXShadowManager(BaseGame *inGame, ScStack *stack);
 BaseScriptable *makeSXDisplacement(BaseGame *inGame, ScStack *stack);
 BaseScriptable *makeSXProtection(BaseGame *inGame, ScStack *stack);
 
-bool EmulatePluginCall(BaseGame *inGame, ScStack *stack, ScStack *thisStack, char *name) {
+bool EmulatePluginCall(BaseGame *inGame, ScStack *stack, ScStack *thisStack, const char *name) {
 	ScValue *thisObj;
 
 	//////////////////////////////////////////////////////////////////////////
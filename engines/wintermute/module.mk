@@ -31,6 +31,7 @@ MODULE_OBJS := \
 	base/scriptables/debuggable/debuggable_script_engine.o \
 	base/scriptables/script.o \
 	base/scriptables/script_engine.o \
+	base/scriptables/script_names.o \
 	base/scriptables/script_stack.o \
 	base/scriptables/script_value.o \
 	base/scriptables/script_ext_array.o \
@@ -30,6 +30,7 @@ struct Point;
 }
 
 class BlendBlitUnfilteredTestSuite;
+class AlphaBlitTestSuite;
 
 namespace Graphics {
 
@@ -274,6 +275,51 @@ void fastBlitNEON_XRGB1555_RGB565(byte *, const byte *, const uint, const uint,
  */
 FastBlitFunc getFastBlitFunc(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
 
+// This is a class so that we can declare certain things as private
+class AlphaBlitRow {
+private:
+	struct Args {
+		const byte *mask;
+		uint32 key;
+		uint32 rgbMask;
+		uint32 alphaMask;
+		int alphaShift;
+		bool hasKey;
+		byte aMod;
+	};
+
+#ifdef SCUMMVM_NEON
+	static void blitNEON(uint32 *dst, const uint32 *src, const uint w, const Args &args);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void blitSSE2(uint32 *dst, const uint32 *src, const uint w, const Args &args);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void blitAVX2(uint32 *dst, const uint32 *src, const uint w, const Args &args);
+#endif
+	static void blitGeneric(uint32 *dst, const uint32 *src, const uint w, const Args &args);
+
+	typedef void(*BlitFunc)(uint32 *, const uint32 *, const uint, const Args &);
+	static BlitFunc blitFunc;
+
+	friend class ::AlphaBlitTestSuite;
+
+public:
+	/**
+	 * Blits a rectangle like alphaBlit(), alphaKeyBlit() or alphaMaskBlit(),
+	 * several pixels at once, when both surfaces use the same 32bpp format with
+	 * 8 bits per channel.
+	 *
+	 * @return false if the format isn't supported or the CPU has no SIMD
+	 *         instructions, in which case nothing is blitted.
+	 */
+	static bool blit(byte *dst, const byte *src, const byte *mask,
+			  const uint dstPitch, const uint srcPitch, const uint maskPitch,
+			  const uint w, const uint h,
+			  const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt,
+			  const bool hasKey, const uint32 key, const byte flip, const byte aMod);
+}; // End of class AlphaBlitRow
+
 bool scaleBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
 			   const uint dstW, const uint dstH,
@@ -133,6 +133,9 @@ static inline bool alphaBlitHelper(byte *dst, const byte *src, const byte *mask,
 	const bool flipx = flip & FLIP_H;
 	const bool flipy = flip & FLIP_V;
 
+	if (aMod != 0 && AlphaBlitRow::blit(dst, src, mask, dstPitch, srcPitch, maskPitch, w, h, dstFmt, srcFmt, hasKey, key, flip, aMod))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	      int dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
 	const int srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
@@ -538,4 +541,84 @@ void BlendBlit::fill(byte *dst, const uint dstPitch,
 	fillFunc(args, blendMode);
 }
 
+// Initialize this to nullptr at the start
+AlphaBlitRow::BlitFunc AlphaBlitRow::blitFunc = nullptr;
+
+bool AlphaBlitRow::blit(byte *dst, const byte *src, const byte *mask,
+						const uint dstPitch, const uint srcPitch, const uint maskPitch,
+						const uint w, const uint h,
+						const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt,
+						const bool hasKey, const uint32 key, const byte flip, const byte aMod) {
+	// Only pixels with whole bytes per channel are blended byte by byte, and
+	// the rows are processed from left to right.
+	if ((flip & FLIP_H) || srcFmt != dstFmt || dstFmt.bytesPerPixel != 4 ||
+			dstFmt.rBits() != 8 || dstFmt.gBits() != 8 || dstFmt.bBits() != 8 ||
+			(dstFmt.aBits() != 8 && dstFmt.aBits() != 0) ||
+			((dstFmt.rShift | dstFmt.gShift | dstFmt.bShift | dstFmt.aShift) & 7))
+		return false;
+
+	// If no function has been selected yet, detect and select
+	if (!blitFunc) {
+		blitFunc = blitGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) blitFunc = blitNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) blitFunc = blitSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) blitFunc = blitAVX2;
+#endif
+	}
+
+	// Without SIMD, leave it to the code specialized for each case
+	if (blitFunc == blitGeneric)
+		return false;
+
+	Args args;
+	args.key = key;
+	args.rgbMask = dstFmt.ARGBToColor(0, 255, 255, 255);
+	args.alphaMask = dstFmt.ARGBToColor(255, 0, 0, 0);
+	args.alphaShift = dstFmt.aBits() ? dstFmt.aShift : -1;
+	args.hasKey = hasKey;
+	args.aMod = aMod;
+
+	for (uint y = 0; y < h; y++) {
+		byte *dstRow = dst + ((flip & FLIP_V) ? h - 1 - y : y) * dstPitch;
+		args.mask = mask ? mask + y * maskPitch : nullptr;
+		blitFunc((uint32 *)dstRow, (const uint32 *)(src + y * srcPitch), w, args);
+	}
+	return true;
+}
+
+// Same as alphaBlitLogic() for these formats. The SIMD versions use this
+// for the pixels left at the end of a row.
+void AlphaBlitRow::blitGeneric(uint32 *dst, const uint32 *src, const uint w, const Args &args) {
+	for (uint x = 0; x < w; x++) {
+		const uint32 srcColor = src[x];
+
+		uint a;
+		if (args.mask)
+			a = args.mask[x];
+		else if (args.hasKey)
+			a = (srcColor == args.key) ? 0 : 255;
+		else
+			a = (args.alphaShift >= 0) ? (srcColor >> args.alphaShift) & 0xFF : 255;
+
+		if (a == 255 && args.aMod == 255) {
+			dst[x] = (srcColor & args.rgbMask) | args.alphaMask;
+		} else if (a != 0) {
+			const uint sA = args.hasKey ? args.aMod : (a * args.aMod) >> 8;
+			const uint32 dstColor = dst[x];
+			uint32 outColor = 0;
+			for (int shift = 0; shift < 32; shift += 8) {
+				const uint d = (dstColor >> shift) & 0xFF;
+				const uint s = (srcColor >> shift) & 0xFF;
+				outColor |= ((d * (255 - sA) + s * sA) >> 8) << shift;
+			}
+			dst[x] = (outColor & args.rgbMask) | args.alphaMask;
+		}
+	}
+}
+
 } // End of namespace Graphics
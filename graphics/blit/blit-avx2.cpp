@@ -321,6 +321,58 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+void AlphaBlitRow::blitAVX2(uint32 *dst, const uint32 *src, const uint w, const Args &args) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i full = _mm256_set1_epi32(255);
+	const __m256i aMod = _mm256_set1_epi32(args.aMod);
+	const __m256i rgbMask = _mm256_set1_epi32(args.rgbMask);
+	const __m256i alphaMask = _mm256_set1_epi32(args.alphaMask);
+	const __m256i key = _mm256_set1_epi32(args.key);
+	const __m128i alphaShift = _mm_cvtsi32_si128(MAX(args.alphaShift, 0));
+
+	// Unpacking and packing both work within 128-bit lanes, which keeps the
+	// pixels and their factors together.
+	uint x = 0;
+	for (; x + 8 <= w; x += 8) {
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+
+		__m256i a;
+		if (args.mask) {
+			a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(args.mask + x)));
+		} else if (args.hasKey) {
+			a = _mm256_andnot_si256(_mm256_cmpeq_epi32(s, key), full);
+		} else if (args.alphaShift >= 0) {
+			a = _mm256_and_si256(_mm256_srl_epi32(s, alphaShift), full);
+		} else {
+			a = full;
+		}
+
+		const __m256i opaque = (args.aMod == 255) ? _mm256_cmpeq_epi32(a, full) : zero;
+		const __m256i transparent = _mm256_cmpeq_epi32(a, zero);
+		const __m256i sA = args.hasKey ? aMod : _mm256_srli_epi32(_mm256_mullo_epi16(a, aMod), 8);
+		const __m256i sA16 = _mm256_or_si256(sA, _mm256_slli_epi32(sA, 16));
+		const __m256i dA16 = _mm256_sub_epi16(_mm256_set1_epi16(255), sA16);
+
+		const __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(dA16, dA16)),
+			_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi32(sA16, sA16))), 8);
+		const __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(dA16, dA16)),
+			_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi32(sA16, sA16))), 8);
+		const __m256i blended = _mm256_or_si256(_mm256_and_si256(_mm256_packus_epi16(lo, hi), rgbMask), alphaMask);
+		const __m256i copied = _mm256_or_si256(_mm256_and_si256(s, rgbMask), alphaMask);
+
+		const __m256i out = _mm256_blendv_epi8(_mm256_blendv_epi8(blended, d, transparent), copied, opaque);
+		_mm256_storeu_si256((__m256i *)(dst + x), out);
+	}
+
+	Args tail = args;
+	if (tail.mask)
+		tail.mask += x;
+	blitGeneric(dst + x, src + x, w - x, tail);
+}
+
 } // End of namespace Graphics
 
 #if defined(__clang__)
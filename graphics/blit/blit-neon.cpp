@@ -376,6 +376,56 @@ void fastBlitNEON_XRGB1555_RGB565(byte *dst, const byte *src,
 	}
 }
 
+void AlphaBlitRow::blitNEON(uint32 *dst, const uint32 *src, const uint w, const Args &args) {
+	const uint32x4_t zero = vdupq_n_u32(0);
+	const uint32x4_t full = vdupq_n_u32(255);
+	const uint32x4_t aMod = vdupq_n_u32(args.aMod);
+	const uint32x4_t rgbMask = vdupq_n_u32(args.rgbMask);
+	const uint32x4_t alphaMask = vdupq_n_u32(args.alphaMask);
+	const uint32x4_t key = vdupq_n_u32(args.key);
+	const int32x4_t alphaShift = vdupq_n_s32(-MAX(args.alphaShift, 0));
+
+	uint x = 0;
+	for (; x + 4 <= w; x += 4) {
+		const uint32x4_t s = vld1q_u32(src + x);
+		const uint32x4_t d = vld1q_u32(dst + x);
+
+		uint32x4_t a;
+		if (args.mask) {
+			uint32 m;
+			memcpy(&m, args.mask + x, sizeof(m));
+			a = vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(m)))));
+		} else if (args.hasKey) {
+			a = vbicq_u32(full, vceqq_u32(s, key));
+		} else if (args.alphaShift >= 0) {
+			a = vandq_u32(vshlq_u32(s, alphaShift), full);
+		} else {
+			a = full;
+		}
+
+		const uint32x4_t opaque = (args.aMod == 255) ? vceqq_u32(a, full) : zero;
+		const uint32x4_t transparent = vceqq_u32(a, zero);
+		const uint32x4_t sA = args.hasKey ? aMod : vshrq_n_u32(vmulq_u32(a, aMod), 8);
+
+		// Repeat the factor of each pixel in all of its bytes
+		const uint8x16_t sA8 = vreinterpretq_u8_u32(vmulq_n_u32(sA, 0x01010101));
+		const uint8x16_t dA8 = vreinterpretq_u8_u32(vmulq_n_u32(vsubq_u32(full, sA), 0x01010101));
+		const uint8x16_t s8 = vreinterpretq_u8_u32(s);
+		const uint8x16_t d8 = vreinterpretq_u8_u32(d);
+		const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(d8), vget_low_u8(dA8)), vget_low_u8(s8), vget_low_u8(sA8));
+		const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(d8), vget_high_u8(dA8)), vget_high_u8(s8), vget_high_u8(sA8));
+		const uint32x4_t blended = vorrq_u32(vandq_u32(vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8))), rgbMask), alphaMask);
+		const uint32x4_t copied = vorrq_u32(vandq_u32(s, rgbMask), alphaMask);
+
+		vst1q_u32(dst + x, vbslq_u32(opaque, copied, vbslq_u32(transparent, d, blended)));
+	}
+
+	Args tail = args;
+	if (tail.mask)
+		tail.mask += x;
+	blitGeneric(dst + x, src + x, w - x, tail);
+}
+
 } // end of namespace Graphics
 
 #if !defined(__aarch64__) && !defined(__ARM_NEON)
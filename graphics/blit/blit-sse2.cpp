@@ -326,6 +326,64 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+static FORCEINLINE __m128i sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+void AlphaBlitRow::blitSSE2(uint32 *dst, const uint32 *src, const uint w, const Args &args) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi32(255);
+	const __m128i aMod = _mm_set1_epi32(args.aMod);
+	const __m128i rgbMask = _mm_set1_epi32(args.rgbMask);
+	const __m128i alphaMask = _mm_set1_epi32(args.alphaMask);
+	const __m128i key = _mm_set1_epi32(args.key);
+	const __m128i alphaShift = _mm_cvtsi32_si128(MAX(args.alphaShift, 0));
+
+	uint x = 0;
+	for (; x + 4 <= w; x += 4) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+
+		// The alpha of each pixel, in the low byte of its lane
+		__m128i a;
+		if (args.mask) {
+			uint32 m;
+			memcpy(&m, args.mask + x, sizeof(m));
+			a = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(m), zero), zero);
+		} else if (args.hasKey) {
+			a = _mm_andnot_si128(_mm_cmpeq_epi32(s, key), full);
+		} else if (args.alphaShift >= 0) {
+			a = _mm_and_si128(_mm_srl_epi32(s, alphaShift), full);
+		} else {
+			a = full;
+		}
+
+		const __m128i opaque = (args.aMod == 255) ? _mm_cmpeq_epi32(a, full) : zero;
+		const __m128i transparent = _mm_cmpeq_epi32(a, zero);
+		const __m128i sA = args.hasKey ? aMod : _mm_srli_epi32(_mm_mullo_epi16(a, aMod), 8);
+		const __m128i sA16 = _mm_or_si128(sA, _mm_slli_epi32(sA, 16));
+		const __m128i dA16 = _mm_sub_epi16(_mm_set1_epi16(255), sA16);
+
+		// Both products fit in 16 bits, and so does their sum
+		const __m128i lo = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(dA16, dA16)),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi32(sA16, sA16))), 8);
+		const __m128i hi = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(dA16, dA16)),
+			_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi32(sA16, sA16))), 8);
+		const __m128i blended = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), rgbMask), alphaMask);
+		const __m128i copied = _mm_or_si128(_mm_and_si128(s, rgbMask), alphaMask);
+
+		const __m128i out = sse2_select(opaque, copied, sse2_select(transparent, d, blended));
+		_mm_storeu_si128((__m128i *)(dst + x), out);
+	}
+
+	Args tail = args;
+	if (tail.mask)
+		tail.mask += x;
+	blitGeneric(dst + x, src + x, w - x, tail);
+}
+
 } // End of namespace Graphics
 
 #if !defined(__x86_64__)
@@ -45,6 +45,43 @@ void DirtyRectList::merge() {
 	}
 }
 
+void DirtyRectList::merge(uint overhead, uint maxRects) {
+	uint count = _dirtyRects.size();
+
+	while (count > 1) {
+		// Find the pair of rects whose union adds the least pixels to them
+		Common::List<Common::Rect>::iterator bestOuter, bestInner;
+		int64 bestCost = 0;
+		bool found = false;
+
+		for (Common::List<Common::Rect>::iterator rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
+			Common::List<Common::Rect>::iterator rInner = rOuter;
+			while (++rInner != _dirtyRects.end()) {
+				Common::Rect combined;
+				unionRectangle(combined, *rOuter, *rInner);
+
+				const int64 cost = (int64)combined.width() * combined.height()
+				                 - (int64)rOuter->width() * rOuter->height()
+				                 - (int64)rInner->width() * rInner->height();
+				if (!found || cost < bestCost) {
+					bestOuter = rOuter;
+					bestInner = rInner;
+					bestCost = cost;
+					found = true;
+				}
+			}
+		}
+
+		// Stop once merging costs more than keeping the rects separate
+		if (bestCost > (int64)overhead && count <= maxRects)
+			break;
+
+		unionRectangle(*bestOuter, *bestOuter, *bestInner);
+		_dirtyRects.erase(bestInner);
+		--count;
+	}
+}
+
 bool DirtyRectList::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
 	destRect = src1;
 	destRect.extend(src2);
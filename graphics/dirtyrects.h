@@ -62,6 +62,22 @@ public:
 	 */
 	void merge();
 
+	/**
+	 * Merges together dirty areas whenever handling them separately costs
+	 * more than handling their union, e.g. when uploading them to a texture.
+	 *
+	 * @param overhead  The cost of handling one more area, in pixels.
+	 * @param maxRects  The maximum number of areas to keep. Areas which are
+	 *                  the cheapest to merge are merged until there are no
+	 *                  more than this.
+	 */
+	void merge(uint overhead, uint maxRects);
+
+	/**
+	 * Returns the number of dirty areas
+	 */
+	uint size() const { return _dirtyRects.size(); }
+
 	/**
 	 * Returns true if there are no pending screen updates (dirty areas)
 	 */
@@ -21,6 +21,7 @@
 
 #include "graphics/framelimiter.h"
 
+#include "common/frametimings.h"
 #include "common/util.h"
 
 namespace Graphics {
@@ -57,8 +58,13 @@ bool FrameLimiter::delayBeforeSwap() {
 	if (_enabled) {
 		//_delay = _frameLimit - _loopDuration;  // Original functionality, will tend to undershoot target framerate slightly due to finite screen.update() time.
 		_delay = _frameLimit - (_now - _drawStart); // Ensure that EXACTLY the specified frame duration has elapsed since last screen.update() was called.
-		if (_delay > 0)
+		if (_delay > 0) {
+			Common::FrameTimings *frameTimings = _system->getFrameTimings();
+			const uint64 sleepStart = frameTimings ? _system->getMicros() : 0;
 			_system->delayMillis(_delay);
+			if (frameTimings)
+				frameTimings->addTime(Common::FrameTimings::kStageSleep, (uint32)(_system->getMicros() - sleepStart));
+		}
 	}
 	_drawStart = _system->getMillis();
 	return (_delay < 0); // Check if frame is late
@@ -33,6 +33,8 @@
 
 namespace OpenGL {
 
+uint32 Texture::_uploadedBytes = 0;
+
 Texture::Texture(GLenum glIntFormat, GLenum glFormat, GLenum glType, bool autoCreate)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
@@ -253,26 +255,33 @@ void Texture::updateArea(const Common::Rect &area, const Graphics::Surface &src)
 	}
 
 	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
 	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+#ifdef GL_UNPACK_ROW_LENGTH
+	if (OpenGLContext.unpackSubImageSupported) {
+		// Only upload the area itself, GL_UNPACK_ROW_LENGTH lets us specify
+		// the pitch of the surface.
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                       _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+
+		_uploadedBytes += area.width() * area.height() * src.format.bytesPerPixel;
+		return;
+	}
+#endif
+
+	// Without GL_UNPACK_ROW_LENGTH (OpenGL ES 1.0 and 2.0) it is not possible
+	// to specify a pitch to glTexSubImage2D, so we cannot take advantage of
+	// the left/right boundaries of the area. Copying the area to a temporary
+	// buffer first (which is what the Android backend does) is more
+	// complicated, and uploading it line by line (which is what the old
+	// OpenGL graphics manager did) is much slower. Thus, we simply update the
+	// whole texture lines.
 	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
 	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+	_uploadedBytes += src.w * area.height() * src.format.bytesPerPixel;
 }
 
 } // End of namespace OpenGL
@@ -129,6 +129,17 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Query the number of bytes uploaded by updateArea() for all textures
+	 * since the last call to resetUploadedBytes().
+	 */
+	static uint32 getUploadedBytes() { return _uploadedBytes; }
+
+	/**
+	 * Reset the count of uploaded bytes, e.g. at the start of a frame.
+	 */
+	static void resetUploadedBytes() { _uploadedBytes = 0; }
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -191,6 +202,8 @@ protected:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	static uint32 _uploadedBytes;
 };
 
 } // End of namespace OpenGL
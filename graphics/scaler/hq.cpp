@@ -5078,6 +5078,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return false; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 1; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
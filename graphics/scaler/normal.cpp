@@ -286,6 +286,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return true; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 0; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
@@ -422,6 +422,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return false; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 2; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
@@ -478,6 +479,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return false; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 2; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
@@ -534,6 +536,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return false; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 2; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
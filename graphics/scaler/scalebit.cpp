@@ -167,7 +167,7 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
  * intermediate results. This bitmap must have at least a horizontal size in bytes of 2*width*pixel,
- * and a vertical size of 6 rows. The memory of this buffer must not be allocated
+ * and a vertical size of 6 rows. There must also be 8 bytes of space before and after every row. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
  * @param void_dst Pointer at the first pixel of the destination bitmap.
@@ -180,6 +180,20 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * @param width Horizontal size in pixels of the source bitmap.
  * @param height Vertical size in pixels of the source bitmap.
  */
+/**
+ * Repeat the border pixels of a buffer row into the 8 bytes before and after it.
+ * The MMX implementation of Scale2x reads these, and without them the result
+ * for the border pixels would depend on the previous contents of the buffer.
+ */
+static inline void scale4x_pad(unsigned char* row, unsigned pixel, unsigned width) {
+	unsigned i;
+
+	for (i = 0; i < 8; i += pixel) {
+		memcpy(row - 8 + i, row, pixel);
+		memcpy(row + width * pixel + i, row + (width - 1) * pixel, pixel);
+	}
+}
+
 static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsigned mid_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height) {
 	unsigned char* dst = (unsigned char*)void_dst;
 	const unsigned char* src = (const unsigned char*)void_src;
@@ -200,10 +214,16 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 
 	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
 	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	scale4x_pad(SCMID(0), pixel, 2 * width);
+	scale4x_pad(SCMID(1), pixel, 2 * width);
+	scale4x_pad(SCMID(2), pixel, 2 * width);
+	scale4x_pad(SCMID(3), pixel, 2 * width);
 	while (count) {
 		unsigned char* tmp;
 
 		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
+		scale4x_pad(SCMID(4), pixel, 2 * width);
+		scale4x_pad(SCMID(5), pixel, 2 * width);
 		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
 
 		dst = SCDST(4);
@@ -250,6 +270,8 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
+	mid_slice += 16; /* space for the padding around the rows */
+
 #if defined(HAVE_ALLOCA)
 	mid = alloca(6 * mid_slice); /* allocate space for 6 row buffers */
 
@@ -261,7 +283,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 		return;
 #endif
 
-	scale4x_buf(void_dst, dst_slice, mid, mid_slice, void_src, src_slice, pixel, width, height);
+	scale4x_buf(void_dst, dst_slice, (unsigned char*)mid + 8, mid_slice, void_src, src_slice, pixel, width, height);
 
 #if !defined(HAVE_ALLOCA)
 	free(mid);
@@ -381,6 +403,7 @@ public:
 	Scaler *createInstance(const Graphics::PixelFormat &format) const override;
 
 	bool canDrawCursor() const override { return true; }
+	bool canScaleInBands() const override { return true; }
 	uint extraPixels() const override { return 4; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
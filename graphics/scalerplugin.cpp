@@ -18,6 +18,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/thread.h"
+
 #include "graphics/scalerplugin.h"
 
 namespace {
@@ -42,6 +44,29 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 }
 } // End of anonymous namespace
 
+struct Scaler::BandJob {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height;
+	int x, y;
+	uint numBands;
+};
+
+void Scaler::scaleBand(void *data, uint index) {
+	const BandJob &job = *(const BandJob *)data;
+	const int top = job.height * index / job.numBands;
+	const int bottom = job.height * (index + 1) / job.numBands;
+
+	// The rows above and below the band are still read from the source, so
+	// the result is the same as when scaling the whole rect at once
+	job.scaler->scaleIntern(job.srcPtr + top * job.srcPitch, job.srcPitch,
+	                        job.dstPtr + top * job.scaler->_factor * job.dstPitch, job.dstPitch,
+	                        job.width, bottom - top, job.x, job.y + top);
+}
+
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                           uint32 dstPitch, int width, int height, int x, int y) {
 	if (_factor == 1) {
@@ -52,6 +77,18 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+	} else if (_threads && _threads->getNumThreads() > 1) {
+		// Use a couple of bands per thread to balance the load, but don't
+		// bother for small rects
+		const int kBandsPerThread = 2;
+		const int kMinBandHeight = 16;
+
+		BandJob job = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, 0 };
+		job.numBands = MIN<int>(_threads->getNumThreads() * kBandsPerThread, height / kMinBandHeight);
+		if (job.numBands > 1)
+			_threads->run(job.numBands, scaleBand, &job);
+		else
+			scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
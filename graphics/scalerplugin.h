@@ -25,9 +25,13 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _threads(nullptr) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -94,6 +98,16 @@ public:
 		assert(0);
 	}
 
+	/**
+	 * Split large rects into bands of rows which are scaled in parallel on
+	 * the given threads. This must only be used if the plugin returns true
+	 * for ScalerPluginObject::canScaleInBands().
+	 *
+	 * @param threads The pool to use, or nullptr to scale on the calling
+	 *                thread only. It is not owned by the scaler.
+	 */
+	void setThreadPool(Common::ThreadPool *threads) { _threads = threads; }
+
 protected:
 	/**
 	 * @see scale
@@ -103,6 +117,12 @@ protected:
 
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	struct BandJob;
+	static void scaleBand(void *data, uint index);
+
+	Common::ThreadPool *_threads;
 };
 
 /**
@@ -199,6 +219,16 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether separate bands of rows of a rect can be scaled at the same
+	 * time on different threads, with each band still reading the
+	 * extraPixels() rows around it from the source. This requires that the
+	 * scaler does not keep any state between rows or calls.
+	 *
+	 * @see Scaler::setThreadPool
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -27,6 +27,7 @@
 
 #include "common/singleton.h"
 #include "common/array.h"
+#include "common/system.h"
 
 #include "graphics/tinygl/tinygl.h"
 #include "graphics/tinygl/zgl.h"
@@ -359,6 +360,11 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(drawCallMemorySize);
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
+	memset(&_presentStats, 0, sizeof(_presentStats));
+
+	_rasterizationThreads = nullptr;
+	if (g_system)
+		setRasterizationThreads(0);
 }
 
 void GLContext::deinit() {
@@ -371,6 +377,7 @@ void GLContext::deinit() {
 	free_texture(default_texture);
 	endSharedState();
 	gl_free(vertex);
+	setRasterizationThreads(1);
 	delete fb;
 }
 
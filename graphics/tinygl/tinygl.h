@@ -39,6 +39,26 @@ void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+/**
+ * Set the number of threads rasterizing the current context, each of them
+ * rendering horizontal bands of the frame buffer. 0 uses all CPU cores,
+ * which is the default, and 1 renders everything on the calling thread.
+ */
+void setRasterizationThreads(uint numThreads);
+
+/**
+ * Statistics about the last frame presented by the current context.
+ * Without dirty rectangles, every draw call counts as changed and the whole
+ * frame buffer as redrawn.
+ */
+struct PresentStats {
+	uint drawCalls;        ///< Draw calls of the frame
+	uint changedDrawCalls; ///< Draw calls which don't match any of the previous frame
+	uint dirtyRegions;     ///< Rectangles the draw calls were replayed in
+	uint redrawnPixels;    ///< Total area of these rectangles
+};
+
+void getPresentStats(PresentStats &stats);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyFromFrameBuffer(const Graphics::PixelFormat &dstFormat);
 
@@ -242,6 +242,9 @@ void GLContext::glopVertex(GLParam *p) {
 		} else {
 			v->tex_coord = current_tex_coord;
 		}
+	} else {
+		// Unused, but compared when matching draw calls across frames
+		v->tex_coord = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
 	}
 	// precompute the mapping to the viewport
 	if (v->clip_code == 0)
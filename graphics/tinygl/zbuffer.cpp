@@ -52,6 +52,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
+	_ownsBuffers = true;
 
 	_currentTexture = nullptr;
 
@@ -59,12 +60,19 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
 }
 
+void FrameBuffer::shareBuffers(const FrameBuffer &other) {
+	*this = other;
+	_ownsBuffers = false;
+}
+
 Buffer *FrameBuffer::genOffscreenBuffer() {
 	Buffer *buf = (Buffer *)gl_malloc(sizeof(Buffer));
 	buf->pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch);
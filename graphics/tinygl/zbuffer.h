@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 
 #include "common/rect.h"
 #include "common/textconsole.h"
@@ -109,6 +110,12 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Render into the buffers of another frame buffer, starting from its current
+	 * state. The buffers remain owned by the other frame buffer.
+	 */
+	void shareBuffers(const FrameBuffer &other);
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -816,7 +823,12 @@ private:
 		uint previousA, uint previousR, uint previousG, uint previousB,
 		byte &texA, byte &texR, byte &texG, byte &texB);
 
+	// Set up the vectorized filling of flat shaded spans, if the frame buffer
+	// format and blending factors are supported
+	bool setupFlatSpan(SpanFill::FlatParams &params, byte aSrc, byte rSrc, byte gSrc, byte bSrc, bool depthWrite) const;
+
 	Buffer _offscreenBuffer;
+	bool _ownsBuffers;
 	byte *_pbuf;
 	int _pbufWidth;
 	int _pbufHeight;
@@ -24,6 +24,7 @@
 #include "graphics/tinygl/gl.h"
 
 #include "common/debug.h"
+#include "common/thread.h"
 
 namespace TinyGL {
 
@@ -121,111 +122,143 @@ void GLContext::disposeDrawCallLists() {
 	_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
-	Common::Rect dirty_region = call.getDirtyRegion();
+static inline void _appendDirtyRectangle(const DrawCall &call, Common::Array<DirtyRectangle> &rectangles, int r, int g, int b) {
+	const Common::Rect &dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
+// Size of the tiles the dirty rectangles are merged in, in pixels.
+static const int kDirtyTileSize = 16;
+// Number of calls of the previous frame searched for a match of each call, so
+// that the calls following an added or removed one still match.
+static const int kDrawCallLookahead = 16;
+
 void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
+	Common::Array<DirtyRectangle> rectangles;
 
 	DrawCallIterator itFrame = _drawCallsQueue.begin();
 	DrawCallIterator endFrame = _drawCallsQueue.end();
 	DrawCallIterator itPrevFrame = _previousFrameDrawCallsQueue.begin();
 	DrawCallIterator endPrevFrame = _previousFrameDrawCallsQueue.end();
 
-	// Compare draw calls.
-	for ( ; itPrevFrame != endPrevFrame && itFrame != endFrame;
-		++itPrevFrame, ++itFrame) {
-			const DrawCall &currentCall = **itFrame;
-			const DrawCall &previousCall = **itPrevFrame;
+	_presentStats.drawCalls = 0;
+	_presentStats.changedDrawCalls = 0;
+
+	// Match the draw calls with the ones of the previous frame, in the same
+	// order. Pixels only covered by matching calls are then rendered exactly
+	// like in the previous frame, and every other call is dirty. Comparing the
+	// hashes first makes looking ahead for a match cheap.
+	for ( ; itFrame != endFrame; ++itFrame) {
+		const DrawCall &currentCall = **itFrame;
+		_presentStats.drawCalls++;
+
+		DrawCallIterator match = itPrevFrame;
+		int distance = 0;
+		while (match != endPrevFrame && distance < kDrawCallLookahead && **match != currentCall) {
+			++match;
+			++distance;
+		}
 
-			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+		if (match != endPrevFrame && distance < kDrawCallLookahead) {
+			for ( ; itPrevFrame != match; ++itPrevFrame) {
+				_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
 			}
+			++itPrevFrame;
+		} else {
+			_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
+			_presentStats.changedDrawCalls++;
+		}
 	}
 
 	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
 		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
 	}
 
-	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
-	}
+	// Mark the tiles covered by dirty rectangles. Merging these is linear in the
+	// number of rectangles, and redraws at most a tile around each of them.
+	const int tilesW = (fb->getPixelBufferWidth() + kDirtyTileSize - 1) / kDirtyTileSize;
+	const int tilesH = (fb->getPixelBufferHeight() + kDirtyTileSize - 1) / kDirtyTileSize;
+	_dirtyTiles.resize(tilesW * tilesH);
+	memset(_dirtyTiles.data(), 0, _dirtyTiles.size());
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
 	for (auto &rect : rectangles) {
-		rect.rectangle.right++;
-		rect.rectangle.bottom++;
+		rect.rectangle.clip(renderRect);
+		if (rect.rectangle.isEmpty())
+			continue;
+		const int tileLeft = rect.rectangle.left / kDirtyTileSize;
+		const int tileRight = (rect.rectangle.right - 1) / kDirtyTileSize;
+		const int tileTop = rect.rectangle.top / kDirtyTileSize;
+		const int tileBottom = (rect.rectangle.bottom - 1) / kDirtyTileSize;
+		for (int y = tileTop; y <= tileBottom; y++) {
+			memset(&_dirtyTiles[y * tilesW + tileLeft], 1, tileRight - tileLeft + 1);
+		}
 	}
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
+	// Turn every run of dirty tiles into a region, extending the region of the
+	// row above instead if it spans the same columns.
+	Common::Array<Common::Rect> regions;
+	Common::Array<uint> openRegions, nextOpenRegions;
+	for (int y = 0; y < tilesH; y++) {
+		const byte *row = &_dirtyTiles[y * tilesW];
+		nextOpenRegions.clear();
+		for (int x = 0; x < tilesW; ) {
+			if (!row[x]) {
+				x++;
+				continue;
+			}
+			const int runStart = x;
+			while (x < tilesW && row[x]) {
+				x++;
+			}
+
+			const Common::Rect run(runStart * kDirtyTileSize, y * kDirtyTileSize, x * kDirtyTileSize, (y + 1) * kDirtyTileSize);
+			uint index = regions.size();
+			for (const auto &open : openRegions) {
+				if (regions[open].left == run.left && regions[open].right == run.right) {
+					index = open;
+					break;
 				}
 			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
+			if (index == regions.size()) {
+				regions.push_back(run);
 			} else {
-				++it2;
+				regions[index].bottom = run.bottom;
 			}
+			nextOpenRegions.push_back(index);
 		}
+		SWAP(openRegions, nextOpenRegions);
 	}
 
-	for (auto &rect : rectangles) {
-		rect.rectangle.clip(renderRect);
+	_presentStats.dirtyRegions = regions.size();
+	_presentStats.redrawnPixels = 0;
+	for (auto &region : regions) {
+		region.clip(renderRect);
+		_presentStats.redrawnPixels += region.width() * region.height();
 	}
 
-	if (!rectangles.empty()) {
-		for (auto &rect : rectangles) {
-			dirtyAreas.push_back(rect.rectangle);
+	if (!regions.empty()) {
+		for (const auto &region : regions) {
+			dirtyAreas.push_back(region);
 		}
 
 		// Execute draw calls.
-		for (auto &drawCall : _drawCallsQueue) {
-			Common::Rect drawCallRegion = drawCall->getDirtyRegion();
-			for (auto &rect : rectangles) {
-				Common::Rect dirtyRegion = rect.rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					drawCall->execute(true, &dirtyRegion);
-				}
-			}
-		}
+		executeDrawCalls(regions);
 
 		if (_debugRectsEnabled) {
 			// Draw debug rectangles.
-			// Note: white rectangles are rectangle that contained other rectangles
-			// blue rectangles are rectangle merged from other rectangles
-			// red rectangles are original dirty rects
+			// Note: blue rectangles are the regions which were redrawn, red
+			// rectangles are the changed calls of this frame and white ones
+			// the calls of the previous frame they replace.
 
 			fb->enableBlending(false);
 			fb->enableAlphaTest(false);
 
+			for (const auto &region : regions) {
+				debugDrawRectangle(region, 0, 0, 255);
+			}
 			for (auto &rect : rectangles) {
 				debugDrawRectangle(rect.rectangle, rect.r, rect.g, rect.b);
 			}
@@ -252,10 +285,16 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	executeDrawCalls(Common::Array<Common::Rect>());
+
+	_presentStats.drawCalls = 0;
 	for (const auto &drawCall : _drawCallsQueue) {
-		drawCall->execute(true);
 		delete drawCall;
+		_presentStats.drawCalls++;
 	}
+	_presentStats.changedDrawCalls = _presentStats.drawCalls;
+	_presentStats.dirtyRegions = 1;
+	_presentStats.redrawnPixels = fb->getPixelBufferWidth() * fb->getPixelBufferHeight();
 
 	_drawCallsQueue.clear();
 
@@ -264,6 +303,151 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+// Executes a draw call in each of the regions it touches, or on the whole
+// frame buffer if no regions are given.
+static void executeDrawCall(const DrawCall &drawCall, const Common::Array<Common::Rect> &regions) {
+	if (regions.empty()) {
+		drawCall.execute(true);
+		return;
+	}
+
+	Common::Rect drawCallRegion = drawCall.getDirtyRegion();
+	for (const auto &region : regions) {
+		if (region.intersects(drawCallRegion)) {
+			drawCall.execute(true, &region);
+		}
+	}
+}
+
+void GLContext::executeDrawCalls(const Common::Array<Common::Rect> &regions) {
+	// The rasterization threads neither collect selection hits nor profiling data.
+	if (_rasterizationThreads && render_mode == TGL_RENDER && !_profilingEnabled) {
+		executeDrawCallsThreaded(regions);
+		return;
+	}
+
+	for (const auto &drawCall : _drawCallsQueue) {
+		executeDrawCall(*drawCall, regions);
+	}
+}
+
+// A horizontal band of the frame buffer, which is rendered by one task of the
+// rasterization threads using a context of its own.
+struct RasterizationBand {
+	GLContext context;
+	Common::Array<GLVertex> vertexBuffer;
+	Common::Rect rect;
+
+	RasterizationBand() : context() {}
+	~RasterizationBand() {
+		delete context.fb;
+	}
+};
+
+struct RasterizationJob {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	const Common::Array<RasterizationBand *> *bands;
+	const Common::Array<Common::Rect> *regions;
+	DrawCallIterator begin, end;
+};
+
+static void rasterizeBand(void *data, uint index) {
+	const RasterizationJob *job = (const RasterizationJob *)data;
+	RasterizationBand *band = (*job->bands)[index];
+
+	for (RasterizationJob::DrawCallIterator it = job->begin; it != job->end; ++it) {
+		const RasterizationDrawCall *drawCall = (const RasterizationDrawCall *)*it;
+		if (job->regions->empty()) {
+			drawCall->execute(&band->context, band->vertexBuffer, &band->rect);
+			continue;
+		}
+
+		Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+		for (const auto &region : *job->regions) {
+			Common::Rect clippingRectangle = region.findIntersectingRect(band->rect);
+			if (!clippingRectangle.isEmpty() && clippingRectangle.intersects(drawCallRegion)) {
+				drawCall->execute(&band->context, band->vertexBuffer, &clippingRectangle);
+			}
+		}
+	}
+}
+
+static bool isThreadSafe(const DrawCall &drawCall) {
+	return drawCall.getType() == DrawCall::DrawCall_Rasterization &&
+	       !((const RasterizationDrawCall &)drawCall).isSelection();
+}
+
+void GLContext::executeDrawCallsThreaded(const Common::Array<Common::Rect> &regions) {
+	for (auto &band : _rasterizationBands) {
+		GLContext &bandContext = band->context;
+		bandContext.fb->shareBuffers(*fb);
+		bandContext.fb->setTextureEnvironment(&bandContext._texEnv);
+		bandContext.render_mode = render_mode;
+		bandContext.current_cull_face = current_cull_face;
+		bandContext.vertex_n = vertex_n;
+	}
+
+	RasterizationJob job;
+	job.bands = &_rasterizationBands;
+	job.regions = &regions;
+
+	// Runs of rasterization calls are replayed by all bands in parallel, as every
+	// band only touches its own rows. Blits and clears are executed in between on
+	// this thread, which keeps the order of all writes to each pixel.
+	RasterizationJob::DrawCallIterator it = _drawCallsQueue.begin();
+	RasterizationJob::DrawCallIterator end = _drawCallsQueue.end();
+	while (it != end) {
+		job.begin = it;
+		while (it != end && isThreadSafe(**it)) {
+			++it;
+		}
+		if (job.begin != it) {
+			job.end = it;
+			_rasterizationThreads->run(_rasterizationBands.size(), rasterizeBand, &job);
+		}
+		if (it != end) {
+			executeDrawCall(**it, regions);
+			++it;
+		}
+	}
+}
+
+void GLContext::setRasterizationThreads(uint numThreads) {
+	for (auto &band : _rasterizationBands) {
+		delete band;
+	}
+	_rasterizationBands.clear();
+	delete _rasterizationThreads;
+	_rasterizationThreads = nullptr;
+
+	if (numThreads == 1)
+		return;
+
+	// Use a couple of bands per thread to balance the load, but keep them high
+	// enough that the same triangles aren't set up over and over again.
+	const int kBandsPerThread = 2;
+	const int kMinBandHeight = 16;
+
+	Common::ThreadPool *threads = new Common::ThreadPool(numThreads, "TinyGL rasterizer");
+	const int height = fb->getPixelBufferHeight();
+	const int numBands = MIN<int>(threads->getNumThreads() * kBandsPerThread, height / kMinBandHeight);
+	if (threads->getNumThreads() <= 1 || numBands <= 1) {
+		delete threads;
+		return;
+	}
+
+	_rasterizationThreads = threads;
+	for (int i = 0; i < numBands; i++) {
+		RasterizationBand *band = new RasterizationBand();
+		band->context._textureSize = _textureSize;
+		band->context.fb = new FrameBuffer(*fb);
+		band->context.fb->shareBuffers(*fb);
+		band->rect = Common::Rect(0, height * i / numBands, fb->getPixelBufferWidth(), height * (i + 1) / numBands);
+		_rasterizationBands.push_back(band);
+	}
+}
+
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
@@ -278,8 +462,25 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+void setRasterizationThreads(uint numThreads) {
+	gl_get_context()->setRasterizationThreads(numThreads);
+}
+
+void getPresentStats(PresentStats &stats) {
+	stats = gl_get_context()->_presentStats;
+}
+
+// One step of the FNV-1a hash, taking a whole value at once.
+static inline uint32 hashCombine(uint32 hash, uint32 value) {
+	return (hash ^ value) * 16777619;
+}
+
+static inline uint32 hashPointer(uint32 hash, const void *ptr) {
+	return hashCombine(hash, (uint32)(uintptr)ptr);
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
-	if (_type == other._type) {
+	if (_type == other._type && _hash == other._hash) {
 		switch (_type) {
 		case DrawCall_Rasterization:
 			return *(const RasterizationDrawCall *)this == (const RasterizationDrawCall &)other;
@@ -306,12 +507,32 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
+	_state = captureState(c);
 	if (c->_enableDirtyRectangles) {
 		computeDirtyRegion();
+		computeHash();
 	}
 }
 
+void RasterizationDrawCall::computeHash() {
+	uint32 hash = hashCombine(2166136261u, _vertexCount);
+	hash = hashPointer(hash, _state.texture);
+	hash = hashCombine(hash, _state.textureVersion);
+	for (int i = 0; i < _vertexCount; i++) {
+		const ZBufferPoint &zp = _vertex[i].zp;
+		hash = hashCombine(hash, zp.x);
+		hash = hashCombine(hash, zp.y);
+		hash = hashCombine(hash, zp.z);
+		hash = hashCombine(hash, zp.s);
+		hash = hashCombine(hash, zp.t);
+		hash = hashCombine(hash, zp.r);
+		hash = hashCombine(hash, zp.g);
+		hash = hashCombine(hash, zp.b);
+		hash = hashCombine(hash, zp.a);
+	}
+	_hash = hash;
+}
+
 void RasterizationDrawCall::computeDirtyRegion() {
 	int clip_code = 0xf;
 
@@ -347,17 +568,41 @@ void RasterizationDrawCall::computeDirtyRegion() {
 
 void RasterizationDrawCall::execute(bool restoreState, const Common::Rect *clippingRectangle) const {
 	GLContext *c = gl_get_context();
+	// Rasterization modifies the vertices, which have to be kept intact to be
+	// compared with the ones of the next frame.
+	GLVertex *vertex = c->_enableDirtyRectangles ? copyVertices(c->_drawCallVertexBuffer) : _vertex;
+	rasterize(c, vertex, restoreState, clippingRectangle);
+}
 
+void RasterizationDrawCall::execute(GLContext *c, Common::Array<GLVertex> &vertexBuffer, const Common::Rect *clippingRectangle) const {
+	// Rasterization modifies the vertices, so every thread works on a copy.
+	rasterize(c, copyVertices(vertexBuffer), false, clippingRectangle);
+}
+
+GLVertex *RasterizationDrawCall::copyVertices(Common::Array<GLVertex> &vertexBuffer) const {
+	if (vertexBuffer.size() < (uint)_vertexCount) {
+		vertexBuffer.resize(_vertexCount);
+	}
+	memcpy(vertexBuffer.data(), _vertex, sizeof(GLVertex) * _vertexCount);
+	return vertexBuffer.data();
+}
+
+bool RasterizationDrawCall::isSelection() const {
+	return _drawTriangleFront == GLContext::gl_draw_triangle_select ||
+	       _drawTriangleBack == GLContext::gl_draw_triangle_select;
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c, GLVertex *vertex, bool restoreState, const Common::Rect *clippingRectangle) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state, clippingRectangle);
+	applyState(c, _state, clippingRectangle);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	c->vertex = vertex;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
@@ -441,13 +686,12 @@ void RasterizationDrawCall::execute(bool restoreState, const Common::Rect *clipp
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState, nullptr);
+		applyState(c, backupState, nullptr);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(GLContext *c) const {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableScissor = c->scissor_test_enabled;
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
@@ -503,8 +747,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state, const Common::Rect *clippingRectangle) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state, const Common::Rect *clippingRectangle) const {
 	c->fb->setupScissor(state.enableScissor, state.scissor, clippingRectangle);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
@@ -595,9 +838,21 @@ BlittingDrawCall::BlittingDrawCall(BlitImage *image, const BlitTransform &transf
 	_imageVersion = tglGetBlitImageVersion(image);
 	if (gl_get_context()->_enableDirtyRectangles) {
 		computeDirtyRegion();
+		computeHash();
 	}
 }
 
+void BlittingDrawCall::computeHash() {
+	uint32 hash = hashCombine(2166136261u, _mode);
+	hash = hashPointer(hash, _image);
+	hash = hashCombine(hash, _imageVersion);
+	hash = hashCombine(hash, _transform._destinationRectangle.left);
+	hash = hashCombine(hash, _transform._destinationRectangle.top);
+	hash = hashCombine(hash, _transform._destinationRectangle.right);
+	hash = hashCombine(hash, _transform._destinationRectangle.bottom);
+	_hash = hash;
+}
+
 BlittingDrawCall::~BlittingDrawCall() {
 	tglDeleteBlitImage(_image);
 }
@@ -714,9 +969,20 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	TinyGL::GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
 		_dirtyRegion = c->renderRect;
+		computeHash();
 	}
 }
 
+void ClearBufferDrawCall::computeHash() {
+	uint32 hash = hashCombine(2166136261u, _clearZBuffer | (_clearColorBuffer << 1) | (_clearStencilBuffer << 2));
+	hash = hashCombine(hash, _zValue);
+	hash = hashCombine(hash, _rValue);
+	hash = hashCombine(hash, _gValue);
+	hash = hashCombine(hash, _bValue);
+	hash = hashCombine(hash, _stencilValue);
+	_hash = hash;
+}
+
 void ClearBufferDrawCall::execute(bool restoreState, const Common::Rect *clippingRectangle) const {
 	ClearBufferState backupState;
 	if (restoreState) {
@@ -66,7 +66,7 @@ public:
 		DrawCall_Clear
 	};
 
-	DrawCall(DrawCallType type) : _type(type) { }
+	DrawCall(DrawCallType type) : _type(type), _hash(0) { }
 	virtual ~DrawCall() { }
 	bool operator==(const DrawCall &other) const;
 	bool operator!=(const DrawCall &other) const {
@@ -74,9 +74,14 @@ public:
 	}
 	virtual void execute(bool restoreState, const Common::Rect *clippingRectangle = nullptr) const = 0;
 	DrawCallType getType() const { return _type; }
-	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
+	// Both the dirty region and the hash are only computed when dirty rectangles are enabled.
+	const Common::Rect &getDirtyRegion() const { return _dirtyRegion; }
+	uint32 getHash() const { return _hash; }
 protected:
 	Common::Rect _dirtyRegion;
+	// Hash of the values compared by operator==, so that most different calls
+	// are told apart without comparing all of their vertices and state.
+	uint32 _hash;
 private:
 	DrawCallType _type;
 };
@@ -94,6 +99,7 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	void computeHash();
 	bool _clearZBuffer, _clearColorBuffer, _clearStencilBuffer;
 	int _rValue, _gValue, _bValue, _zValue, _stencilValue;
 	struct ClearBufferState {
@@ -123,6 +129,9 @@ public:
 	virtual ~RasterizationDrawCall() { }
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState, const Common::Rect *clippingRectangle = nullptr) const;
+	// Rasterize on a worker context, using vertexBuffer for a private copy of the vertices.
+	void execute(GLContext *c, Common::Array<GLVertex> &vertexBuffer, const Common::Rect *clippingRectangle) const;
+	bool isSelection() const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -131,6 +140,9 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void computeHash();
+	GLVertex *copyVertices(Common::Array<GLVertex> &vertexBuffer) const;
+	void rasterize(GLContext *c, GLVertex *vertex, bool restoreState, const Common::Rect *clippingRectangle) const;
 	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	GLVertex *_vertex;
@@ -191,8 +203,8 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state, const Common::Rect *clippingRectangle) const;
+	RasterizationState captureState(GLContext *c) const;
+	void applyState(GLContext *c, const RasterizationState &state, const Common::Rect *clippingRectangle) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -218,6 +230,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void computeHash();
 	BlitImage *_image;
 	BlitTransform _transform;
 	BlittingMode _mode;
@@ -37,12 +37,17 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/tinygl.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zmath.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 namespace TinyGL {
 
 enum {
@@ -275,6 +280,7 @@ private:
 };
 
 struct GLContext;
+struct RasterizationBand;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -467,10 +473,17 @@ struct GLContext {
 	// Draw call queue
 	Common::List<DrawCall *> _drawCallsQueue;
 	Common::List<DrawCall *> _previousFrameDrawCallsQueue;
+	Common::Array<GLVertex> _drawCallVertexBuffer;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
+	PresentStats _presentStats;
+	Common::Array<byte> _dirtyTiles;
+
+	// Threaded rasterization
+	Common::ThreadPool *_rasterizationThreads;
+	Common::Array<RasterizationBand *> _rasterizationBands;
 
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
@@ -528,6 +541,9 @@ public:
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
+	void executeDrawCalls(const Common::Array<Common::Rect> &regions);
+	void executeDrawCallsThreaded(const Common::Array<Common::Rect> &regions);
+	void setRasterizationThreads(uint numThreads);
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+// Unsigned comparison of the depth values against the ones in the buffer,
+// like FrameBuffer::compareDepth()
+static FORCEINLINE __m256i avx2_testDepth(int func, __m256i z, __m256i zDst) {
+	const __m256i sign = _mm256_set1_epi32((int32)0x80000000);
+	z = _mm256_xor_si256(z, sign);
+	zDst = _mm256_xor_si256(zDst, sign);
+
+	switch (func) {
+	case TGL_LESS:
+		return _mm256_cmpgt_epi32(z, zDst);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(z, zDst);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(zDst, z), _mm256_set1_epi32(-1));
+	case TGL_GREATER:
+		return _mm256_cmpgt_epi32(zDst, z);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(z, zDst), _mm256_set1_epi32(-1));
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(z, zDst), _mm256_set1_epi32(-1));
+	case TGL_ALWAYS:
+		return _mm256_set1_epi32(-1);
+	default:
+		return _mm256_setzero_si256();
+	}
+}
+
+// Same as (uint)(float)z, see sse2_roundDepth()
+static FORCEINLINE __m256i avx2_roundDepth(__m256i z) {
+	const __m256 hi = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(z, 16)), _mm256_set1_ps(65536.0f));
+	__m256 f = _mm256_add_ps(hi, _mm256_cvtepi32_ps(_mm256_and_si256(z, _mm256_set1_epi32(0xFFFF))));
+	const __m256 big = _mm256_cmp_ps(f, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+	f = _mm256_sub_ps(f, _mm256_and_ps(big, _mm256_set1_ps(2147483648.0f)));
+	return _mm256_xor_si256(_mm256_cvttps_epi32(f), _mm256_slli_epi32(_mm256_castps_si256(big), 31));
+}
+
+static FORCEINLINE __m256i avx2_depthOffsets(uint z, int dzdx) {
+	const uint d = dzdx;
+	return _mm256_add_epi32(_mm256_set1_epi32(z), _mm256_set_epi32(7 * d, 6 * d, 5 * d, 4 * d, 3 * d, 2 * d, d, 0));
+}
+
+void SpanFill::flatAVX2(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params) {
+	const __m256i color = _mm256_set1_epi32(params.color);
+	const __m256i colorMask = _mm256_set1_epi32(params.colorMask);
+	const __m256i constMask = _mm256_set1_epi32(params.constMask);
+	const __m256i dstFactor = _mm256_set1_epi16(params.dstFactor);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i dz = _mm256_set1_epi32(8 * (uint)dzdx);
+	__m256i zv = avx2_depthOffsets(z, dzdx);
+
+	// 8 pixels per iteration. Unpacking and packing both work within 128-bit
+	// lanes, so the pixel order is preserved.
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i pass = _mm256_set1_epi32(-1);
+		if (params.depthFunc != TGL_ALWAYS) {
+			const __m256i zDst = _mm256_loadu_si256((const __m256i *)(pz + i));
+			pass = avx2_testDepth(params.depthFunc, zv, zDst);
+			if (params.depthWrite)
+				_mm256_storeu_si256((__m256i *)(pz + i), _mm256_blendv_epi8(zDst, avx2_roundDepth(zv), pass));
+		} else if (params.depthWrite) {
+			_mm256_storeu_si256((__m256i *)(pz + i), avx2_roundDepth(zv));
+		}
+		zv = _mm256_add_epi32(zv, dz);
+
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(pixels + i));
+		const __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), dstFactor), 8);
+		const __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), dstFactor), 8);
+		__m256i out = _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), color);
+		out = _mm256_or_si256(_mm256_and_si256(out, colorMask), constMask);
+		_mm256_storeu_si256((__m256i *)(pixels + i), _mm256_blendv_epi8(dst, out, pass));
+	}
+
+	flatGeneric(pixels + i, pz + i, count - i, z + i * (uint)dzdx, dzdx, params);
+}
+
+uint SpanFill::depthAVX2(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite) {
+	const __m256i zv = avx2_depthOffsets(z, dzdx);
+	const __m256i zDst = _mm256_loadu_si256((const __m256i *)pz);
+	const __m256i pass = avx2_testDepth(depthFunc, zv, zDst);
+	if (depthWrite)
+		_mm256_storeu_si256((__m256i *)pz, _mm256_blendv_epi8(zDst, avx2_roundDepth(zv), pass));
+	return _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+}
+
+} // end of namespace TinyGL
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
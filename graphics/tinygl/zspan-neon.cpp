@@ -0,0 +1,152 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace TinyGL {
+
+// Comparison of the depth values against the ones in the buffer, like
+// FrameBuffer::compareDepth()
+static FORCEINLINE uint32x4_t neon_testDepth(int func, uint32x4_t z, uint32x4_t zDst) {
+	switch (func) {
+	case TGL_LESS:
+		return vcltq_u32(zDst, z);
+	case TGL_EQUAL:
+		return vceqq_u32(zDst, z);
+	case TGL_LEQUAL:
+		return vcleq_u32(zDst, z);
+	case TGL_GREATER:
+		return vcgtq_u32(zDst, z);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(zDst, z));
+	case TGL_GEQUAL:
+		return vcgeq_u32(zDst, z);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xFFFFFFFF);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+// Same as (uint)(float)z, both conversions round like C does
+static FORCEINLINE uint32x4_t neon_roundDepth(uint32x4_t z) {
+	return vcvtq_u32_f32(vcvtq_f32_u32(z));
+}
+
+static FORCEINLINE uint32x4_t neon_depthOffsets(uint z, int dzdx) {
+	const uint32 d = dzdx;
+	const uint32 offsets[4] = { 0, d, 2 * d, 3 * d };
+	return vaddq_u32(vdupq_n_u32(z), vld1q_u32(offsets));
+}
+
+static FORCEINLINE uint neon_movemask(uint32x4_t v) {
+	static const uint32 bits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t masked = vandq_u32(v, vld1q_u32(bits));
+	uint32x2_t sum = vpadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+	sum = vpadd_u32(sum, sum);
+	return vget_lane_u32(sum, 0);
+}
+
+void SpanFill::flatNEON(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params) {
+	const uint8x16_t color = vreinterpretq_u8_u32(vdupq_n_u32(params.color));
+	const uint32x4_t colorMask = vdupq_n_u32(params.colorMask);
+	const uint32x4_t constMask = vdupq_n_u32(params.constMask);
+	const uint16x8_t dstFactor = vdupq_n_u16(params.dstFactor);
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint32)dzdx);
+	uint32x4_t zv = neon_depthOffsets(z, dzdx);
+
+	// 4 pixels per iteration
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		uint32x4_t pass = vdupq_n_u32(0xFFFFFFFF);
+		if (params.depthFunc != TGL_ALWAYS) {
+			const uint32x4_t zDst = vld1q_u32((const uint32 *)(pz + i));
+			pass = neon_testDepth(params.depthFunc, zv, zDst);
+			if (params.depthWrite)
+				vst1q_u32((uint32 *)(pz + i), vbslq_u32(pass, neon_roundDepth(zv), zDst));
+		} else if (params.depthWrite) {
+			vst1q_u32((uint32 *)(pz + i), neon_roundDepth(zv));
+		}
+		zv = vaddq_u32(zv, dz);
+
+		// Scale every byte of the destination, then add the source with
+		// unsigned saturation, which is the same as clamping to 255
+		const uint32x4_t dst = vld1q_u32(pixels + i);
+		const uint8x16_t dst8 = vreinterpretq_u8_u32(dst);
+		const uint16x8_t lo = vshrq_n_u16(vmulq_u16(vmovl_u8(vget_low_u8(dst8)), dstFactor), 8);
+		const uint16x8_t hi = vshrq_n_u16(vmulq_u16(vmovl_u8(vget_high_u8(dst8)), dstFactor), 8);
+		const uint8x16_t out8 = vqaddq_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)), color);
+		const uint32x4_t out = vorrq_u32(vandq_u32(vreinterpretq_u32_u8(out8), colorMask), constMask);
+		vst1q_u32(pixels + i, vbslq_u32(pass, out, dst));
+	}
+
+	flatGeneric(pixels + i, pz + i, count - i, z + i * (uint)dzdx, dzdx, params);
+}
+
+uint SpanFill::depthNEON(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite) {
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint32)dzdx);
+	uint32x4_t zv = neon_depthOffsets(z, dzdx);
+
+	// Both halves of the 8 pixels
+	uint result = 0;
+	for (int i = 0; i < 8; i += 4) {
+		const uint32x4_t zDst = vld1q_u32((const uint32 *)(pz + i));
+		const uint32x4_t pass = neon_testDepth(depthFunc, zv, zDst);
+		if (depthWrite)
+			vst1q_u32((uint32 *)(pz + i), vbslq_u32(pass, neon_roundDepth(zv), zDst));
+		result |= neon_movemask(pass) << i;
+		zv = vaddq_u32(zv, dz);
+	}
+
+	return result;
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,148 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace TinyGL {
+
+// Unsigned comparison of the depth values against the ones in the buffer,
+// like FrameBuffer::compareDepth(). SSE2 only compares signed integers, so
+// the sign bits are flipped first.
+static FORCEINLINE __m128i sse2_testDepth(int func, __m128i z, __m128i zDst) {
+	const __m128i sign = _mm_set1_epi32((int32)0x80000000);
+	z = _mm_xor_si128(z, sign);
+	zDst = _mm_xor_si128(zDst, sign);
+
+	switch (func) {
+	case TGL_LESS:
+		return _mm_cmpgt_epi32(z, zDst);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(z, zDst);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(zDst, z), _mm_set1_epi32(-1));
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(zDst, z);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(z, zDst), _mm_set1_epi32(-1));
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(z, zDst), _mm_set1_epi32(-1));
+	case TGL_ALWAYS:
+		return _mm_set1_epi32(-1);
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+// Same as (uint)(float)z. The halves are converted separately as SSE2 only
+// converts signed integers, and their sum is rounded only once.
+static FORCEINLINE __m128i sse2_roundDepth(__m128i z) {
+	const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(z, 16)), _mm_set1_ps(65536.0f));
+	__m128 f = _mm_add_ps(hi, _mm_cvtepi32_ps(_mm_and_si128(z, _mm_set1_epi32(0xFFFF))));
+	const __m128 big = _mm_cmpge_ps(f, _mm_set1_ps(2147483648.0f));
+	f = _mm_sub_ps(f, _mm_and_ps(big, _mm_set1_ps(2147483648.0f)));
+	return _mm_xor_si128(_mm_cvttps_epi32(f), _mm_slli_epi32(_mm_castps_si128(big), 31));
+}
+
+static FORCEINLINE __m128i sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+void SpanFill::flatSSE2(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params) {
+	const __m128i color = _mm_set1_epi32(params.color);
+	const __m128i colorMask = _mm_set1_epi32(params.colorMask);
+	const __m128i constMask = _mm_set1_epi32(params.constMask);
+	const __m128i dstFactor = _mm_set1_epi16(params.dstFactor);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i dz = _mm_set1_epi32(4 * (uint)dzdx);
+	__m128i zv = _mm_add_epi32(_mm_set1_epi32(z), _mm_set_epi32(3 * (uint)dzdx, 2 * (uint)dzdx, dzdx, 0));
+
+	// 4 pixels per iteration
+	uint i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i pass = _mm_set1_epi32(-1);
+		if (params.depthFunc != TGL_ALWAYS) {
+			const __m128i zDst = _mm_loadu_si128((const __m128i *)(pz + i));
+			pass = sse2_testDepth(params.depthFunc, zv, zDst);
+			if (params.depthWrite)
+				_mm_storeu_si128((__m128i *)(pz + i), sse2_select(pass, sse2_roundDepth(zv), zDst));
+		} else if (params.depthWrite) {
+			_mm_storeu_si128((__m128i *)(pz + i), sse2_roundDepth(zv));
+		}
+		zv = _mm_add_epi32(zv, dz);
+
+		// Scale every byte of the destination, then add the source with
+		// unsigned saturation, which is the same as clamping to 255
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(pixels + i));
+		const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), dstFactor), 8);
+		const __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), dstFactor), 8);
+		__m128i out = _mm_adds_epu8(_mm_packus_epi16(lo, hi), color);
+		out = _mm_or_si128(_mm_and_si128(out, colorMask), constMask);
+		_mm_storeu_si128((__m128i *)(pixels + i), sse2_select(pass, out, dst));
+	}
+
+	flatGeneric(pixels + i, pz + i, count - i, z + i * (uint)dzdx, dzdx, params);
+}
+
+uint SpanFill::depthSSE2(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite) {
+	const __m128i dz = _mm_set1_epi32(4 * (uint)dzdx);
+	__m128i zv = _mm_add_epi32(_mm_set1_epi32(z), _mm_set_epi32(3 * (uint)dzdx, 2 * (uint)dzdx, dzdx, 0));
+
+	// Both halves of the 8 pixels
+	uint result = 0;
+	for (int i = 0; i < 8; i += 4) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)(pz + i));
+		const __m128i pass = sse2_testDepth(depthFunc, zv, zDst);
+		if (depthWrite)
+			_mm_storeu_si128((__m128i *)(pz + i), sse2_select(pass, sse2_roundDepth(zv), zDst));
+		result |= _mm_movemask_ps(_mm_castsi128_ps(pass)) << i;
+		zv = _mm_add_epi32(zv, dz);
+	}
+
+	return result;
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+SpanFill::FlatFunc SpanFill::flatFunc = nullptr;
+SpanFill::DepthFunc SpanFill::depthFunc = nullptr;
+
+void SpanFill::selectFuncs() {
+	flatFunc = flatGeneric;
+	depthFunc = depthGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		flatFunc = flatNEON;
+		depthFunc = depthNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		flatFunc = flatSSE2;
+		depthFunc = depthSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		flatFunc = flatAVX2;
+		depthFunc = depthAVX2;
+	}
+#endif
+}
+
+SpanFill::FlatFunc SpanFill::getFlatFunc() {
+	// If no function has been selected yet, detect and select. The CPU
+	// features are only known once there is an OSystem.
+	if (!flatFunc) {
+		if (!g_system)
+			return nullptr;
+		selectFuncs();
+	}
+
+	return flatFunc != flatGeneric ? flatFunc : nullptr;
+}
+
+SpanFill::DepthFunc SpanFill::getDepthFunc() {
+	if (!depthFunc) {
+		if (!g_system)
+			return nullptr;
+		selectFuncs();
+	}
+
+	return depthFunc != depthGeneric ? depthFunc : nullptr;
+}
+
+// Same as FrameBuffer::compareDepth()
+static inline bool testDepth(int func, uint z, uint zDst) {
+	switch (func) {
+	case TGL_LESS:
+		return zDst < z;
+	case TGL_EQUAL:
+		return zDst == z;
+	case TGL_LEQUAL:
+		return zDst <= z;
+	case TGL_GREATER:
+		return zDst > z;
+	case TGL_NOTEQUAL:
+		return zDst != z;
+	case TGL_GEQUAL:
+		return zDst >= z;
+	case TGL_ALWAYS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void SpanFill::flatGeneric(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params) {
+	for (uint i = 0; i < count; i++, z += dzdx) {
+		if (params.depthFunc != TGL_ALWAYS && !testDepth(params.depthFunc, z, pz[i]))
+			continue;
+		if (params.depthWrite)
+			pz[i] = (uint)(float)z;
+
+		const uint32 dst = pixels[i];
+		uint32 out = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint value = ((params.color >> shift) & 0xFF) + ((((dst >> shift) & 0xFF) * params.dstFactor) >> 8);
+			out |= MIN<uint>(value, 255) << shift;
+		}
+		pixels[i] = (out & params.colorMask) | params.constMask;
+	}
+}
+
+uint SpanFill::depthGeneric(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite) {
+	uint result = 0;
+	for (uint i = 0; i < 8; i++, z += dzdx) {
+		if (!testDepth(depthFunc, z, pz[i]))
+			continue;
+		if (depthWrite)
+			pz[i] = (uint)(float)z;
+		result |= 1 << i;
+	}
+	return result;
+}
+
+} // end of namespace TinyGL
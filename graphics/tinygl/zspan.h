@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H_
+#define GRAPHICS_TINYGL_ZSPAN_H_
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * Span kernels used by FrameBuffer::fillTriangle for its most common cases,
+ * processing several pixels of a scanline at once.
+ *
+ * Like BlendBlit, the implementation is selected at runtime depending on the
+ * SIMD instruction sets supported by the CPU. All implementations produce the
+ * exact same output as the per-pixel code, including the rounding of depth
+ * values which are written through a float.
+ */
+class SpanFill {
+public:
+	/**
+	 * Parameters of a flat shaded, untextured span in a 32-bit frame buffer
+	 * with 8 bits per color channel.
+	 *
+	 * Every byte of a pixel is computed as
+	 * min(255, color + ((dst * dstFactor) >> 8)), then masked with colorMask
+	 * and combined with constMask, which covers both blended and opaque
+	 * writes with the source factors folded into color.
+	 */
+	struct FlatParams {
+		uint32 color;
+		uint32 colorMask;
+		uint32 constMask;
+		uint dstFactor;   ///< 0 to 256
+		int depthFunc;    ///< TGL_ALWAYS if the depth test is disabled
+		bool depthWrite;
+	};
+
+	/**
+	 * Fill @p count pixels of a flat shaded span, starting with the depth
+	 * value @p z which is incremented by @p dzdx for every pixel.
+	 */
+	typedef void(*FlatFunc)(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params);
+
+	/**
+	 * Depth test 8 pixels, starting with the depth value @p z which is
+	 * incremented by @p dzdx for every pixel. The depth of the pixels passing
+	 * the test is written if @p depthWrite is set.
+	 *
+	 * @return The mask of the pixels passing the test, one bit per pixel.
+	 */
+	typedef uint(*DepthFunc)(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite);
+
+	/** Currently selected implementations, nullptr until first used. */
+	static FlatFunc flatFunc;
+	static DepthFunc depthFunc;
+
+	/**
+	 * Return the implementations to use, detecting the CPU features first if
+	 * needed. These return nullptr if no vectorized implementation is
+	 * available, in which case the per-pixel code is faster.
+	 */
+	static FlatFunc getFlatFunc();
+	static DepthFunc getDepthFunc();
+
+	static void flatGeneric(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params);
+	static uint depthGeneric(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite);
+#ifdef SCUMMVM_NEON
+	static void flatNEON(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params);
+	static uint depthNEON(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void flatSSE2(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params);
+	static uint depthSSE2(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void flatAVX2(uint32 *pixels, uint *pz, uint count, uint z, int dzdx, const FlatParams &params);
+	static uint depthAVX2(uint *pz, uint z, int dzdx, int depthFunc, bool depthWrite);
+#endif
+
+private:
+	static void selectFuncs();
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -29,6 +29,7 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -45,6 +46,69 @@ static bool applyStipplePattern(int x, int y, const byte *stipple) {
 	return (stipple[byteIndex] & bitmask);
 }
 
+bool FrameBuffer::setupFlatSpan(SpanFill::FlatParams &params, byte aSrc, byte rSrc, byte gSrc, byte bSrc, bool depthWrite) const {
+	// The span functions work on whole bytes of 32-bit pixels
+	if (_pbufBpp != 4 || _pbufFormat.rLoss != 0 || _pbufFormat.gLoss != 0 || _pbufFormat.bLoss != 0 ||
+	    (_pbufFormat.aLoss != 0 && _pbufFormat.aLoss != 8) ||
+	    ((_pbufFormat.rShift | _pbufFormat.gShift | _pbufFormat.bShift | _pbufFormat.aShift) & 7) != 0)
+		return false;
+
+	if (!_blendingEnabled) {
+		params.color = _pbufFormat.ARGBToColor(aSrc, rSrc, gSrc, bSrc);
+		params.colorMask = 0xFFFFFFFF;
+		params.constMask = 0;
+		params.dstFactor = 0;
+	} else {
+		// Only the blending factors which don't depend on the destination,
+		// computed like in writePixel()
+		switch (_sourceBlendingFactor) {
+		case TGL_ZERO:
+			rSrc = gSrc = bSrc = 0;
+			break;
+		case TGL_ONE:
+			break;
+		case TGL_SRC_ALPHA:
+			rSrc = (rSrc * aSrc) >> 8;
+			gSrc = (gSrc * aSrc) >> 8;
+			bSrc = (bSrc * aSrc) >> 8;
+			break;
+		case TGL_ONE_MINUS_SRC_ALPHA:
+			rSrc = (rSrc * (255 - aSrc)) >> 8;
+			gSrc = (gSrc * (255 - aSrc)) >> 8;
+			bSrc = (bSrc * (255 - aSrc)) >> 8;
+			break;
+		default:
+			return false;
+		}
+
+		switch (_destinationBlendingFactor) {
+		case TGL_ZERO:
+			params.dstFactor = 0;
+			break;
+		case TGL_ONE:
+			params.dstFactor = 256;
+			break;
+		case TGL_SRC_ALPHA:
+			params.dstFactor = aSrc;
+			break;
+		case TGL_ONE_MINUS_SRC_ALPHA:
+			params.dstFactor = 255 - aSrc;
+			break;
+		default:
+			return false;
+		}
+
+		// Blended pixels are always opaque
+		params.constMask = _pbufFormat.ARGBToColor(255, 0, 0, 0);
+		params.colorMask = _pbufFormat.RGBToColor(255, 255, 255) & ~params.constMask;
+		params.color = _pbufFormat.RGBToColor(rSrc, gSrc, bSrc) & params.colorMask;
+	}
+
+	params.depthFunc = _depthTestEnabled ? _depthFunc : TGL_ALWAYS;
+	params.depthWrite = depthWrite;
+	return true;
+}
+
 template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
@@ -254,6 +318,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	if (kEnableScissor && (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom))
+		return;
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -364,6 +431,23 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		a1 = p2->a;
 	}
 
+	// Vectorized span functions for flat shaded triangles, and for the depth
+	// test of textured ones. They don't support the stencil and alpha tests.
+	SpanFill::FlatFunc flatSpanFunc = nullptr;
+	SpanFill::DepthFunc depthSpanFunc = nullptr;
+	SpanFill::FlatParams flatSpanParams;
+	if (colorMode != ColorMode::NoInterpolation && kInterpZ && !kStencilEnabled && !kAlphaTestEnabled) {
+		if (kInterpST || kInterpSTZ) {
+			if (kDepthTestEnabled || kDepthWrite)
+				depthSpanFunc = SpanFill::getDepthFunc();
+		} else if (!kSmoothMode && !kFogMode && !stippleEnabled) {
+			flatSpanFunc = SpanFill::getFlatFunc();
+			if (flatSpanFunc && !setupFlatSpan(flatSpanParams, a1 >> (ZB_POINT_ALPHA_BITS - 8), r1 >> (ZB_POINT_RED_BITS - 8),
+			                                   g1 >> (ZB_POINT_GREEN_BITS - 8), b1 >> (ZB_POINT_BLUE_BITS - 8), kDepthWrite))
+				flatSpanFunc = nullptr;
+		}
+	}
+
 	if (colorMode != ColorMode::NoInterpolation && (kInterpST || kInterpSTZ)) {
 		texture = _currentTexture;
 		fdzdx = (float)dzdx;
@@ -482,8 +566,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			// Nothing below the clipping rectangle can be drawn, and rows above it
+			// only need to advance the edges. When a frame is rendered in bands,
+			// most rows of a triangle are outside of the band.
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
 			int x = x1;
-			if (colorMode == ColorMode::NoInterpolation) {
+			if (kEnableScissor && y < _clipRectangle.top) {
+				// Skip the scanline
+			} else if (colorMode == ColorMode::NoInterpolation) {
 				int n;
 				uint *pz = nullptr;
 				byte *ps = nullptr;
@@ -521,6 +612,17 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					n -= 1;
 					x += 1;
 				}
+			} else if (flatSpanFunc) {
+				int start = x1;
+				int end = (x2 >> 16) + 1;
+				if (kEnableScissor) {
+					start = MAX<int>(start, _clipRectangle.left);
+					end = MIN<int>(end, _clipRectangle.right);
+				}
+				if (start < end) {
+					flatSpanFunc((uint32 *)_pbuf + pp1 + start, pz1 + start, end - start,
+					             (uint)z1 + (uint)(start - x1) * (uint)dzdx, dzdx, flatSpanParams);
+				}
 			} else if (!(kInterpST || kInterpSTZ)) {
 				uint *pz = nullptr;
 				byte *ps = nullptr;
@@ -616,9 +718,35 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					// Blocks which are partly clipped may be outside of the buffers
+					if (depthSpanFunc && (!kEnableScissor || (x >= _clipRectangle.left && x + NB_INTERP <= _clipRectangle.right))) {
+						// Depth test the whole block at once, then only fetch the
+						// texels of the pixels which are visible
+						const uint mask = depthSpanFunc(pz, z, dzdx, _depthTestEnabled ? _depthFunc : TGL_ALWAYS, kDepthWrite);
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							if (mask & (1 << _a)) {
+								putPixelTexture<false, kSmoothMode, kFogMode, false, false, kBlendingEnabled, false, false>
+								               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+							} else {
+								z += dzdx;
+								s += dsdx;
+								t += dtdx;
+								if (kFogMode) {
+									fog += dfdx;
+								}
+								if (kSmoothMode) {
+									a += dadx;
+									r += drdx;
+									g += dgdx;
+									b += dbdx;
+								}
+							}
+						}
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, colorMode, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+// The truncated product of signed chroma values, see YUVToRGBRow
+static FORCEINLINE __m256i avx2_truncMul(__m256i c, int frac, bool whole) {
+	const __m256i a = _mm256_abs_epi16(c);
+	__m256i m = _mm256_mulhi_epu16(a, _mm256_set1_epi16(frac));
+	if (whole)
+		m = _mm256_add_epi16(m, a);
+	return _mm256_sign_epi16(m, c);
+}
+
+static FORCEINLINE __m256i avx2_clampValue(__m256i x, const YUVToRGBRow::Params &params) {
+	x = _mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(params.minValue)), _mm256_set1_epi16(params.maxValue));
+	if (params.itu) {
+		x = _mm256_sub_epi16(x, _mm256_set1_epi16(16));
+		x = _mm256_add_epi16(x, _mm256_mulhi_epu16(x, _mm256_set1_epi16(YUVToRGBRow::kITUFrac)));
+	}
+	return x;
+}
+
+static FORCEINLINE __m256i avx2_loadChroma(const byte *src, uint x, bool halfChroma) {
+	__m128i c;
+	if (halfChroma) {
+		c = _mm_loadl_epi64((const __m128i *)(src + (x >> 1)));
+		c = _mm_unpacklo_epi8(c, c);
+	} else {
+		c = _mm_loadu_si128((const __m128i *)(src + x));
+	}
+	return _mm256_sub_epi16(_mm256_cvtepu8_epi16(c), _mm256_set1_epi16(128));
+}
+
+static FORCEINLINE __m256i avx2_packPixels(__m128i r, __m128i g, __m128i b, __m128i rShift, __m128i gShift, __m128i bShift, __m256i aMask) {
+	__m256i out = _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), rShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), gShift));
+	return _mm256_or_si256(out, _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(b), bShift), aMask));
+}
+
+template<typename PixelInt>
+static void avx2_convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const YUVToRGBRow::Params &params) {
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	// 16 pixels per iteration. The bytes are widened across the whole
+	// registers, so the pixel order is preserved.
+	uint x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		const __m256i u = avx2_loadChroma(uSrc, x, halfChroma);
+		const __m256i v = avx2_loadChroma(vSrc, x, halfChroma);
+
+		__m256i r = avx2_clampValue(_mm256_add_epi16(y, avx2_truncMul(v, YUVToRGBRow::kCrRFrac, true)), params);
+		__m256i g = avx2_clampValue(_mm256_sub_epi16(_mm256_sub_epi16(y, avx2_truncMul(v, YUVToRGBRow::kCrGFrac, false)),
+		                                             avx2_truncMul(u, YUVToRGBRow::kCbGFrac, false)), params);
+		__m256i b = avx2_clampValue(_mm256_add_epi16(y, avx2_truncMul(u, YUVToRGBRow::kCbBFrac, true)), params);
+		r = _mm256_srl_epi16(r, rLoss);
+		g = _mm256_srl_epi16(g, gLoss);
+		b = _mm256_srl_epi16(b, bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m256i out = _mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift));
+			out = _mm256_or_si256(out, _mm256_or_si256(_mm256_sll_epi16(b, bShift), _mm256_set1_epi16(params.aMask)));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), out);
+		} else {
+			const __m256i aMask = _mm256_set1_epi32(params.aMask);
+			const __m256i lo = avx2_packPixels(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b),
+			                                   rShift, gShift, bShift, aMask);
+			const __m256i hi = avx2_packPixels(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1),
+			                                   rShift, gShift, bShift, aMask);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	const uint chromaX = halfChroma ? x >> 1 : x;
+	YUVToRGBRow::convertGeneric(dst + x * sizeof(PixelInt), ySrc + x, uSrc + chromaX, vSrc + chromaX, width - x, halfChroma, params);
+}
+
+void YUVToRGBRow::convertAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params) {
+	if (params.bytesPerPixel == 2)
+		avx2_convertRow<uint16>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+	else
+		avx2_convertRow<uint32>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+}
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
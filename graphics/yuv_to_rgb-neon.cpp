@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+static FORCEINLINE uint16x8_t neon_mulhi(uint16x8_t a, uint16 frac) {
+	return vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(a), frac), 16),
+	                    vshrn_n_u32(vmull_n_u16(vget_high_u16(a), frac), 16));
+}
+
+// The truncated product of signed chroma values, see YUVToRGBRow
+static FORCEINLINE int16x8_t neon_truncMul(int16x8_t c, uint16 frac, bool whole) {
+	const uint16x8_t a = vreinterpretq_u16_s16(vabsq_s16(c));
+	uint16x8_t m = neon_mulhi(a, frac);
+	if (whole)
+		m = vaddq_u16(m, a);
+	const int16x8_t s = vreinterpretq_s16_u16(m);
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(s), s);
+}
+
+static FORCEINLINE uint16x8_t neon_clampValue(int16x8_t x, const YUVToRGBRow::Params &params) {
+	x = vminq_s16(vmaxq_s16(x, vdupq_n_s16(params.minValue)), vdupq_n_s16(params.maxValue));
+	uint16x8_t value = vreinterpretq_u16_s16(x);
+	if (params.itu) {
+		value = vsubq_u16(value, vdupq_n_u16(16));
+		value = vaddq_u16(value, neon_mulhi(value, YUVToRGBRow::kITUFrac));
+	}
+	return value;
+}
+
+static FORCEINLINE int16x8_t neon_loadChroma(const byte *src, uint x, bool halfChroma) {
+	uint8x8_t c;
+	if (halfChroma) {
+		uint32 pair;
+		memcpy(&pair, src + (x >> 1), sizeof(pair));
+		c = vreinterpret_u8_u32(vdup_n_u32(pair));
+		c = vzip_u8(c, c).val[0];
+	} else {
+		c = vld1_u8(src + x);
+	}
+	return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(128));
+}
+
+static FORCEINLINE uint32x4_t neon_packPixels(uint16x4_t r, uint16x4_t g, uint16x4_t b, const YUVToRGBRow::Params &params) {
+	uint32x4_t out = vorrq_u32(vshlq_u32(vmovl_u16(r), vdupq_n_s32(params.rShift)), vshlq_u32(vmovl_u16(g), vdupq_n_s32(params.gShift)));
+	return vorrq_u32(out, vorrq_u32(vshlq_u32(vmovl_u16(b), vdupq_n_s32(params.bShift)), vdupq_n_u32(params.aMask)));
+}
+
+template<typename PixelInt>
+static void neon_convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const YUVToRGBRow::Params &params) {
+	// 8 pixels per iteration
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		const int16x8_t u = neon_loadChroma(uSrc, x, halfChroma);
+		const int16x8_t v = neon_loadChroma(vSrc, x, halfChroma);
+
+		uint16x8_t r = neon_clampValue(vaddq_s16(y, neon_truncMul(v, YUVToRGBRow::kCrRFrac, true)), params);
+		uint16x8_t g = neon_clampValue(vsubq_s16(vsubq_s16(y, neon_truncMul(v, YUVToRGBRow::kCrGFrac, false)),
+		                                         neon_truncMul(u, YUVToRGBRow::kCbGFrac, false)), params);
+		uint16x8_t b = neon_clampValue(vaddq_s16(y, neon_truncMul(u, YUVToRGBRow::kCbBFrac, true)), params);
+
+		// Negative counts shift right
+		r = vshlq_u16(r, vdupq_n_s16(-params.rLoss));
+		g = vshlq_u16(g, vdupq_n_s16(-params.gLoss));
+		b = vshlq_u16(b, vdupq_n_s16(-params.bLoss));
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t out = vorrq_u16(vshlq_u16(r, vdupq_n_s16(params.rShift)), vshlq_u16(g, vdupq_n_s16(params.gShift)));
+			out = vorrq_u16(out, vorrq_u16(vshlq_u16(b, vdupq_n_s16(params.bShift)), vdupq_n_u16(params.aMask)));
+			vst1q_u16((uint16 *)(dst + x * 2), out);
+		} else {
+			vst1q_u32((uint32 *)(dst + x * 4), neon_packPixels(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b), params));
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), neon_packPixels(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b), params));
+		}
+	}
+
+	const uint chromaX = halfChroma ? x >> 1 : x;
+	YUVToRGBRow::convertGeneric(dst + x * sizeof(PixelInt), ySrc + x, uSrc + chromaX, vSrc + chromaX, width - x, halfChroma, params);
+}
+
+void YUVToRGBRow::convertNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params) {
+	if (params.bytesPerPixel == 2)
+		neon_convertRow<uint16>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+	else
+		neon_convertRow<uint32>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+// The truncated product of signed chroma values, see YUVToRGBRow
+static FORCEINLINE __m128i sse2_truncMul(__m128i c, int frac, bool whole) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i a = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	__m128i m = _mm_mulhi_epu16(a, _mm_set1_epi16(frac));
+	if (whole)
+		m = _mm_add_epi16(m, a);
+	return _mm_sub_epi16(_mm_xor_si128(m, sign), sign);
+}
+
+static FORCEINLINE __m128i sse2_clampValue(__m128i x, const YUVToRGBRow::Params &params) {
+	x = _mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(params.minValue)), _mm_set1_epi16(params.maxValue));
+	if (params.itu) {
+		x = _mm_sub_epi16(x, _mm_set1_epi16(16));
+		x = _mm_add_epi16(x, _mm_mulhi_epu16(x, _mm_set1_epi16(YUVToRGBRow::kITUFrac)));
+	}
+	return x;
+}
+
+static FORCEINLINE __m128i sse2_loadChroma(const byte *src, uint x, bool halfChroma) {
+	__m128i c;
+	if (halfChroma) {
+		uint32 pair;
+		memcpy(&pair, src + (x >> 1), sizeof(pair));
+		c = _mm_cvtsi32_si128(pair);
+		c = _mm_unpacklo_epi8(c, c);
+	} else {
+		c = _mm_loadl_epi64((const __m128i *)(src + x));
+	}
+	return _mm_sub_epi16(_mm_unpacklo_epi8(c, _mm_setzero_si128()), _mm_set1_epi16(128));
+}
+
+template<typename PixelInt>
+static void sse2_convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const YUVToRGBRow::Params &params) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	// 8 pixels per iteration
+	uint x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		const __m128i u = sse2_loadChroma(uSrc, x, halfChroma);
+		const __m128i v = sse2_loadChroma(vSrc, x, halfChroma);
+
+		__m128i r = sse2_clampValue(_mm_add_epi16(y, sse2_truncMul(v, YUVToRGBRow::kCrRFrac, true)), params);
+		__m128i g = sse2_clampValue(_mm_sub_epi16(_mm_sub_epi16(y, sse2_truncMul(v, YUVToRGBRow::kCrGFrac, false)),
+		                                          sse2_truncMul(u, YUVToRGBRow::kCbGFrac, false)), params);
+		__m128i b = sse2_clampValue(_mm_add_epi16(y, sse2_truncMul(u, YUVToRGBRow::kCbBFrac, true)), params);
+		r = _mm_srl_epi16(r, rLoss);
+		g = _mm_srl_epi16(g, gLoss);
+		b = _mm_srl_epi16(b, bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i out = _mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift));
+			out = _mm_or_si128(out, _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_set1_epi16(params.aMask)));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), out);
+		} else {
+			const __m128i aMask = _mm_set1_epi32(params.aMask);
+			__m128i lo = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift));
+			lo = _mm_or_si128(lo, _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), aMask));
+			__m128i hi = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift));
+			hi = _mm_or_si128(hi, _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), aMask));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	const uint chromaX = halfChroma ? x >> 1 : x;
+	YUVToRGBRow::convertGeneric(dst + x * sizeof(PixelInt), ySrc + x, uSrc + chromaX, vSrc + chromaX, width - x, halfChroma, params);
+}
+
+void YUVToRGBRow::convertSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params) {
+	if (params.bytesPerPixel == 2)
+		sse2_convertRow<uint16>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+	else
+		sse2_convertRow<uint32>(dst, ySrc, uSrc, vSrc, width, halfChroma, params);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
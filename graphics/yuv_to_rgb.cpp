@@ -82,6 +82,8 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -198,6 +200,78 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+YUVToRGBRow::Params::Params(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	itu = (scale == YUVToRGBManager::kScaleITU);
+	minValue = itu ? 16 : 0;
+	maxValue = itu ? 235 : 255;
+	bytesPerPixel = format.bytesPerPixel;
+	rLoss = format.rLoss;
+	gLoss = format.gLoss;
+	bLoss = format.bLoss;
+	rShift = format.rShift;
+	gShift = format.gShift;
+	bShift = format.bShift;
+	aMask = (0xFF >> format.aLoss) << format.aShift;
+}
+
+// Initialize this to nullptr at the start
+YUVToRGBRow::ConvertFunc YUVToRGBRow::convertFunc = nullptr;
+
+YUVToRGBRow::ConvertFunc YUVToRGBRow::getConvertFunc() {
+	// If no function has been selected yet, detect and select
+	if (!convertFunc) {
+		convertFunc = convertGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) convertFunc = convertNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) convertFunc = convertSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) convertFunc = convertAVX2;
+#endif
+	}
+
+	return convertFunc != convertGeneric ? convertFunc : nullptr;
+}
+
+// The truncated product of a chroma value, see YUVToRGBRow
+static inline int truncMul(int c, uint frac, bool whole) {
+	const int a = ABS(c);
+	const int m = (whole ? a : 0) + ((a * frac) >> 16);
+	return c < 0 ? -m : m;
+}
+
+static inline uint clampValue(int x, const YUVToRGBRow::Params &params) {
+	x = CLIP<int>(x, params.minValue, params.maxValue);
+	if (params.itu) {
+		x -= 16;
+		x += (x * YUVToRGBRow::kITUFrac) >> 16;
+	}
+	return x;
+}
+
+// Same as the lookup tables. The SIMD versions use this for the pixels left
+// at the end of a row.
+void YUVToRGBRow::convertGeneric(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params) {
+	for (uint x = 0; x < width; x++) {
+		const int y = ySrc[x];
+		const int u = uSrc[halfChroma ? x >> 1 : x] - 128;
+		const int v = vSrc[halfChroma ? x >> 1 : x] - 128;
+
+		const uint r = clampValue(y + truncMul(v, kCrRFrac, true), params);
+		const uint g = clampValue(y - truncMul(v, kCrGFrac, false) - truncMul(u, kCbGFrac, false), params);
+		const uint b = clampValue(y + truncMul(u, kCbBFrac, true), params);
+		const uint32 color = ((r >> params.rLoss) << params.rShift) | ((g >> params.gLoss) << params.gShift) |
+		                     ((b >> params.bLoss) << params.bShift) | params.aMask;
+
+		if (params.bytesPerPixel == 2)
+			((uint16 *)dst)[x] = color;
+		else
+			((uint32 *)dst)[x] = color;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &clipTable[(s)]; \
 	*((PixelInt *)(d)) = ((L[cr_r] << r_shift) | (L[crb_g] << g_shift) | (L[cb_b] << b_shift) | a_mask)
@@ -244,6 +318,14 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	YUVToRGBRow::ConvertFunc convertFunc = YUVToRGBRow::getConvertFunc();
+	if (convertFunc) {
+		const YUVToRGBRow::Params params(dst->format, scale);
+		for (int h = 0; h < yHeight; h++)
+			convertFunc((byte *)dst->getBasePtr(0, h), ySrc + h * yPitch, uSrc + h * uvPitch, vSrc + h * uvPitch, yWidth, false, params);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -301,6 +383,14 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 
+	YUVToRGBRow::ConvertFunc convertFunc = YUVToRGBRow::getConvertFunc();
+	if (convertFunc) {
+		const YUVToRGBRow::Params params(dst->format, scale);
+		for (int h = 0; h < yHeight; h++)
+			convertFunc((byte *)dst->getBasePtr(0, h), ySrc + h * yPitch, uSrc + h * uvPitch, vSrc + h * uvPitch, yWidth, true, params);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -362,6 +452,14 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	YUVToRGBRow::ConvertFunc convertFunc = YUVToRGBRow::getConvertFunc();
+	if (convertFunc) {
+		const YUVToRGBRow::Params params(dst->format, scale);
+		for (int h = 0; h < yHeight; h++)
+			convertFunc((byte *)dst->getBasePtr(0, h), ySrc + h * yPitch, uSrc + (h >> 1) * uvPitch, vSrc + (h >> 1) * uvPitch, yWidth, true, params);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -514,6 +612,15 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+// Interpolate the chroma values of a row like convertYUV410ToRGB()
+static void interpolateYUV410Row(byte *dst, const byte *src, int quarterWidth, int uvPitch, int yDiff) {
+	for (int x = 0; x < quarterWidth; x++) {
+		const int a = src[x], b = src[x + 1], c = src[x + uvPitch], d = src[x + uvPitch + 1];
+		for (int xDiff = 0; xDiff < 4; xDiff++)
+			*dst++ = (a * (4 - xDiff) * (4 - yDiff) + b * xDiff * (4 - yDiff) + c * yDiff * (4 - xDiff) + d * xDiff * yDiff) >> 4;
+	}
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -522,6 +629,20 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	YUVToRGBRow::ConvertFunc convertFunc = YUVToRGBRow::getConvertFunc();
+	if (convertFunc) {
+		const YUVToRGBRow::Params params(dst->format, scale);
+		byte *uRow = new byte[yWidth * 2];
+		byte *vRow = uRow + yWidth;
+		for (int h = 0; h < yHeight; h++) {
+			interpolateYUV410Row(uRow, uSrc + (h >> 2) * uvPitch, yWidth >> 2, uvPitch, h & 3);
+			interpolateYUV410Row(vRow, vSrc + (h >> 2) * uvPitch, yWidth >> 2, uvPitch, h & 3);
+			convertFunc((byte *)dst->getBasePtr(0, h), ySrc + h * yPitch, uRow, vRow, yWidth, false, params);
+		}
+		delete[] uRow;
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
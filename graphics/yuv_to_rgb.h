@@ -143,6 +143,74 @@ private:
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
 	YUVToRGBLookup *_lookup;
+};
+
+/**
+ * Converts rows of YUV pixels into 16 or 32 bits per pixel, several pixels
+ * at once, for the YUVToRGBManager conversions.
+ *
+ * Like BlendBlit, the implementation is selected at runtime depending on the
+ * SIMD instruction sets supported by the CPU. Instead of the lookup tables,
+ * the chroma products are computed with fixed point multiplications which
+ * give the exact same results for every possible value, so that all the
+ * implementations produce the same pixels as the lookup tables.
+ */
+class YUVToRGBRow {
+public:
+	/**
+	 * The lookup tables truncate the products of the chroma values from -128
+	 * to 127 with 0.419/0.299, 0.299/0.419, 0.114/0.331 and 0.587/0.331.
+	 * These are exactly the integer parts of the factors times |c|, plus
+	 * (|c| * frac) >> 16 with the following fractions, with the sign of c.
+	 * The ITU range of luminance values is scaled likewise, with
+	 * n + ((n * kITUFrac) >> 16) being n * 255 / 219 for n from 0 to 219.
+	 */
+	enum {
+		kCrRFrac = 26302,
+		kCrGFrac = 46766,
+		kCbGFrac = 22571,
+		kCbBFrac = 50686,
+		kITUFrac = 10774
+	};
+
+	struct Params {
+		Params(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+
+		int16 minValue;
+		int16 maxValue;
+		bool itu;
+		byte bytesPerPixel;
+		byte rLoss, gLoss, bLoss;
+		byte rShift, gShift, bShift;
+		uint32 aMask;
+	};
+
+	/**
+	 * Convert @p width pixels of a row. If @p halfChroma is set, each chroma
+	 * value is used by two pixels and @p width must be even.
+	 */
+	typedef void(*ConvertFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params);
+
+	/** Currently selected implementation, nullptr until first used. */
+	static ConvertFunc convertFunc;
+
+	/**
+	 * Return the implementation to use, detecting the CPU features first if
+	 * needed. This returns nullptr if no vectorized implementation is
+	 * available, in which case the lookup tables are faster.
+	 */
+	static ConvertFunc getConvertFunc();
+
+	static void convertGeneric(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params);
+#ifdef SCUMMVM_NEON
+	static void convertNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void convertSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void convertAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, uint width, bool halfChroma, const Params &params);
+#endif
 };
  /** @} */
 } // End of namespace Graphics
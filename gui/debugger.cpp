@@ -22,14 +22,15 @@
 // NB: This is really only necessary if USE_READLINE is defined
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
+#include "common/archive.h"
 #include "common/file.h"
+#include "common/frametimings.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
 #include "common/md5.h"
-#include "common/archive.h"
 #include "common/macresman.h"
 #include "common/stream.h"
 #endif
@@ -76,6 +77,8 @@ Debugger::Debugger() {
 	registerCmd("clear",			WRAP_METHOD(Debugger, cmdClearLog));
 	registerCmd("cls",			WRAP_METHOD(Debugger, cmdClearLog)); // alias
 	registerCmd("exec",				WRAP_METHOD(Debugger, cmdExecFile));
+	registerCmd("search_stats",		WRAP_METHOD(Debugger, cmdSearchStats));
+	registerCmd("frame_timings",		WRAP_METHOD(Debugger, cmdFrameTimings));
 
 	registerCmd("debuglevel",		WRAP_METHOD(Debugger, cmdDebugLevel));
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
@@ -777,6 +780,55 @@ bool Debugger::cmdDebugLevel(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdSearchStats(int argc, const char **argv) {
+	uint32 cacheHits, cacheMisses;
+	Common::Array<Common::SearchSet::ArchiveLookupStats> archives;
+	SearchMan.getLookupStats(cacheHits, cacheMisses, archives);
+
+	debugPrintf("File lookups: %u cached, %u searched\n", cacheHits, cacheMisses);
+	debugPrintf("Priority    Hits  Misses  Archive\n");
+	for (const auto &archive : archives)
+		debugPrintf("%8d %7u %7u  %s\n", archive.priority, archive.hits, archive.misses, archive.name.c_str());
+	return true;
+}
+
+bool Debugger::cmdFrameTimings(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "on")) {
+		g_system->setFrameTimingsEnabled(true);
+		debugPrintf("Recording frame timings\n");
+		return true;
+	} else if (argc == 2 && !strcmp(argv[1], "off")) {
+		g_system->setFrameTimingsEnabled(false);
+		debugPrintf("Stopped recording frame timings\n");
+		return true;
+	}
+
+	const Common::FrameTimings *timings = g_system->getFrameTimings();
+	if (argc > 1 && (argc != 3 || strcmp(argv[1], "csv"))) {
+		debugPrintf("Usage: %s [on | off | csv <filename>]\n", argv[0]);
+	} else if (!timings) {
+		debugPrintf("Frame timings are not recorded, use '%s on' first\n", argv[0]);
+	} else if (argc == 3) {
+		Common::DumpFile out;
+		if (!out.open(Common::Path(argv[2], Common::Path::kNativeSeparator))) {
+			debugPrintf("Cannot open '%s'\n", argv[2]);
+			return true;
+		}
+		timings->writeCSV(out);
+		out.finalize();
+		debugPrintf("Wrote %u frames to '%s'\n", timings->size(), argv[2]);
+	} else {
+		debugPrintf("Last %u frames (in microseconds):\n", timings->size());
+		debugPrintf("Stage          p50      p99      max\n");
+		for (int stage = 0; stage < Common::FrameTimings::kStageCount; stage++) {
+			const Common::FrameTimings::Stage s = (Common::FrameTimings::Stage)stage;
+			debugPrintf("%-8s %8u %8u %8u\n", Common::FrameTimings::getStageName(s),
+			            timings->getPercentile(s, 50), timings->getPercentile(s, 99), timings->getPercentile(s, 100));
+		}
+	}
+	return true;
+}
+
 bool Debugger::cmdDebugFlagsList(int argc, const char **argv) {
 	const Common::DebugManager::DebugChannelList &debugLevels = DebugMan.getDebugChannels();
 
@@ -277,6 +277,9 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		// Store the MD5s computed during the scan
+		ADCacheMan.flushFileCache(true);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
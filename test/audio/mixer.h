@@ -0,0 +1,370 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/audiostream.h"
+#include "audio/rate_intern.h"
+#include "audio/decoders/raw.h"
+
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "helper.h"
+#include "../system/null_osystem.h"
+
+// The mixer needs an OSystem for its mutexes and for timing
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_MIXER 1
+#else
+#define TEST_MIXER 0
+#endif
+
+/**
+ * Emulates a synthesizer whose timer callback changes the output at fixed
+ * sample positions.
+ */
+class TickingStream : public Audio::AudioStream {
+public:
+	TickingStream(uint32 length = 0xffffffff) : _pos(0), _length(length), _level(1) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		int samples = 0;
+		for (; samples < numSamples && _pos < _length; samples += 2) {
+			if (_pos % 300 == 0)
+				_level = (_level * 31 + 17) & 0x3fff;
+			buffer[samples] = (int16)(_pos * 7 + _level);
+			buffer[samples + 1] = (int16)(_level - _pos);
+			_pos++;
+		}
+		return samples;
+	}
+
+	bool isStereo() const override { return true; }
+	int getRate() const override { return 44100; }
+	bool endOfData() const override { return _pos >= _length; }
+
+private:
+	uint32 _pos;
+	const uint32 _length;
+	int _level;
+};
+
+class MixerTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_MIXER
+		Common::install_null_g_system();
+		// The null OSystem cannot be queried for CPU features
+		Audio::StereoMix::mixFunc = Audio::StereoMix::mixGeneric;
+		Audio::StereoMix::accumFunc = Audio::StereoMix::accumGeneric;
+		Audio::StereoMix::clampFunc = Audio::StereoMix::clampGeneric;
+		_mixerImpl = new Audio::MixerImpl(44100, true, 1024);
+		_mixerImpl->setReady(true);
+		_mixer = _mixerImpl;
+#endif
+	}
+
+	void tearDown() {
+#if TEST_MIXER
+		delete _mixerImpl;
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_channel_status() {
+#if TEST_MIXER
+		Audio::SoundHandle handle;
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, createLoopingStream(), 42, 100, -20);
+
+		TS_ASSERT(_mixer->isSoundHandleActive(handle));
+		TS_ASSERT(_mixer->isSoundIDActive(42));
+		TS_ASSERT(!_mixer->isSoundIDActive(43));
+		TS_ASSERT_EQUALS(_mixer->getSoundID(handle), 42);
+		TS_ASSERT(_mixer->hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT(!_mixer->hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(_mixer->getChannelBalance(handle), -20);
+		TS_ASSERT_EQUALS(_mixer->getChannelRate(handle), 22050u);
+
+		// Setters are visible right away, even before the audio thread ran
+		_mixer->setChannelVolume(handle, 200);
+		_mixer->setChannelBalance(handle, 10);
+		_mixer->setChannelFaderL(handle, 128);
+		_mixer->setChannelFaderR(handle, 64);
+		_mixer->setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 200);
+		TS_ASSERT_EQUALS(_mixer->getChannelBalance(handle), 10);
+		TS_ASSERT_EQUALS(_mixer->getChannelFaderL(handle), 128);
+		TS_ASSERT_EQUALS(_mixer->getChannelFaderR(handle), 64);
+		TS_ASSERT_EQUALS(_mixer->getChannelRate(handle), 11025u);
+
+		mix();
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 200);
+		_mixer->resetChannelRate(handle);
+		TS_ASSERT_EQUALS(_mixer->getChannelRate(handle), 22050u);
+
+		_mixer->stopHandle(handle);
+		TS_ASSERT(!_mixer->isSoundHandleActive(handle));
+		TS_ASSERT(!_mixer->isSoundIDActive(42));
+		TS_ASSERT(!_mixer->hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 0);
+		TS_ASSERT_EQUALS(_mixer->getSoundID(handle), 0);
+
+		// Setters on stale handles must not affect new sounds using the same slot
+		Audio::SoundHandle handle2;
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle2, createLoopingStream());
+		_mixer->setChannelVolume(handle, 1);
+		TS_ASSERT(handle != handle2);
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle2), Audio::Mixer::kMaxChannelVolume);
+#endif
+	}
+
+	void test_deferred_commands() {
+#if TEST_MIXER
+		Audio::SoundHandle handle;
+		_mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, createLoopingStream());
+
+		_mixer->setChannelVolume(handle, 0);
+		TS_ASSERT(isSilent(mix()));
+		_mixer->setChannelVolume(handle, 255);
+		TS_ASSERT(!isSilent(mix()));
+
+		_mixer->pauseHandle(handle, true);
+		TS_ASSERT(isSilent(mix()));
+		_mixer->pauseHandle(handle, false);
+		TS_ASSERT(!isSilent(mix()));
+
+		// Overflow the command queue, the last request has to win
+		for (int i = 0; i < 1000; i++)
+			_mixer->setChannelVolume(handle, (i & 1) ? 0 : 255);
+		TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), 0);
+		TS_ASSERT(isSilent(mix()));
+
+		// A synchronous request must not overtake pending ones
+		_mixer->pauseHandle(handle, true);
+		_mixer->setChannelVolume(handle, 255);
+		_mixer->pauseAll(false);
+		TS_ASSERT(!isSilent(mix()));
+#endif
+	}
+
+	void test_mix_bus() {
+#if TEST_MIXER
+		// The callbacks are larger than the announced buffer size, so they
+		// are mixed in several passes
+		Audio::MixerImpl busMixerImpl(44100, true, 200);
+		busMixerImpl.setReady(true);
+		busMixerImpl.setMixBus(true);
+		Audio::Mixer *busMixer = &busMixerImpl;
+
+		// Without clipping, the result has to be the same
+		for (int i = 0; i < 4; i++) {
+			_mixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createLoopingStream(), -1, 50 + i * 40, i * 20 - 30);
+			busMixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createLoopingStream(), -1, 50 + i * 40, i * 20 - 30);
+		}
+
+		int16 busBuffer[kBufferFrames * 2];
+		busMixerImpl.mixCallback((byte *)busBuffer, sizeof(busBuffer));
+		TS_ASSERT_SAME_DATA(mix(), busBuffer, sizeof(busBuffer));
+
+		// Two loud sounds cancelled out by a third one must not clip
+		_mixer->stopAll();
+		busMixer->stopAll();
+		const int8 values[] = { 117, 117, -117 };
+		for (int i = 0; i < ARRAYSIZE(values); i++) {
+			_mixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(values[i]));
+			busMixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(values[i]));
+		}
+
+		const int16 *buffer = mix();
+		busMixerImpl.mixCallback((byte *)busBuffer, sizeof(busBuffer));
+		for (int i = 0; i < kBufferFrames * 2; i++) {
+			TS_ASSERT_EQUALS(busBuffer[i], 117 << 8);
+			TS_ASSERT_DIFFERS(buffer[i], 117 << 8);
+		}
+
+		// Anything beyond the 16-bit range is clamped at the end
+		busMixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(117));
+		busMixerImpl.mixCallback((byte *)busBuffer, sizeof(busBuffer));
+		for (int i = 0; i < kBufferFrames * 2; i++)
+			TS_ASSERT_EQUALS(busBuffer[i], 32767);
+#endif
+	}
+
+	void test_mix_bus_speed() {
+#if TEST_MIXER
+		Audio::MixerImpl busMixerImpl(44100, true, 1024);
+		busMixerImpl.setReady(true);
+		busMixerImpl.setMixBus(true);
+		Audio::Mixer *busMixer = &busMixerImpl;
+
+		for (int i = 0; i < 16; i++) {
+			_mixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createLoopingStream(), -1, 100);
+			busMixer->playStream(Audio::Mixer::kSFXSoundType, nullptr, createLoopingStream(), -1, 100);
+		}
+
+#ifdef SLOW_TESTS
+		const int frames = 2000;
+#else
+		const int frames = 20;
+#endif
+		uint32 start = g_system->getMillis();
+		for (int frame = 0; frame < frames; frame++)
+			mix();
+		debug("Mixing 16 channels for %d frames, clamping each channel (in milliseconds): %d\n", frames, g_system->getMillis() - start);
+
+		int16 busBuffer[kBufferFrames * 2];
+		start = g_system->getMillis();
+		for (int frame = 0; frame < frames; frame++)
+			busMixerImpl.mixCallback((byte *)busBuffer, sizeof(busBuffer));
+		debug("Mixing 16 channels for %d frames, 32-bit mix bus (in milliseconds): %d\n", frames, g_system->getMillis() - start);
+#endif
+	}
+
+	void test_render_ahead() {
+#if TEST_MIXER
+		Audio::MixerImpl aheadMixerImpl(44100, true, 1024);
+		aheadMixerImpl.setReady(true);
+		aheadMixerImpl.setRenderAhead(true);
+		Audio::Mixer *aheadMixer = &aheadMixerImpl;
+
+		_mixer->playStream(Audio::Mixer::kPlainSoundType, nullptr, new TickingStream());
+		aheadMixer->playStream(Audio::Mixer::kPlainSoundType, nullptr, new TickingStream(), -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, true, false, true);
+
+		// Mix with and without giving the worker time to catch up
+		int16 aheadBuffer[kBufferFrames * 2];
+		for (int i = 0; i < 50; i++) {
+			aheadMixerImpl.mixCallback((byte *)aheadBuffer, sizeof(aheadBuffer));
+			TS_ASSERT_SAME_DATA(mix(), aheadBuffer, sizeof(aheadBuffer));
+
+			if (i % 3 == 0)
+				g_system->delayMillis(1);
+		}
+
+		// Streams may be stopped while the worker reads them, and still end
+		Audio::SoundHandle handle;
+		for (int i = 0; i < 20; i++) {
+			aheadMixer->playStream(Audio::Mixer::kPlainSoundType, &handle, new TickingStream(), -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, false, false, true);
+			aheadMixerImpl.mixCallback((byte *)aheadBuffer, sizeof(aheadBuffer));
+			aheadMixer->stopHandle(handle);
+		}
+
+		aheadMixer->playStream(Audio::Mixer::kPlainSoundType, &handle, new TickingStream(5000), -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, false, false, true);
+		for (int i = 0; i < 20; i++)
+			aheadMixerImpl.mixCallback((byte *)aheadBuffer, sizeof(aheadBuffer));
+		TS_ASSERT(!aheadMixer->isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_mixer_api_speed() {
+#if TEST_MIXER
+		Audio::SoundHandle handles[16];
+		for (int i = 0; i < ARRAYSIZE(handles); i++)
+			_mixer->playStream(Audio::Mixer::kSFXSoundType, &handles[i], createLoopingStream(), i);
+
+#ifdef SLOW_TESTS
+		const int rounds = 20000;
+#else
+		const int rounds = 200;
+#endif
+		// Emulate an engine polling and updating the mixer state many times
+		// per audio callback, as iMUSE Digital and Blade Runner do, while
+		// the audio thread keeps mixing
+		MixerThread mixerThread(_mixerImpl);
+		Common::Thread thread;
+		const bool threaded = thread.start(MixerThread::run, &mixerThread, "Mixer test");
+
+		uint32 start = g_system->getMillis();
+		int active = 0;
+		for (int round = 0; round < rounds; round++) {
+			for (int i = 0; i < ARRAYSIZE(handles); i++) {
+				Audio::SoundHandle handle = handles[i];
+				if (_mixer->isSoundHandleActive(handle))
+					active++;
+				_mixer->setChannelVolume(handle, (byte)(i + round));
+				_mixer->setChannelBalance(handle, (int8)((i + round) % 127));
+				_mixer->pauseHandle(handle, (round & 1) != 0);
+				TS_ASSERT_EQUALS(_mixer->getChannelVolume(handle), (byte)(i + round));
+			}
+			if (!threaded)
+				mix();
+		}
+		const uint32 apiTime = g_system->getMillis() - start;
+
+		// Leave every channel silent, which the mixer has to see in the end
+		for (int i = 0; i < ARRAYSIZE(handles); i++) {
+			_mixer->setChannelVolume(handles[i], 255);
+			_mixer->pauseHandle(handles[i], false);
+			_mixer->setChannelVolume(handles[i], 0);
+			_mixer->setChannelBalance(handles[i], (int8)(i * 3));
+		}
+
+		mixerThread.stop = true;
+		if (threaded)
+			thread.join();
+
+		TS_ASSERT_EQUALS(active, rounds * ARRAYSIZE(handles));
+		for (int i = 0; i < ARRAYSIZE(handles); i++) {
+			TS_ASSERT(_mixer->isSoundHandleActive(handles[i]));
+			TS_ASSERT_EQUALS(_mixer->getChannelVolume(handles[i]), 0);
+			TS_ASSERT_EQUALS(_mixer->getChannelBalance(handles[i]), i * 3);
+		}
+		TS_ASSERT(isSilent(mix()));
+
+		debug("Mixer API calls for %d rounds (in milliseconds): %d, %d mixer callbacks meanwhile\n",
+		      rounds, apiTime, mixerThread.frames.load());
+#endif
+	}
+
+private:
+	enum {
+		kBufferFrames = 512
+	};
+
+	/** Calls the mixer callback in a loop, as the audio thread of a backend. */
+	struct MixerThread {
+		MixerThread(Audio::MixerImpl *m) : mixer(m), stop(false), frames(0) {}
+
+		static void run(void *data) {
+			MixerThread *thread = (MixerThread *)data;
+			int16 buffer[kBufferFrames * 2];
+			while (!thread->stop) {
+				thread->mixer->mixCallback((byte *)buffer, sizeof(buffer));
+				thread->frames++;
+			}
+		}
+
+		Audio::MixerImpl *mixer;
+		std::atomic<bool> stop;
+		std::atomic<int> frames;
+	};
+
+	Audio::MixerImpl *_mixerImpl;
+	Audio::Mixer *_mixer;
+	int16 _buffer[kBufferFrames * 2];
+
+	static Audio::AudioStream *createLoopingStream() {
+		return Audio::makeLoopingAudioStream(createSineStream<int16>(22050, 1, nullptr, false, false), 0);
+	}
+
+	static Audio::AudioStream *createConstantStream(int8 value) {
+		const uint32 size = 1024;
+		byte *data = (byte *)malloc(size);
+		memset(data, (byte)value, size);
+		return Audio::makeLoopingAudioStream(Audio::makeRawStream(data, size, 44100, 0), 0);
+	}
+
+	const int16 *mix() {
+		_mixerImpl->mixCallback((byte *)_buffer, sizeof(_buffer));
+		return _buffer;
+	}
+
+	static bool isSilent(const int16 *buffer) {
+		for (int i = 0; i < kBufferFrames * 2; i++) {
+			if (buffer[i] != 0)
+				return false;
+		}
+		return true;
+	}
+};
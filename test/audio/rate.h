@@ -0,0 +1,268 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "helper.h"
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+#endif
+		_savedMixFunc = Audio::StereoMix::mixFunc;
+		_savedAccumFunc = Audio::StereoMix::accumFunc;
+		_savedClampFunc = Audio::StereoMix::clampFunc;
+	}
+
+	void tearDown() {
+		Audio::StereoMix::mixFunc = _savedMixFunc;
+		Audio::StereoMix::accumFunc = _savedAccumFunc;
+		Audio::StereoMix::clampFunc = _savedClampFunc;
+#if BENCHMARK_TIME
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_stereo_mix_functions() {
+		Audio::StereoMix::MixFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+		const uint frames = 77;
+		int16 src[frames * 2], ref[frames * 2], out[frames * 2];
+		Common::RandomSource rnd("stereomix");
+
+		const Audio::st_volume_t volumes[] = { 0, 1, 100, 255, Audio::Mixer::kMaxMixerVolume };
+		for (int f = 0; f < numFuncs; f++) {
+			for (int v0 = 0; v0 < ARRAYSIZE(volumes); v0++) {
+				for (int v1 = 0; v1 < ARRAYSIZE(volumes); v1++) {
+					for (uint i = 0; i < frames * 2; i++) {
+						src[i] = (int16)rnd.getRandomNumber(0xffff);
+						ref[i] = out[i] = (int16)rnd.getRandomNumber(0xffff);
+					}
+					// Make sure that the extremes are covered
+					src[0] = -32768;
+					src[1] = 32767;
+					ref[0] = out[0] = -32768;
+					ref[1] = out[1] = 32767;
+
+					Audio::StereoMix::mixGeneric(ref, src, frames, volumes[v0], volumes[v1]);
+					funcs[f](out, src, frames, volumes[v0], volumes[v1]);
+					TS_ASSERT_SAME_DATA(ref, out, sizeof(out));
+				}
+			}
+		}
+	}
+
+	void test_mix_bus_functions() {
+		Audio::StereoMix::AccumFunc accumFuncs[3];
+		Audio::StereoMix::ClampFunc clampFuncs[3];
+		const int numFuncs = getSIMDBusFuncs(accumFuncs, clampFuncs);
+
+		const uint frames = 77;
+		int16 src[frames * 2], ref16[frames * 2], out16[frames * 2];
+		int32 ref[frames * 2], out[frames * 2];
+		Common::RandomSource rnd("mixbus");
+
+		const Audio::st_volume_t volumes[] = { 0, 1, 100, 255, Audio::Mixer::kMaxMixerVolume };
+		for (int f = 0; f < numFuncs; f++) {
+			for (int v0 = 0; v0 < ARRAYSIZE(volumes); v0++) {
+				for (int v1 = 0; v1 < ARRAYSIZE(volumes); v1++) {
+					for (uint i = 0; i < frames * 2; i++) {
+						src[i] = (int16)rnd.getRandomNumber(0xffff);
+						ref[i] = out[i] = (int32)rnd.getRandomNumber(0x3ffff) - 0x20000;
+					}
+					src[0] = -32768;
+					src[1] = 32767;
+
+					Audio::StereoMix::accumGeneric(ref, src, frames, volumes[v0], volumes[v1]);
+					accumFuncs[f](out, src, frames, volumes[v0], volumes[v1]);
+					TS_ASSERT_SAME_DATA(ref, out, sizeof(out));
+
+					Audio::StereoMix::clampGeneric(ref16, ref, frames * 2);
+					clampFuncs[f](out16, out, frames * 2);
+					TS_ASSERT_SAME_DATA(ref16, out16, sizeof(out16));
+				}
+			}
+		}
+	}
+
+	void test_rate_converter_simd() {
+		Audio::StereoMix::MixFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+		// Copy, integer upsampling, downsampling and interpolation
+		const uint rates[] = { 44100, 11025, 88200, 22254 };
+		for (int f = 0; f < numFuncs; f++) {
+			for (int r = 0; r < ARRAYSIZE(rates); r++) {
+				for (int stereo = 0; stereo < 2; stereo++) {
+					for (int reverse = 0; reverse < 2; reverse++) {
+						if (reverse && !stereo)
+							continue;
+
+						Audio::StereoMix::mixFunc = Audio::StereoMix::mixGeneric;
+						int16 *ref = convert(rates[r], stereo, reverse, kMax, kMax);
+						Audio::StereoMix::mixFunc = funcs[f];
+						int16 *out = convert(rates[r], stereo, reverse, kMax, kMax);
+
+						TS_ASSERT_SAME_DATA(ref, out, kOutFrames * 2 * sizeof(int16));
+						delete[] ref;
+						delete[] out;
+					}
+				}
+			}
+		}
+	}
+
+	void test_rate_converter_silent_channel() {
+		Audio::StereoMix::MixFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+		// The right channel is silent for the first half, then the volume
+		// is raised. The silent channel must be left alone, and the
+		// resampling has to carry on from where the scalar path left it.
+		const uint rates[] = { 44100, 11025, 88200, 22254 };
+		for (int f = 0; f < numFuncs; f++) {
+			for (int r = 0; r < ARRAYSIZE(rates); r++) {
+				for (int stereo = 0; stereo < 2; stereo++) {
+					Audio::StereoMix::mixFunc = Audio::StereoMix::mixGeneric;
+					int16 *ref = convert(rates[r], stereo, false, kMax, 0, kMax, kMax);
+					Audio::StereoMix::mixFunc = funcs[f];
+					int16 *out = convert(rates[r], stereo, false, kMax, 0, kMax, kMax);
+
+					TS_ASSERT_SAME_DATA(ref, out, kOutFrames * 2 * sizeof(int16));
+					for (uint i = 0; i < kOutFrames / 2; i++)
+						TS_ASSERT_EQUALS(out[i * 2 + 1], (int16)(((i * 2 + 1) * 7919) & 0xffff));
+					delete[] ref;
+					delete[] out;
+				}
+			}
+		}
+	}
+
+	void test_rate_converter_speed() {
+#if BENCHMARK_TIME
+		Audio::StereoMix::MixFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+		const uint rates[] = { 44100, 11025, 22254 };
+		for (int r = 0; r < ARRAYSIZE(rates); r++) {
+			Audio::StereoMix::mixFunc = Audio::StereoMix::mixGeneric;
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				delete[] convert(rates[r], true, false, kMax, kMax);
+			debug("Rate converter %d Hz => 44100 Hz, scalar (in milliseconds): %d\n", rates[r], g_system->getMillis() - start);
+
+			for (int f = 0; f < numFuncs; f++) {
+				Audio::StereoMix::mixFunc = funcs[f];
+				start = g_system->getMillis();
+				for (int i = 0; i < iters; i++)
+					delete[] convert(rates[r], true, false, kMax, kMax);
+				debug("Rate converter %d Hz => 44100 Hz, SIMD #%d (in milliseconds): %d\n", rates[r], f, g_system->getMillis() - start);
+			}
+		}
+#endif
+	}
+
+private:
+	enum {
+		kOutFrames = 44100
+	};
+
+	static const Audio::st_volume_t kMax = Audio::Mixer::kMaxMixerVolume;
+
+	Audio::StereoMix::MixFunc _savedMixFunc;
+	Audio::StereoMix::AccumFunc _savedAccumFunc;
+	Audio::StereoMix::ClampFunc _savedClampFunc;
+
+	static int getSIMDFuncs(Audio::StereoMix::MixFunc *funcs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs++] = Audio::StereoMix::mixNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[numFuncs++] = Audio::StereoMix::mixSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[numFuncs++] = Audio::StereoMix::mixAVX2;
+#endif
+		return numFuncs;
+	}
+
+	static int getSIMDBusFuncs(Audio::StereoMix::AccumFunc *accumFuncs, Audio::StereoMix::ClampFunc *clampFuncs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		accumFuncs[numFuncs] = Audio::StereoMix::accumNEON;
+		clampFuncs[numFuncs++] = Audio::StereoMix::clampNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			accumFuncs[numFuncs] = Audio::StereoMix::accumSSE2;
+			clampFuncs[numFuncs++] = Audio::StereoMix::clampSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			accumFuncs[numFuncs] = Audio::StereoMix::accumAVX2;
+			clampFuncs[numFuncs++] = Audio::StereoMix::clampAVX2;
+		}
+#endif
+		return numFuncs;
+	}
+
+	/**
+	 * Mix one second of a sine at the given rate into a 44.1kHz stereo buffer
+	 * which already contains some noise, in several callbacks like the mixer.
+	 * The volumes can be changed halfway through.
+	 */
+	static int16 *convert(uint inRate, bool stereo, bool reverse, Audio::st_volume_t volL, Audio::st_volume_t volR) {
+		return convert(inRate, stereo, reverse, volL, volR, volL, volR);
+	}
+
+	static int16 *convert(uint inRate, bool stereo, bool reverse, Audio::st_volume_t volL, Audio::st_volume_t volR, Audio::st_volume_t volL2, Audio::st_volume_t volR2) {
+		int16 *out = new int16[kOutFrames * 2];
+		for (uint i = 0; i < kOutFrames * 2; i++)
+			out[i] = (int16)((i * 7919) & 0xffff);
+
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(inRate, 1, nullptr, false, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, 44100, stereo, true, reverse);
+
+		const uint bufferFrames = 1000;
+		for (uint pos = 0; pos < kOutFrames; pos += bufferFrames) {
+			const uint frames = MIN<uint>(bufferFrames, kOutFrames - pos);
+			const bool secondHalf = pos >= kOutFrames / 2;
+			converter->convert(*stream, (byte *)(out + pos * 2), sizeof(int16), frames, secondHalf ? volL2 : volL, secondHalf ? volR2 : volR, Audio::MIX_CLAMPED_ADD);
+		}
+
+		delete converter;
+		delete stream;
+		return out;
+	}
+};
@@ -0,0 +1,163 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/scummsys.h"
+
+#include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
+
+// Reads the same file through a mapped stream and a stdio stream, which
+// must behave the same, except for getRange().
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#ifdef HAS_MMAP
+		// Any file will do, as long as it is not written to
+		_stdio = PosixIoStream::makeFromPath(kFileName, StdioStream::WriteMode_Read);
+		_mmap = PosixMmapStream::makeFromPath(kFileName, 0);
+#endif
+	}
+
+	void tearDown() {
+#ifdef HAS_MMAP
+		delete _stdio;
+		delete _mmap;
+#endif
+	}
+
+	void test_read() {
+#ifdef HAS_MMAP
+		if (!_stdio)
+			return;
+		TS_ASSERT(_mmap);
+		if (!_mmap)
+			return;
+
+		TS_ASSERT_EQUALS(_mmap->size(), _stdio->size());
+		TS_ASSERT_LESS_THAN(1000, _mmap->size());
+
+		// Read the whole file in pieces of different sizes, and past its end
+		uint32 length = 1;
+		while (!_stdio->eos()) {
+			compareRead(length);
+			length = length * 3 + 1;
+		}
+		TS_ASSERT(_mmap->eos());
+		compareRead(10);
+		TS_ASSERT_EQUALS(_mmap->pos(), _mmap->size());
+#endif
+	}
+
+	void test_seek() {
+#ifdef HAS_MMAP
+		if (!_stdio || !_mmap)
+			return;
+
+		const int64 size = _stdio->size();
+		compareSeek(100, SEEK_SET);
+		compareRead(16);
+		compareSeek(-50, SEEK_CUR);
+		compareRead(16);
+		compareSeek(-16, SEEK_END);
+		compareRead(16);
+		TS_ASSERT(!_mmap->eos());
+
+		// Reading exactly up to the end doesn't reach it yet
+		compareRead(1);
+		TS_ASSERT(_mmap->eos());
+
+		// Seeking clears the end of stream, and may go past it
+		compareSeek(0, SEEK_SET);
+		TS_ASSERT(!_mmap->eos());
+		compareSeek(size + 10, SEEK_SET);
+		compareRead(4);
+		TS_ASSERT(_mmap->eos());
+
+		// But not before the start
+		compareSeek(20, SEEK_SET);
+		compareSeek(-21, SEEK_CUR);
+		compareSeek(-size - 1, SEEK_END);
+		compareRead(8);
+#endif
+	}
+
+	void test_get_range() {
+#ifdef HAS_MMAP
+		if (!_stdio || !_mmap)
+			return;
+
+		// Stdio streams don't hold their data in memory
+		TS_ASSERT(_stdio->getRange(0, 1) == nullptr);
+
+		const int64 size = _mmap->size();
+		Common::Array<byte> data;
+		data.resize(size);
+		TS_ASSERT_EQUALS(_stdio->read(data.begin(), size), (uint32)size);
+
+		const byte *range = _mmap->getRange(0, size);
+		TS_ASSERT(range);
+		if (range)
+			TS_ASSERT_SAME_DATA(range, data.begin(), size);
+
+		range = _mmap->getRange(size - 10, 10);
+		TS_ASSERT(range);
+		if (range)
+			TS_ASSERT_SAME_DATA(range, data.begin() + size - 10, 10);
+		TS_ASSERT(_mmap->getRange(size, 0) != nullptr);
+
+		TS_ASSERT(_mmap->getRange(size - 10, 11) == nullptr);
+		TS_ASSERT(_mmap->getRange(size, 1) == nullptr);
+		TS_ASSERT(_mmap->getRange(size + 1, 0) == nullptr);
+		TS_ASSERT(_mmap->getRange(-1, 1) == nullptr);
+		TS_ASSERT(_mmap->getRange(1, 0xFFFFFFFF) == nullptr);
+
+		// getRange() doesn't move the stream
+		TS_ASSERT_EQUALS(_mmap->pos(), 0);
+#endif
+	}
+
+	void test_min_size() {
+#ifdef HAS_MMAP
+		if (!_stdio)
+			return;
+
+		TS_ASSERT(PosixMmapStream::makeFromPath(kFileName, _stdio->size() + 1) == nullptr);
+		TS_ASSERT(PosixMmapStream::makeFromPath("test/engine-data", 0) == nullptr);
+		TS_ASSERT(PosixMmapStream::makeFromPath("test/engine-data/missing.dat", 0) == nullptr);
+#endif
+	}
+
+private:
+#ifdef HAS_MMAP
+	static const char *const kFileName;
+
+	void compareRead(uint32 length) {
+		Common::Array<byte> stdioData, mmapData;
+		stdioData.resize(length);
+		mmapData.resize(length);
+
+		const uint32 stdioLength = _stdio->read(stdioData.begin(), length);
+		const uint32 mmapLength = _mmap->read(mmapData.begin(), length);
+		TS_ASSERT_EQUALS(mmapLength, stdioLength);
+		if (mmapLength == stdioLength)
+			TS_ASSERT_SAME_DATA(mmapData.begin(), stdioData.begin(), mmapLength);
+		TS_ASSERT_EQUALS(_mmap->pos(), _stdio->pos());
+		TS_ASSERT_EQUALS(_mmap->eos(), _stdio->eos());
+		TS_ASSERT_EQUALS(_mmap->err(), _stdio->err());
+	}
+
+	void compareSeek(int64 offset, int whence) {
+		TS_ASSERT_EQUALS(_mmap->seek(offset, whence), _stdio->seek(offset, whence));
+		TS_ASSERT_EQUALS(_mmap->pos(), _stdio->pos());
+		TS_ASSERT_EQUALS(_mmap->eos(), _stdio->eos());
+	}
+
+	StdioStream *_stdio;
+	PosixMmapStream *_mmap;
+#endif
+};
+
+#ifdef HAS_MMAP
+// Copied to the build directory for the tests
+const char *const PosixMmapStreamTestSuite::kFileName = "test/engine-data/encoding.dat";
+#endif
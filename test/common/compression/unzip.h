@@ -0,0 +1,103 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/compression/unzip.h"
+
+// A zip file with a stored and a deflated file
+static const byte zipData[] = {
+	0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0xd3, 0x11,
+	0xaf, 0xf7, 0x20, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x73, 0x74,
+	0x6f, 0x72, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x53, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x20, 0x66,
+	0x69, 0x6c, 0x65, 0x73, 0x20, 0x61, 0x72, 0x65, 0x20, 0x75, 0x73, 0x65, 0x64, 0x20, 0x69, 0x6e,
+	0x20, 0x70, 0x6c, 0x61, 0x63, 0x65, 0x2e, 0x0a, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00,
+	0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0x20, 0xcc, 0xc8, 0x5a, 0x26, 0x00, 0x00, 0x00, 0x84, 0x00,
+	0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66, 0x6c, 0x61, 0x74, 0x65, 0x64, 0x2e, 0x74,
+	0x78, 0x74, 0x73, 0x49, 0x4d, 0xcb, 0x49, 0x2c, 0x49, 0x4d, 0x51, 0x48, 0xcb, 0xcc, 0x49, 0x2d,
+	0x56, 0x48, 0x2c, 0x4a, 0x55, 0x48, 0x49, 0x4d, 0xce, 0xcf, 0x2d, 0x28, 0x4a, 0x2d, 0x2e, 0x4e,
+	0x4d, 0xd1, 0x53, 0x70, 0xa1, 0xbd, 0x02, 0x00, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0xd3, 0x11, 0xaf, 0xf7, 0x20, 0x00, 0x00, 0x00,
+	0x20, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74,
+	0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00,
+	0x20, 0xcc, 0xc8, 0x5a, 0x26, 0x00, 0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x48, 0x00, 0x00, 0x00, 0x64, 0x65,
+	0x66, 0x6c, 0x61, 0x74, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00,
+	0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x72, 0x00, 0x00, 0x00, 0x98, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/**
+ * A stream over the zip file, which tells when it is deleted.
+ */
+class TrackedZipStream : public Common::MemoryReadStream {
+public:
+	TrackedZipStream(bool &deleted) : Common::MemoryReadStream(zipData, sizeof(zipData)), _deleted(deleted) {
+		_deleted = false;
+	}
+	~TrackedZipStream() { _deleted = true; }
+
+private:
+	bool &_deleted;
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+public:
+	void test_read_members() {
+		bool deleted;
+		Common::Archive *archive = Common::makeZipArchive(new TrackedZipStream(deleted));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		TS_ASSERT(archive->hasFile("stored.txt"));
+		TS_ASSERT(archive->hasFile("deflated.txt"));
+		checkMember(archive->createReadStreamForMember("stored.txt"), kStoredText, 1);
+		checkMember(archive->createReadStreamForMember("deflated.txt"), kDeflatedText, 4);
+
+		delete archive;
+		TS_ASSERT(deleted);
+	}
+
+	void test_member_outlives_archive() {
+		// Stored files are read from the data of the zip file, which has to
+		// stay around until they are deleted
+		bool deleted;
+		Common::Archive *archive = Common::makeZipArchive(new TrackedZipStream(deleted));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::SeekableReadStream *stored = archive->createReadStreamForMember("stored.txt");
+		Common::SeekableReadStream *deflated = archive->createReadStreamForMember("deflated.txt");
+		delete archive;
+		TS_ASSERT(!deleted);
+
+		checkMember(deflated, kDeflatedText, 4);
+		TS_ASSERT(!deleted);
+		checkMember(stored, kStoredText, 1);
+		TS_ASSERT(deleted);
+	}
+
+private:
+	static const char *const kStoredText;
+	static const char *const kDeflatedText;
+
+	/** Checks that a member consists of a number of copies of a text, and deletes it. */
+	static void checkMember(Common::SeekableReadStream *stream, const char *text, uint copies) {
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		const uint32 length = strlen(text);
+		TS_ASSERT_EQUALS(stream->size(), length * copies);
+		for (uint i = 0; i < copies; i++) {
+			char buffer[64];
+			TS_ASSERT_EQUALS(stream->read(buffer, length), length);
+			TS_ASSERT_SAME_DATA(buffer, text, length);
+		}
+		delete stream;
+	}
+};
+
+const char *const UnzipTestSuite::kStoredText = "Stored files are used in place.\n";
+const char *const UnzipTestSuite::kDeflatedText = "Deflated files are decompressed. ";
@@ -0,0 +1,245 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void setUp() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if BENCHMARK_TIME
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+		TS_ASSERT(container.begin() == container.end());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		TS_ASSERT_EQUALS(container2["FOO"], "bar");
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		container.erase(1);
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+
+		Common::FlatHashMap<int, int>::iterator it = container.find(1);
+		TS_ASSERT(it != container.end());
+		TS_ASSERT_EQUALS(it->_key, 1);
+		TS_ASSERT_EQUALS(it->_value, 33);
+		container.erase(it);
+		TS_ASSERT(!container.contains(1));
+		TS_ASSERT(container.find(1) == container.end());
+		TS_ASSERT_EQUALS(container.size(), 2u);
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container.setVal(3, 12);
+
+		TS_ASSERT_EQUALS(container[0], 17);
+		TS_ASSERT_EQUALS(container[1], -1);
+		TS_ASSERT_EQUALS(container[2], 45);
+		TS_ASSERT_EQUALS(container.getVal(3), 12);
+
+		const Common::FlatHashMap<int, int> &constContainer = container;
+		TS_ASSERT_EQUALS(constContainer[2], 45);
+		TS_ASSERT_EQUALS(constContainer.getValOrDefault(4), 0);
+		TS_ASSERT_EQUALS(constContainer.getValOrDefault(4, 5), 5);
+		TS_ASSERT_EQUALS(constContainer.getValOrDefault(3, 5), 12);
+
+		int val = 0;
+		TS_ASSERT(container.tryGetVal(2, val));
+		TS_ASSERT_EQUALS(val, 45);
+		TS_ASSERT(!container.tryGetVal(4, val));
+		TS_ASSERT_EQUALS(val, 45);
+	}
+
+	void test_hash_map_copy() {
+		Common::FlatHashMap<int, int> map1, container2;
+		map1[323] = 32;
+		map1[17] = 1;
+		map1.erase(17);
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2[323], 32);
+		TS_ASSERT(!container2.contains(17));
+
+		Common::FlatHashMap<int, int> container3(container2);
+		TS_ASSERT_EQUALS(container3.size(), 1u);
+		TS_ASSERT_EQUALS(container3[323], 32);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+
+		int sum = 0, count = 0;
+		Common::FlatHashMap<int, int>::const_iterator it;
+		for (it = container.begin(); it != container.end(); ++it) {
+			sum += it->_key * 1000 + it->_value;
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, 4);
+		TS_ASSERT_EQUALS(sum, 9000 + 17 + 45 + 12 + 96);
+	}
+
+	void test_compare_with_hashmap() {
+		// Random inserts and deletes, including many that hit the same slots
+		Common::RandomSource rnd("flathashmap");
+		Common::HashMap<int, int> ref;
+		Common::FlatHashMap<int, int> container;
+
+		for (int i = 0; i < 20000; i++) {
+			const int key = (int)rnd.getRandomNumber(2000) * 64;
+			if (rnd.getRandomBit()) {
+				ref[key] = i;
+				container[key] = i;
+			} else {
+				ref.erase(key);
+				container.erase(key);
+			}
+
+			if ((i % 1000) == 0) {
+				TS_ASSERT_EQUALS(ref.size(), container.size());
+				for (Common::HashMap<int, int>::const_iterator it = ref.begin(); it != ref.end(); ++it)
+					TS_ASSERT_EQUALS(container.getValOrDefault(it->_key, -1), it->_value);
+				uint count = 0;
+				for (Common::FlatHashMap<int, int>::const_iterator it = container.begin(); it != container.end(); ++it, ++count)
+					TS_ASSERT_EQUALS(ref.getValOrDefault(it->_key, -1), it->_value);
+				TS_ASSERT_EQUALS(count, container.size());
+			}
+		}
+	}
+
+	void test_flathashmap_speed() {
+#if BENCHMARK_TIME
+#ifdef SLOW_TESTS
+		const int numKeys = 1000000;
+#else
+		const int numKeys = 10000;
+#endif
+		benchmarkIntKeys<Common::HashMap<int, int> >("HashMap", numKeys);
+		benchmarkIntKeys<Common::FlatHashMap<int, int> >("FlatHashMap", numKeys);
+
+		Common::Array<Common::String> keys;
+		for (int i = 0; i < numKeys / 10; i++)
+			keys.push_back(Common::String::format("engines/data/FILE%05d.DAT", i));
+		benchmarkStringKeys<Common::StringMap>("HashMap", keys);
+		benchmarkStringKeys<FlatStringMap>("FlatHashMap", keys);
+#endif
+	}
+
+private:
+	template<class Map>
+	static void benchmarkIntKeys(const char *name, int numKeys) {
+		Map map;
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < numKeys; i++)
+			map[i * 7] = i;
+		debug("%s, inserting %d integer keys (in milliseconds): %d\n", name, numKeys, g_system->getMillis() - start);
+
+		int found = 0;
+		start = g_system->getMillis();
+		for (int pass = 0; pass < 10; pass++) {
+			for (int i = 0; i < numKeys; i++)
+				found += map.contains(i * 3) ? 1 : 0;
+		}
+		debug("%s, %d integer lookups (in milliseconds): %d\n", name, numKeys * 10, g_system->getMillis() - start);
+
+		int sum = 0;
+		start = g_system->getMillis();
+		for (int pass = 0; pass < 10; pass++) {
+			for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+				sum += it->_value;
+		}
+		debug("%s, iterating %d integer keys 10 times (in milliseconds): %d\n", name, numKeys, g_system->getMillis() - start);
+
+		TS_ASSERT(found > 0);
+		TS_ASSERT(sum != 0);
+	}
+
+	template<class Map>
+	static void benchmarkStringKeys(const char *name, const Common::Array<Common::String> &keys) {
+		Map map;
+		uint32 start = g_system->getMillis();
+		for (uint i = 0; i < keys.size(); i++)
+			map[keys[i]] = keys[i];
+		debug("%s, inserting %d string keys (in milliseconds): %d\n", name, keys.size(), g_system->getMillis() - start);
+
+		int found = 0;
+		start = g_system->getMillis();
+		for (int pass = 0; pass < 10; pass++) {
+			for (uint i = 0; i < keys.size(); i++)
+				found += map.contains(keys[i]) ? 1 : 0;
+		}
+		debug("%s, %d string lookups (in milliseconds): %d\n", name, keys.size() * 10, g_system->getMillis() - start);
+
+		TS_ASSERT_EQUALS(found, (int)keys.size() * 10);
+	}
+};
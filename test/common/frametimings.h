@@ -0,0 +1,75 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/frametimings.h"
+#include "common/memstream.h"
+
+class FrameTimingsTestSuite : public CxxTest::TestSuite {
+public:
+	void test_stages() {
+		Common::FrameTimings timings;
+
+		// The first frame has no engine time
+		timings.addTime(Common::FrameTimings::kStageConvert, 300);
+		timings.endFrame(1000, 2000);
+		TS_ASSERT_EQUALS(timings.size(), 1U);
+		TS_ASSERT_EQUALS(timings.getFrame(0).times[Common::FrameTimings::kStageEngine], 0U);
+		TS_ASSERT_EQUALS(timings.getFrame(0).times[Common::FrameTimings::kStageConvert], 300U);
+		TS_ASSERT_EQUALS(timings.getFrame(0).times[Common::FrameTimings::kStagePresent], 700U);
+
+		// The sleep is not part of the engine time
+		timings.addTime(Common::FrameTimings::kStageSleep, 4000);
+		timings.addTime(Common::FrameTimings::kStageSleep, 1000);
+		timings.endFrame(17000, 17500);
+		TS_ASSERT_EQUALS(timings.size(), 2U);
+		const Common::FrameTimings::Frame &frame = timings.getFrame(1);
+		TS_ASSERT_EQUALS(frame.times[Common::FrameTimings::kStageEngine], 10000U);
+		TS_ASSERT_EQUALS(frame.times[Common::FrameTimings::kStageConvert], 0U);
+		TS_ASSERT_EQUALS(frame.times[Common::FrameTimings::kStagePresent], 500U);
+		TS_ASSERT_EQUALS(frame.times[Common::FrameTimings::kStageSleep], 5000U);
+	}
+
+	void test_ring_buffer() {
+		Common::FrameTimings timings(4);
+
+		for (uint i = 0; i < 10; i++)
+			timings.endFrame(i * 1000, i * 1000 + i);
+
+		// Only the last 4 frames are kept, oldest first
+		TS_ASSERT_EQUALS(timings.size(), 4U);
+		for (uint i = 0; i < 4; i++)
+			TS_ASSERT_EQUALS(timings.getFrame(i).times[Common::FrameTimings::kStagePresent], 6 + i);
+
+		timings.clear();
+		TS_ASSERT_EQUALS(timings.size(), 0U);
+		TS_ASSERT_EQUALS(timings.getPercentile(Common::FrameTimings::kStagePresent, 50), 0U);
+	}
+
+	void test_percentiles() {
+		Common::FrameTimings timings;
+
+		// Present times of 1 to 100, in a shuffled order
+		for (uint i = 0; i < 100; i++)
+			timings.endFrame(0, (i * 37) % 100 + 1);
+
+		TS_ASSERT_EQUALS(timings.getPercentile(Common::FrameTimings::kStagePresent, 0), 1U);
+		TS_ASSERT_EQUALS(timings.getPercentile(Common::FrameTimings::kStagePresent, 50), 50U);
+		TS_ASSERT_EQUALS(timings.getPercentile(Common::FrameTimings::kStagePresent, 99), 99U);
+		TS_ASSERT_EQUALS(timings.getPercentile(Common::FrameTimings::kStagePresent, 100), 100U);
+	}
+
+	void test_csv() {
+		Common::FrameTimings timings;
+		timings.endFrame(100, 200);
+		timings.addTime(Common::FrameTimings::kStageConvert, 20);
+		timings.addTime(Common::FrameTimings::kStageSleep, 30);
+		timings.endFrame(300, 350);
+
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		timings.writeCSV(stream);
+		const Common::String csv((const char *)stream.getData(), stream.size());
+		TS_ASSERT_EQUALS(csv,
+			"frame,engine_us,convert_us,present_us,sleep_us\n"
+			"0,0,0,100,0\n"
+			"1,70,20,30,30\n");
+	}
+};
@@ -104,4 +104,23 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_range() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(3, SEEK_SET);
+		TS_ASSERT_EQUALS(ms.getRange(0, 7), contents);
+		TS_ASSERT_EQUALS(ms.getRange(2, 3), contents + 2);
+		TS_ASSERT_EQUALS(ms.getRange(7, 0), contents + 7);
+
+		// The position is not affected
+		TS_ASSERT_EQUALS(ms.pos(), 3);
+
+		// Ranges outside of the stream are rejected
+		TS_ASSERT(!ms.getRange(-1, 2));
+		TS_ASSERT(!ms.getRange(6, 2));
+		TS_ASSERT(!ms.getRange(8, 0));
+		TS_ASSERT(!ms.getRange(1, 0xFFFFFFFF));
+	}
 };
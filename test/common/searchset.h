@@ -0,0 +1,145 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+#include "../system/null_osystem.h"
+
+// The lookup cache needs an OSystem for its mutex
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_LOOKUP_CACHE 1
+#else
+#define TEST_LOOKUP_CACHE 0
+#endif
+
+/**
+ * Archive with a fixed set of empty files, which counts how often it was asked.
+ */
+class CountingArchive : public Common::Archive {
+public:
+	CountingArchive(const char *const *files) : _files(files), _lookups(0) {}
+
+	bool hasFile(const Common::Path &path) const override {
+		_lookups++;
+		for (const char *const *file = _files; *file; file++) {
+			if (path == Common::Path(*file))
+				return true;
+		}
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override { return 0; }
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream(nullptr, 0);
+	}
+
+	const char *const *_files;
+	mutable int _lookups;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_LOOKUP_CACHE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_LOOKUP_CACHE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_lookup_cache() {
+#if TEST_LOOKUP_CACHE
+		static const char *const files1[] = { "a.dat", "b.dat", nullptr };
+		static const char *const files2[] = { "b.dat", "c.dat", nullptr };
+		CountingArchive *arc1 = new CountingArchive(files1);
+		CountingArchive *arc2 = new CountingArchive(files2);
+
+		Common::SearchSet set;
+		set.setLookupCache(true);
+		set.add("arc1", arc1, 1);
+		set.add("arc2", arc2, 0);
+
+		for (int pass = 0; pass < 3; pass++) {
+			TS_ASSERT(set.hasFile("a.dat"));
+			TS_ASSERT(set.hasFile("c.dat"));
+			TS_ASSERT(!set.hasFile("d.dat"));
+			TS_ASSERT(!set.hasFile("A.DAT"));
+
+			Common::Archive *container = nullptr;
+			TS_ASSERT(set.getMember("c.dat", &container));
+			TS_ASSERT_EQUALS(container, arc2);
+
+			Common::SeekableReadStream *stream = set.createReadStreamForMember("b.dat");
+			TS_ASSERT(stream);
+			delete stream;
+			TS_ASSERT(!set.createReadStreamForMember("d.dat"));
+		}
+
+		// Only the first pass should have searched the archives, later ones
+		// only open b.dat from the archive it was found in
+		TS_ASSERT_EQUALS(arc1->_lookups, 6 + 2);
+		TS_ASSERT_EQUALS(arc2->_lookups, 4);
+
+		uint32 cacheHits, cacheMisses;
+		Common::Array<Common::SearchSet::ArchiveLookupStats> stats;
+		set.getLookupStats(cacheHits, cacheMisses, stats);
+		TS_ASSERT_EQUALS(cacheMisses, 6u);
+		TS_ASSERT_EQUALS(cacheHits, 15u);
+		TS_ASSERT_EQUALS(stats.size(), 2u);
+		TS_ASSERT_EQUALS(stats[0].name, "arc1");
+		TS_ASSERT_EQUALS(stats[0].hits, 2u + 2u);
+		TS_ASSERT_EQUALS(stats[0].misses, 4u);
+		TS_ASSERT_EQUALS(stats[1].hits, 1u);
+		TS_ASSERT_EQUALS(stats[1].misses, 3u);
+#endif
+	}
+
+	void test_lookup_cache_invalidation() {
+#if TEST_LOOKUP_CACHE
+		static const char *const files1[] = { "a.dat", nullptr };
+		static const char *const files2[] = { "a.dat", "b.dat", nullptr };
+
+		Common::SearchSet set;
+		set.setLookupCache(true);
+		set.add("arc1", new CountingArchive(files1));
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		// Adding an archive must not keep the negative result
+		CountingArchive *arc2 = new CountingArchive(files2);
+		set.add("arc2", arc2, 1);
+		TS_ASSERT(set.hasFile("b.dat"));
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember("a.dat", &container));
+		TS_ASSERT_EQUALS(container, arc2);
+
+		// Neither must reordering or removing them
+		set.setPriority("arc2", -1);
+		TS_ASSERT(set.getMember("a.dat", &container));
+		TS_ASSERT_DIFFERS(container, arc2);
+
+		set.remove("arc2");
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		// Changes to nested search sets invalidate the outer one as well
+		Common::SearchSet *nested = new Common::SearchSet();
+		Common::SearchSet outer;
+		outer.setLookupCache(true);
+		outer.add("nested", nested);
+		TS_ASSERT(!outer.hasFile("b.dat"));
+		nested->add("arc2", new CountingArchive(files2));
+		TS_ASSERT(outer.hasFile("b.dat"));
+#endif
+	}
+};
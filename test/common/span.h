@@ -2,6 +2,7 @@
 
 class SpanTestSuite;
 
+#include "common/bufferedstream.h"
 #include "common/span.h"
 #include "common/str.h"
 
@@ -807,4 +808,46 @@ public:
 			}
 		}
 	}
+
+	void test_stream_span() {
+		byte data[] = { 'h', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd' };
+
+		{
+			Common::MemoryReadStream stream(data, sizeof(data));
+			Common::StreamSpan span;
+
+			TS_ASSERT(span.readFromStream(stream, 5));
+			TS_ASSERT(span.isBorrowed());
+			TS_ASSERT_EQUALS(span->data(), data);
+			TS_ASSERT_EQUALS(span->size(), 5U);
+			TS_ASSERT_EQUALS(stream.pos(), 5);
+
+			TS_ASSERT(span.readFromStream(stream));
+			TS_ASSERT(span.isBorrowed());
+			TS_ASSERT_EQUALS(span->data(), data + 5);
+			TS_ASSERT_EQUALS(span->size(), 6U);
+			TS_ASSERT_EQUALS(span[1], 'w');
+			TS_ASSERT_EQUALS(stream.pos(), 11);
+		}
+
+		{
+			// A stream without direct access to its data is copied
+			Common::MemoryReadStream memoryStream(data, sizeof(data));
+			Common::SeekableReadStream *seekableStream = Common::wrapBufferedSeekableReadStream(&memoryStream, 4, DisposeAfterUse::NO);
+			Common::StreamSpan span;
+
+			TS_ASSERT(span.readFromStream(*seekableStream, 5));
+			TS_ASSERT(!span.isBorrowed());
+			TS_ASSERT_SAME_DATA(span->data(), data, 5);
+			TS_ASSERT_EQUALS(seekableStream->pos(), 5);
+
+			// Reading past the end returns the available data
+			TS_ASSERT(!span.readFromStream(*seekableStream, 8));
+			TS_ASSERT(!span.isBorrowed());
+			TS_ASSERT_EQUALS(span->size(), 6U);
+			TS_ASSERT_SAME_DATA(span->data(), data + 5, 6);
+
+			delete seekableStream;
+		}
+	}
 };
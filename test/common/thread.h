@@ -0,0 +1,67 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/thread.h"
+
+#include "../system/null_osystem.h"
+
+// The thread pool needs an OSystem to create its threads
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_THREAD_POOL 1
+#else
+#define TEST_THREAD_POOL 0
+#endif
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_THREAD_POOL
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_THREAD_POOL
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_run() {
+#if TEST_THREAD_POOL
+		Common::ThreadPool pool(4);
+		TS_ASSERT_LESS_THAN_EQUALS(pool.getNumThreads(), 4u);
+
+		// Run jobs of various sizes, including fewer tasks than threads
+		const uint counts[] = { 0, 1, 3, 1000 };
+		for (int pass = 0; pass < 20; pass++) {
+			for (int c = 0; c < ARRAYSIZE(counts); c++) {
+				uint values[1000];
+				memset(values, 0, sizeof(values));
+
+				pool.run(counts[c], setValue, values);
+
+				for (uint i = 0; i < counts[c]; i++)
+					TS_ASSERT_EQUALS(values[i], i * 3 + 1);
+				for (uint i = counts[c]; i < ARRAYSIZE(values); i++)
+					TS_ASSERT_EQUALS(values[i], 0u);
+			}
+		}
+#endif
+	}
+
+	void test_single_thread() {
+#if TEST_THREAD_POOL
+		Common::ThreadPool pool(1);
+		TS_ASSERT_EQUALS(pool.getNumThreads(), 1u);
+
+		uint values[10];
+		pool.run(ARRAYSIZE(values), setValue, values);
+		for (uint i = 0; i < ARRAYSIZE(values); i++)
+			TS_ASSERT_EQUALS(values[i], i * 3 + 1);
+#endif
+	}
+
+private:
+	static void setValue(void *data, uint index) {
+		((uint *)data)[index] = index * 3 + 1;
+	}
+};
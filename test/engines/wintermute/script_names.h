@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/wintermute/base/scriptables/script_names.h"
+
+/**
+ * Test suite for the interned names and property layouts in
+ * engines/wintermute/base/scriptables/script_names.h
+ */
+class ScriptNamesTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_intern() {
+		Wintermute::ScNameTable names;
+		char name[] = "name";
+
+		const char *interned = names.intern(name);
+		TS_ASSERT_DIFFERS((const void *)interned, (const void *)name);
+		TS_ASSERT_EQUALS(Common::String(interned), "name");
+		TS_ASSERT_EQUALS((const void *)names.intern("name"), (const void *)interned);
+		TS_ASSERT_EQUALS((const void *)names.find(name), (const void *)interned);
+
+		TS_ASSERT(!names.find("other"));
+		TS_ASSERT_EQUALS(names.getNumNames(), 1u);
+	}
+
+	void test_layout_transitions() {
+		Wintermute::ScNameTable names;
+		const char *x = names.intern("x");
+		const char *y = names.intern("y");
+
+		Wintermute::ScPropertyLayout *xLayout = names.addProperty(nullptr, x);
+		Wintermute::ScPropertyLayout *xyLayout = names.addProperty(xLayout, y);
+		TS_ASSERT_EQUALS(xyLayout->getSize(), 2u);
+		TS_ASSERT_EQUALS(xyLayout->findSlot(x), 0);
+		TS_ASSERT_EQUALS(xyLayout->findSlot(y), 1);
+		TS_ASSERT_EQUALS((const void *)xyLayout->getName(1), (const void *)y);
+		TS_ASSERT_EQUALS(xLayout->findSlot(y), -1);
+
+		// The same properties in the same order share the layout
+		TS_ASSERT_EQUALS(names.addProperty(nullptr, x), xLayout);
+		TS_ASSERT_EQUALS(names.addProperty(xLayout, y), xyLayout);
+		TS_ASSERT_EQUALS(names.getNumLayouts(), 2u);
+
+		// In another order, they don't
+		Wintermute::ScPropertyLayout *yxLayout = names.addProperty(names.addProperty(nullptr, y), x);
+		TS_ASSERT_DIFFERS(yxLayout, xyLayout);
+		TS_ASSERT_EQUALS(yxLayout->findSlot(x), 1);
+		TS_ASSERT_EQUALS(yxLayout->findSlot(y), 0);
+		TS_ASSERT_EQUALS(names.getNumLayouts(), 4u);
+
+		// Shared layouts belong to the table
+		TS_ASSERT_EQUALS(Wintermute::ScPropertyLayout::copy(xyLayout), xyLayout);
+		Wintermute::ScPropertyLayout::release(xyLayout);
+		TS_ASSERT_EQUALS(names.addProperty(xLayout, y), xyLayout);
+	}
+
+	void test_large_layouts() {
+		Wintermute::ScNameTable names;
+		Common::Array<const char *> props;
+		for (int i = 0; i < Wintermute::ScNameTable::kMaxSharedProperties + 4; i++) {
+			props.push_back(names.intern(Common::String::format("prop%d", i).c_str()));
+		}
+
+		Wintermute::ScPropertyLayout *layout = nullptr;
+		for (int i = 0; i < Wintermute::ScNameTable::kMaxSharedProperties; i++) {
+			layout = names.addProperty(layout, props[i]);
+		}
+		TS_ASSERT_EQUALS(names.getNumLayouts(), (uint32)Wintermute::ScNameTable::kMaxSharedProperties);
+
+		// Past the shared ones, a layout is extended in place
+		Wintermute::ScPropertyLayout *privateLayout = names.addProperty(layout, props[Wintermute::ScNameTable::kMaxSharedProperties]);
+		TS_ASSERT_DIFFERS(privateLayout, layout);
+		for (uint i = Wintermute::ScNameTable::kMaxSharedProperties + 1; i < props.size(); i++) {
+			TS_ASSERT_EQUALS(names.addProperty(privateLayout, props[i]), privateLayout);
+		}
+		TS_ASSERT_EQUALS(names.getNumLayouts(), (uint32)Wintermute::ScNameTable::kMaxSharedProperties);
+		TS_ASSERT_EQUALS(layout->getSize(), (uint32)Wintermute::ScNameTable::kMaxSharedProperties);
+
+		for (uint i = 0; i < props.size(); i++) {
+			TS_ASSERT_EQUALS(privateLayout->findSlot(props[i]), (int32)i);
+		}
+		TS_ASSERT_EQUALS(privateLayout->findSlot(names.intern("other")), -1);
+
+		// A copy of a layout which isn't shared can be extended on its own
+		Wintermute::ScPropertyLayout *copy = Wintermute::ScPropertyLayout::copy(privateLayout);
+		TS_ASSERT_DIFFERS(copy, privateLayout);
+		TS_ASSERT_EQUALS(names.addProperty(copy, names.find("other")), copy);
+		TS_ASSERT_EQUALS(copy->getSize(), privateLayout->getSize() + 1);
+		TS_ASSERT_EQUALS(copy->findSlot(props[3]), 3);
+
+		Wintermute::ScPropertyLayout::release(copy);
+		Wintermute::ScPropertyLayout::release(privateLayout);
+	}
+
+	void test_readd() {
+		Wintermute::ScNameTable names;
+		const char *x = names.intern("x");
+		const char *y = names.intern("y");
+
+		// A value whose properties were deleted gets the same layouts again
+		Wintermute::ScPropertyLayout *xyLayout = names.addProperty(names.addProperty(nullptr, x), y);
+		Wintermute::ScPropertyLayout::release(xyLayout);
+		TS_ASSERT_EQUALS(names.addProperty(names.addProperty(nullptr, x), y), xyLayout);
+		TS_ASSERT_EQUALS(names.getNumLayouts(), 2u);
+
+		// Interning a name again doesn't change the layouts which have it
+		TS_ASSERT_EQUALS(xyLayout->findSlot(names.intern("y")), 1);
+	}
+};
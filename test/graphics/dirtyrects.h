@@ -0,0 +1,54 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyrects.h"
+
+class DirtyRectListTestSuite : public CxxTest::TestSuite {
+public:
+	void test_merge_distant_rects() {
+		// Small changes in opposite corners stay separate
+		Graphics::DirtyRectList list;
+		list.push_back(Common::Rect(0, 0, 16, 16));
+		list.push_back(Common::Rect(304, 184, 320, 200));
+		list.merge(1024, 8);
+		TS_ASSERT_EQUALS(list.size(), 2U);
+		TS_ASSERT(contains(list, Common::Rect(0, 0, 16, 16)));
+		TS_ASSERT(contains(list, Common::Rect(304, 184, 320, 200)));
+	}
+
+	void test_merge_close_rects() {
+		// Adjacent and overlapping rects cost less when merged
+		Graphics::DirtyRectList list;
+		list.push_back(Common::Rect(0, 0, 16, 16));
+		list.push_back(Common::Rect(16, 0, 32, 16));
+		list.push_back(Common::Rect(8, 8, 24, 16));
+		list.push_back(Common::Rect(4, 4, 8, 8));
+		list.merge(1024, 8);
+		TS_ASSERT_EQUALS(list.size(), 1U);
+		TS_ASSERT(contains(list, Common::Rect(0, 0, 32, 16)));
+	}
+
+	void test_merge_max_rects() {
+		Graphics::DirtyRectList list;
+		for (int i = 0; i < 10; i++)
+			list.push_back(Common::Rect(i * 32, 0, i * 32 + 8, 8));
+		list.merge(0, 4);
+		TS_ASSERT_EQUALS(list.size(), 4U);
+
+		// Every rect is still covered
+		for (int i = 0; i < 10; i++) {
+			bool covered = false;
+			for (Graphics::DirtyRectList::const_iterator it = list.begin(); it != list.end(); ++it)
+				covered |= it->contains(Common::Rect(i * 32, 0, i * 32 + 8, 8));
+			TS_ASSERT(covered);
+		}
+	}
+
+private:
+	static bool contains(const Graphics::DirtyRectList &list, const Common::Rect &r) {
+		for (Graphics::DirtyRectList::const_iterator it = list.begin(); it != list.end(); ++it) {
+			if (*it == r)
+				return true;
+		}
+		return false;
+	}
+};
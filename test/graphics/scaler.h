@@ -0,0 +1,195 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_SCALERS
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+
+#include "../system/null_osystem.h"
+
+// The thread pool needs an OSystem to create its threads
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_SCALER_THREADS 1
+#else
+#define TEST_SCALER_THREADS 0
+#endif
+
+struct ScalerType {
+	const char *name;
+	Scaler *(*create)(const Graphics::PixelFormat &format);
+	uint factors[4];
+};
+
+template<class T>
+static Scaler *createScaler(const Graphics::PixelFormat &format) {
+	return new T(format);
+}
+
+// The scalers which can be split into bands, with their factors
+static const ScalerType kScalers[] = {
+	{ "Normal", createScaler<NormalScaler>, { 2, 3, 4, 0 } },
+#ifdef USE_HQ_SCALERS
+	{ "HQ", createScaler<HQScaler>, { 2, 3, 0 } },
+#endif
+	{ "SAI", createScaler<SAIScaler>, { 2, 0 } },
+	{ "SuperSAI", createScaler<SuperSAIScaler>, { 2, 0 } },
+	{ "SuperEagle", createScaler<SuperEagleScaler>, { 2, 0 } },
+	{ "AdvMame", createScaler<AdvMameScaler>, { 2, 3, 4, 0 } },
+	{ "PM", createScaler<PMScaler>, { 2, 0 } },
+	{ "TV", createScaler<TVScaler>, { 2, 0 } },
+	{ "DotMatrix", createScaler<DotMatrixScaler>, { 2, 0 } }
+};
+
+// Scales the same source on one and several threads with every scaler that
+// can be split into bands, which must produce identical output.
+class ScalerThreadsTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_SCALER_THREADS
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_SCALER_THREADS
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_banded_output() {
+#if TEST_SCALER_THREADS
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24)
+		};
+		Common::ThreadPool threads(4);
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			Source src(formats[f], 320, 200);
+			for (int s = 0; s < ARRAYSIZE(kScalers); s++) {
+				Scaler *scaler = kScalers[s].create(formats[f]);
+				for (const uint *factor = kScalers[s].factors; *factor; factor++) {
+					scaler->setFactor(*factor);
+
+					// The whole source, and an unaligned part of it
+					TSM_ASSERT(kScalers[s].name, compare(*scaler, threads, src, 0, 0, 320, 200));
+					TSM_ASSERT(kScalers[s].name, compare(*scaler, threads, src, 40, 37, 160, 150));
+				}
+				delete scaler;
+			}
+		}
+#endif
+	}
+
+	void test_banded_speed() {
+#if TEST_SCALER_THREADS
+#ifdef SLOW_TESTS
+		const int iterations = 100;
+#else
+		const int iterations = 2;
+#endif
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const uint numThreads[] = { 1, 2, 4, 0 };
+		Source src(format, 640, 480);
+
+		for (int s = 0; s < ARRAYSIZE(kScalers); s++) {
+			Scaler *scaler = kScalers[s].create(format);
+			scaler->setFactor(kScalers[s].factors[0]);
+			const uint32 dstPitch = src.width * scaler->getFactor() * format.bytesPerPixel;
+			byte *dst = new byte[dstPitch * src.height * scaler->getFactor()];
+
+			for (int t = 0; t < ARRAYSIZE(numThreads); t++) {
+				Common::ThreadPool threads(numThreads[t]);
+				scaler->setThreadPool(&threads);
+
+				uint32 start = g_system->getMillis();
+				for (int i = 0; i < iterations; i++)
+					scaler->scale(src.getBasePtr(0, 0), src.pitch, dst, dstPitch, src.width, src.height, 0, 0);
+				debug("%s %ux %d frames, %u threads (in milliseconds): %d\n", kScalers[s].name,
+				      scaler->getFactor(), iterations, threads.getNumThreads(), g_system->getMillis() - start);
+			}
+
+			delete[] dst;
+			delete scaler;
+		}
+#endif
+	}
+
+private:
+	enum {
+		// Larger than the extra pixels of any scaler
+		kPadding = 4
+	};
+
+	/**
+	 * A source image with a padding around it, using a few colors only so
+	 * that the scalers find edges to interpolate.
+	 */
+	struct Source {
+		Source(const Graphics::PixelFormat &format, int w, int h) : width(w), height(h) {
+			Common::RandomSource rnd("scaler");
+			rnd.setSeed(1234);
+
+			const uint32 colors[] = {
+				format.RGBToColor(0, 0, 0), format.RGBToColor(255, 255, 255),
+				format.RGBToColor(200, 40, 40), format.RGBToColor(30, 90, 220)
+			};
+			surface.create(w + kPadding * 2, h + kPadding * 2, format);
+			for (int y = 0; y < surface.h; y++) {
+				for (int x = 0; x < surface.w; x++) {
+					// Mostly runs of the same color
+					if (x == 0 || rnd.getRandomNumber(3) == 0)
+						surface.setPixel(x, y, colors[rnd.getRandomNumber(ARRAYSIZE(colors) - 1)]);
+					else
+						surface.setPixel(x, y, surface.getPixel(x - 1, y));
+				}
+			}
+			pitch = surface.pitch;
+		}
+
+		~Source() {
+			surface.free();
+		}
+
+		const byte *getBasePtr(int x, int y) const {
+			return (const byte *)surface.getBasePtr(x + kPadding, y + kPadding);
+		}
+
+		Graphics::Surface surface;
+		int width, height;
+		uint32 pitch;
+	};
+
+	static bool compare(Scaler &scaler, Common::ThreadPool &threads, const Source &src, int x, int y, int w, int h) {
+		const uint factor = scaler.getFactor();
+		const uint32 dstPitch = w * factor * src.surface.format.bytesPerPixel;
+		const uint32 size = dstPitch * h * factor;
+		byte *ref = new byte[size]();
+		byte *out = new byte[size]();
+
+		scaler.setThreadPool(nullptr);
+		scaler.scale(src.getBasePtr(x, y), src.pitch, ref, dstPitch, w, h, x, y);
+		scaler.setThreadPool(&threads);
+		scaler.scale(src.getBasePtr(x, y), src.pitch, out, dstPitch, w, h, x, y);
+		scaler.setThreadPool(nullptr);
+
+		const bool equal = memcmp(ref, out, size) == 0;
+		delete[] ref;
+		delete[] out;
+		return equal;
+	}
+};
+
+#endif
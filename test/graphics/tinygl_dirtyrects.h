@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_TINYGL
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/tinygl.h"
+
+// Renders frames of a mostly static scene with dirty rectangles, which must
+// only redraw the changed parts and produce the same frame buffer as when
+// redrawing everything.
+class TinyGLDirtyRectsTestSuite : public CxxTest::TestSuite {
+public:
+	void test_moving_quad() {
+		TinyGL::ContextHandle *context = createContext(true);
+		TinyGL::PresentStats stats;
+
+		drawScene(0, false);
+		TinyGL::getPresentStats(stats);
+		TS_ASSERT_EQUALS(stats.drawCalls, (uint)kNumQuads + 2);
+		TS_ASSERT_EQUALS(stats.changedDrawCalls, (uint)kNumQuads + 2);
+		TS_ASSERT_EQUALS(stats.redrawnPixels, (uint)kWidth * kHeight);
+
+		// Nothing changed
+		drawScene(0, false);
+		TinyGL::getPresentStats(stats);
+		TS_ASSERT_EQUALS(stats.changedDrawCalls, 0U);
+		TS_ASSERT_EQUALS(stats.dirtyRegions, 0U);
+		TS_ASSERT_EQUALS(stats.redrawnPixels, 0U);
+
+		// Only the moving quad changed, and its old and new positions are redrawn
+		drawScene(1, false);
+		TinyGL::getPresentStats(stats);
+		TS_ASSERT_EQUALS(stats.changedDrawCalls, 1U);
+		TS_ASSERT_LESS_THAN(0U, stats.redrawnPixels);
+		TS_ASSERT_LESS_THAN(stats.redrawnPixels, (uint)kWidth * kHeight / 10);
+
+		byte *out = copyFrameBuffer();
+		TinyGL::destroyContext(context);
+
+		byte *ref = renderReference(1, false);
+		TS_ASSERT_SAME_DATA(ref, out, kWidth * kHeight * 4);
+		delete[] ref;
+		delete[] out;
+	}
+
+	void test_added_draw_call() {
+		TinyGL::ContextHandle *context = createContext(true);
+		TinyGL::PresentStats stats;
+
+		drawScene(0, false);
+		drawScene(0, true);
+		TinyGL::getPresentStats(stats);
+		// The calls after the added one still match the previous frame
+		TS_ASSERT_EQUALS(stats.changedDrawCalls, 1U);
+		TS_ASSERT_LESS_THAN(stats.redrawnPixels, (uint)kWidth * kHeight / 10);
+
+		drawScene(0, false);
+		TinyGL::getPresentStats(stats);
+		TS_ASSERT_EQUALS(stats.changedDrawCalls, 0U);
+		TS_ASSERT_LESS_THAN(0U, stats.redrawnPixels);
+
+		byte *out = copyFrameBuffer();
+		TinyGL::destroyContext(context);
+
+		byte *ref = renderReference(0, false);
+		TS_ASSERT_SAME_DATA(ref, out, kWidth * kHeight * 4);
+		delete[] ref;
+		delete[] out;
+	}
+
+private:
+	enum {
+		kWidth = 320,
+		kHeight = 240,
+		kGridSize = 12,
+		kNumQuads = kGridSize * kGridSize
+	};
+
+	static TinyGL::ContextHandle *createContext(bool dirtyRects) {
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat::createFormatARGB32(), 256, false, dirtyRects);
+		TinyGL::setContext(context);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		return context;
+	}
+
+	static void drawQuad(float x, float y, float size) {
+		tglBegin(TGL_QUADS);
+		tglVertex2f(x, y);
+		tglVertex2f(x, y + size);
+		tglVertex2f(x + size, y + size);
+		tglVertex2f(x + size, y);
+		tglEnd();
+	}
+
+	/**
+	 * Draw a grid of blended quads, a moving one at the given step, and an
+	 * additional quad at the start if requested.
+	 */
+	static void drawScene(int step, bool extraQuad) {
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		if (extraQuad) {
+			tglColor4ub(255, 255, 255, 255);
+			drawQuad(3.0f, 5.0f, 10.0f);
+		}
+
+		const float cellW = (float)kWidth / kGridSize;
+		const float cellH = (float)kHeight / kGridSize;
+		for (int y = 0; y < kGridSize; y++) {
+			for (int x = 0; x < kGridSize; x++) {
+				tglColor4ub(x * 20, y * 20, 128, 160);
+				drawQuad(x * cellW + 2.0f, y * cellH + 2.0f, cellH - 4.0f);
+			}
+		}
+
+		tglColor4ub(255, 0, 0, 128);
+		drawQuad(100.0f + step * 8.0f, 100.0f, 12.0f);
+		tglDisable(TGL_BLEND);
+
+		TinyGL::presentBuffer();
+	}
+
+	static byte *copyFrameBuffer() {
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		byte *pixels = new byte[kWidth * kHeight * 4];
+		for (int y = 0; y < kHeight; y++)
+			memcpy(pixels + y * kWidth * 4, surface.getBasePtr(0, y), kWidth * 4);
+		return pixels;
+	}
+
+	static byte *renderReference(int step, bool extraQuad) {
+		TinyGL::ContextHandle *context = createContext(false);
+		drawScene(step, extraQuad);
+		byte *pixels = copyFrameBuffer();
+		TinyGL::destroyContext(context);
+		return pixels;
+	}
+};
+
+#endif
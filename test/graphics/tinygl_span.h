@@ -0,0 +1,339 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#ifdef USE_TINYGL
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+static const TGLenum kDepthFuncs[] = {
+	TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+};
+
+// Checks the vectorized span functions against the generic ones, then whole
+// frames rendered with them against the per-pixel code.
+class TinyGLSpanTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+#endif
+		_savedFlatFunc = TinyGL::SpanFill::flatFunc;
+		_savedDepthFunc = TinyGL::SpanFill::depthFunc;
+	}
+
+	void tearDown() {
+		TinyGL::SpanFill::flatFunc = _savedFlatFunc;
+		TinyGL::SpanFill::depthFunc = _savedDepthFunc;
+#if BENCHMARK_TIME
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_flat_span_functions() {
+		TinyGL::SpanFill::FlatFunc funcs[3];
+		TinyGL::SpanFill::DepthFunc depthFuncs[3];
+		const int numFuncs = getSIMDFuncs(funcs, depthFuncs);
+
+		Common::RandomSource rnd("tinygl_flat_span");
+		const uint dstFactors[] = { 0, 1, 128, 255, 256 };
+		uint32 pixels[kMaxCount], refPixels[kMaxCount], outPixels[kMaxCount];
+		uint z[kMaxCount], refZ[kMaxCount], outZ[kMaxCount];
+
+		for (int f = 0; f < numFuncs; f++) {
+			for (int d = 0; d < ARRAYSIZE(kDepthFuncs); d++) {
+				for (int i = 0; i < 50; i++) {
+					TinyGL::SpanFill::FlatParams params;
+					params.color = rnd.getRandomNumber(0xffffffff);
+					params.dstFactor = dstFactors[rnd.getRandomNumber(ARRAYSIZE(dstFactors) - 1)];
+					if (rnd.getRandomBit()) {
+						params.colorMask = 0x00ffffff;
+						params.constMask = 0xff000000;
+					} else {
+						params.colorMask = 0xffffffff;
+						params.constMask = 0;
+					}
+					params.depthFunc = kDepthFuncs[d];
+					params.depthWrite = rnd.getRandomBit();
+
+					const uint count = rnd.getRandomNumber(kMaxCount);
+					const uint z0 = randomDepth(rnd);
+					const int dzdx = (int)rnd.getRandomNumber(0x1ffff) - 0x10000;
+					randomBuffers(rnd, pixels, z, z0, dzdx);
+
+					memcpy(refPixels, pixels, sizeof(pixels));
+					memcpy(outPixels, pixels, sizeof(pixels));
+					memcpy(refZ, z, sizeof(z));
+					memcpy(outZ, z, sizeof(z));
+					TinyGL::SpanFill::flatGeneric(refPixels, refZ, count, z0, dzdx, params);
+					funcs[f](outPixels, outZ, count, z0, dzdx, params);
+					TS_ASSERT_SAME_DATA(refPixels, outPixels, sizeof(outPixels));
+					TS_ASSERT_SAME_DATA(refZ, outZ, sizeof(outZ));
+				}
+			}
+		}
+	}
+
+	void test_depth_span_functions() {
+		TinyGL::SpanFill::FlatFunc funcs[3];
+		TinyGL::SpanFill::DepthFunc depthFuncs[3];
+		const int numFuncs = getSIMDFuncs(funcs, depthFuncs);
+
+		Common::RandomSource rnd("tinygl_depth_span");
+		uint32 pixels[kMaxCount];
+		uint z[kMaxCount], refZ[kMaxCount], outZ[kMaxCount];
+
+		for (int f = 0; f < numFuncs; f++) {
+			for (int d = 0; d < ARRAYSIZE(kDepthFuncs); d++) {
+				for (int i = 0; i < 50; i++) {
+					const bool depthWrite = rnd.getRandomBit();
+					const uint z0 = randomDepth(rnd);
+					const int dzdx = (int)rnd.getRandomNumber(0x1ffff) - 0x10000;
+					randomBuffers(rnd, pixels, z, z0, dzdx);
+
+					memcpy(refZ, z, sizeof(z));
+					memcpy(outZ, z, sizeof(z));
+					const uint ref = TinyGL::SpanFill::depthGeneric(refZ, z0, dzdx, kDepthFuncs[d], depthWrite);
+					const uint out = depthFuncs[f](outZ, z0, dzdx, kDepthFuncs[d], depthWrite);
+					TS_ASSERT_EQUALS(ref, out);
+					TS_ASSERT_SAME_DATA(refZ, outZ, sizeof(outZ));
+				}
+			}
+		}
+	}
+
+	void test_span_rendering() {
+		TinyGL::SpanFill::FlatFunc funcs[3];
+		TinyGL::SpanFill::DepthFunc depthFuncs[3];
+		const int numFuncs = getSIMDFuncs(funcs, depthFuncs);
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+		for (int f = 0; f < numFuncs; f++) {
+			for (int p = 0; p < ARRAYSIZE(formats); p++) {
+				for (int scissor = 0; scissor < 2; scissor++) {
+					// The generic functions make fillTriangle use the per-pixel code
+					TinyGL::SpanFill::flatFunc = TinyGL::SpanFill::flatGeneric;
+					TinyGL::SpanFill::depthFunc = TinyGL::SpanFill::depthGeneric;
+					byte *ref = render(formats[p], scissor, 1);
+					TinyGL::SpanFill::flatFunc = funcs[f];
+					TinyGL::SpanFill::depthFunc = depthFuncs[f];
+					byte *out = render(formats[p], scissor, 1);
+
+					TS_ASSERT_SAME_DATA(ref, out, kWidth * kHeight * formats[p].bytesPerPixel);
+					delete[] ref;
+					delete[] out;
+				}
+			}
+		}
+	}
+
+	void test_span_rendering_speed() {
+#if BENCHMARK_TIME
+		TinyGL::SpanFill::FlatFunc funcs[3];
+		TinyGL::SpanFill::DepthFunc depthFuncs[3];
+		const int numFuncs = getSIMDFuncs(funcs, depthFuncs);
+
+#ifdef SLOW_TESTS
+		const int frames = 100;
+#else
+		const int frames = 1;
+#endif
+		const Graphics::PixelFormat format = Graphics::PixelFormat::createFormatARGB32();
+		TinyGL::SpanFill::flatFunc = TinyGL::SpanFill::flatGeneric;
+		TinyGL::SpanFill::depthFunc = TinyGL::SpanFill::depthGeneric;
+		uint32 start = g_system->getMillis();
+		delete[] render(format, false, frames);
+		debug("TinyGL %d frames, per-pixel (in milliseconds): %d\n", frames, g_system->getMillis() - start);
+
+		for (int f = 0; f < numFuncs; f++) {
+			TinyGL::SpanFill::flatFunc = funcs[f];
+			TinyGL::SpanFill::depthFunc = depthFuncs[f];
+			start = g_system->getMillis();
+			delete[] render(format, false, frames);
+			debug("TinyGL %d frames, SIMD #%d (in milliseconds): %d\n", frames, f, g_system->getMillis() - start);
+		}
+#endif
+	}
+
+private:
+	enum {
+		kMaxCount = 37,
+		kWidth = 320,
+		kHeight = 240,
+		kTrianglesPerFrame = 300
+	};
+
+	TinyGL::SpanFill::FlatFunc _savedFlatFunc;
+	TinyGL::SpanFill::DepthFunc _savedDepthFunc;
+
+	static int getSIMDFuncs(TinyGL::SpanFill::FlatFunc *funcs, TinyGL::SpanFill::DepthFunc *depthFuncs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs] = TinyGL::SpanFill::flatNEON;
+		depthFuncs[numFuncs++] = TinyGL::SpanFill::depthNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			funcs[numFuncs] = TinyGL::SpanFill::flatSSE2;
+			depthFuncs[numFuncs++] = TinyGL::SpanFill::depthSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			funcs[numFuncs] = TinyGL::SpanFill::flatAVX2;
+			depthFuncs[numFuncs++] = TinyGL::SpanFill::depthAVX2;
+		}
+#endif
+		return numFuncs;
+	}
+
+	// Depth values of all magnitudes, including ones which lose precision
+	// when written through a float and ones which don't fit in an int
+	static uint randomDepth(Common::RandomSource &rnd) {
+		switch (rnd.getRandomNumber(3)) {
+		case 0:
+			return rnd.getRandomNumber(0xffffff);
+		case 1:
+			return rnd.getRandomNumber(0x3fffffff);
+		case 2:
+			return 0x80000000 - rnd.getRandomNumber(0x1000);
+		default:
+			return rnd.getRandomNumber(0xffffffff);
+		}
+	}
+
+	// Pixels, and a depth buffer which is either random or close to the
+	// depth of the span so that some of its pixels are equal
+	static void randomBuffers(Common::RandomSource &rnd, uint32 *pixels, uint *z, uint z0, int dzdx) {
+		const bool close = rnd.getRandomBit();
+		for (uint i = 0; i < kMaxCount; i++) {
+			pixels[i] = rnd.getRandomNumber(0xffffffff);
+			if (close)
+				z[i] = z0 + i * (uint)dzdx + rnd.getRandomNumber(2) - 1;
+			else
+				z[i] = rnd.getRandomNumber(0xffffffff);
+		}
+	}
+
+	static float randomFloat(Common::RandomSource &rnd, float min, float max) {
+		return min + (max - min) * rnd.getRandomNumber(10000) / 10000.0f;
+	}
+
+	/**
+	 * Render random flat shaded and textured triangles with various blending
+	 * and depth states. Returns a copy of the final frame buffer.
+	 */
+	static byte *render(const Graphics::PixelFormat &format, bool scissor, int numFrames) {
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, false, false);
+		TinyGL::setContext(context);
+		TinyGL::setRasterizationThreads(1);
+
+		Common::RandomSource rnd("tinygl_span");
+		rnd.setSeed(1234);
+
+		byte texData[32 * 32 * 4];
+		for (int i = 0; i < ARRAYSIZE(texData); i++)
+			texData[i] = rnd.getRandomNumber(255);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 32, 32, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texData);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0, 1.0, -0.75, 0.75, 1.0, 100.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		if (scissor) {
+			tglEnable(TGL_SCISSOR_TEST);
+			tglScissor(37, 21, 203, 150);
+		}
+
+		const TGLenum blendFactors[][2] = {
+			{ TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA },
+			{ TGL_ONE, TGL_ONE_MINUS_SRC_ALPHA },
+			{ TGL_ONE, TGL_ONE },
+			{ TGL_ONE_MINUS_SRC_ALPHA, TGL_SRC_ALPHA },
+			{ TGL_ZERO, TGL_ONE },
+			{ TGL_DST_COLOR, TGL_ZERO }
+		};
+
+		for (int frame = 0; frame < numFrames; frame++) {
+			tglClearColor(0.1f, 0.2f, 0.3f, 0.5f);
+			tglClearDepth(1.0);
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+			for (int i = 0; i < kTrianglesPerFrame; i++) {
+				if (rnd.getRandomNumber(3) != 0) {
+					tglEnable(TGL_DEPTH_TEST);
+					tglDepthFunc(kDepthFuncs[rnd.getRandomNumber(ARRAYSIZE(kDepthFuncs) - 1)]);
+				} else {
+					tglDisable(TGL_DEPTH_TEST);
+				}
+				tglDepthMask(rnd.getRandomNumber(3) != 0);
+				if (rnd.getRandomBit()) {
+					const int b = rnd.getRandomNumber(ARRAYSIZE(blendFactors) - 1);
+					tglEnable(TGL_BLEND);
+					tglBlendFunc(blendFactors[b][0], blendFactors[b][1]);
+				} else {
+					tglDisable(TGL_BLEND);
+				}
+				tglShadeModel(rnd.getRandomNumber(3) != 0 ? TGL_FLAT : TGL_SMOOTH);
+				if (rnd.getRandomBit())
+					tglEnable(TGL_TEXTURE_2D);
+				else
+					tglDisable(TGL_TEXTURE_2D);
+
+				const float size = randomFloat(rnd, 0.5f, 6.0f);
+				const float cx = randomFloat(rnd, -10.0f, 10.0f);
+				const float cy = randomFloat(rnd, -8.0f, 8.0f);
+				const float cz = randomFloat(rnd, -30.0f, -1.5f);
+				tglBegin(TGL_TRIANGLES);
+				for (int v = 0; v < 6; v++) {
+					tglColor4ub(rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255));
+					tglTexCoord2f(randomFloat(rnd, 0.0f, 2.0f), randomFloat(rnd, 0.0f, 2.0f));
+					tglVertex3f(cx + randomFloat(rnd, -size, size), cy + randomFloat(rnd, -size, size), cz + randomFloat(rnd, -3.0f, 3.0f));
+				}
+				tglEnd();
+			}
+
+			TinyGL::presentBuffer();
+		}
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		byte *pixels = new byte[kWidth * kHeight * format.bytesPerPixel];
+		for (int y = 0; y < kHeight; y++)
+			memcpy(pixels + y * kWidth * format.bytesPerPixel, surface.getBasePtr(0, y), kWidth * format.bytesPerPixel);
+
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+		return pixels;
+	}
+};
+
+#endif
@@ -0,0 +1,190 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_TINYGL
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../system/null_osystem.h"
+
+// The rasterization threads need an OSystem to create their threads
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_TINYGL_THREADS 1
+#else
+#define TEST_TINYGL_THREADS 0
+#endif
+
+// Renders the same recorded frames on one and several threads, which must
+// produce identical frame buffers, with and without dirty rectangles.
+class TinyGLThreadsTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_TINYGL_THREADS
+		Common::install_null_g_system();
+		// The null OSystem cannot be queried for CPU features
+		TinyGL::SpanFill::flatFunc = TinyGL::SpanFill::flatGeneric;
+		TinyGL::SpanFill::depthFunc = TinyGL::SpanFill::depthGeneric;
+#endif
+	}
+
+	void tearDown() {
+#if TEST_TINYGL_THREADS
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_threaded_output() {
+#if TEST_TINYGL_THREADS
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			byte *ref = render(1, dirtyRects, kNumFrames);
+			byte *out = render(4, dirtyRects, kNumFrames);
+			TS_ASSERT_SAME_DATA(ref, out, kWidth * kHeight * 4);
+			delete[] ref;
+			delete[] out;
+		}
+#endif
+	}
+
+	void test_threaded_speed() {
+#if TEST_TINYGL_THREADS
+#ifdef SLOW_TESTS
+		const int frames = 100;
+#else
+		const int frames = 2;
+#endif
+		const uint threads[] = { 1, 2, 4, 0 };
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			for (int t = 0; t < ARRAYSIZE(threads); t++) {
+				uint32 start = g_system->getMillis();
+				delete[] render(threads[t], dirtyRects, frames);
+				debug("TinyGL %d frames, %u threads, dirty rects %s (in milliseconds): %d\n",
+				      frames, threads[t], dirtyRects ? "on" : "off", g_system->getMillis() - start);
+			}
+		}
+#endif
+	}
+
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kNumFrames = 3,
+		kTrianglesPerList = 150
+	};
+
+	/**
+	 * Record two display lists of random geometry, then replay them with a blit
+	 * in between for the given number of frames. Every frame only changes the
+	 * blit position, so dirty rectangles only cover part of the screen after
+	 * the first one. Returns a copy of the final frame buffer.
+	 */
+	static byte *render(uint numThreads, bool dirtyRects, int numFrames) {
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat::createFormatARGB32(), 256, true, dirtyRects);
+		TinyGL::setContext(context);
+		TinyGL::setRasterizationThreads(numThreads);
+
+		Common::RandomSource rnd("tinygl_threads");
+		rnd.setSeed(1234);
+
+		byte texData[16 * 16 * 4];
+		for (int i = 0; i < ARRAYSIZE(texData); i++)
+			texData[i] = rnd.getRandomNumber(255);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 16, 16, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texData);
+
+		Graphics::Surface image;
+		image.create(48, 32, Graphics::PixelFormat::createFormatARGB32());
+		for (int y = 0; y < image.h; y++)
+			for (int x = 0; x < image.w; x++)
+				image.setPixel(x, y, rnd.getRandomNumber(0xffffffff));
+		TinyGL::BlitImage *blitImage = tglGenBlitImage();
+		tglUploadBlitImage(blitImage, image, 0, false);
+		image.free();
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0, 1.0, -0.75, 0.75, 1.0, 100.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		const TGLuint lists = tglGenLists(2);
+		for (int l = 0; l < 2; l++) {
+			tglNewList(lists + l, TGL_COMPILE);
+			recordTriangles(rnd, texture);
+			tglEndList();
+		}
+
+		for (int frame = 0; frame < numFrames; frame++) {
+			tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+			tglClearDepth(1.0);
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+			tglCallList(lists);
+			tglBlit(blitImage, 100 + frame * 40, 200);
+			tglCallList(lists + 1);
+			TinyGL::presentBuffer();
+		}
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		byte *pixels = new byte[kWidth * kHeight * 4];
+		for (int y = 0; y < kHeight; y++)
+			memcpy(pixels + y * kWidth * 4, surface.getBasePtr(0, y), kWidth * 4);
+
+		tglDeleteBlitImage(blitImage);
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+		return pixels;
+	}
+
+	static float randomFloat(Common::RandomSource &rnd, float min, float max) {
+		return min + (max - min) * rnd.getRandomNumber(10000) / 10000.0f;
+	}
+
+	// Primitives of various sizes, types and states, some of them crossing
+	// the near plane or the screen borders.
+	static void recordTriangles(Common::RandomSource &rnd, TGLuint texture) {
+		const TGLenum types[] = { TGL_TRIANGLES, TGL_TRIANGLE_STRIP, TGL_TRIANGLE_FAN, TGL_QUADS, TGL_LINES };
+		for (int i = 0; i < kTrianglesPerList; i++) {
+			const uint flags = rnd.getRandomNumber(15);
+			if (flags & 1)
+				tglEnable(TGL_DEPTH_TEST);
+			else
+				tglDisable(TGL_DEPTH_TEST);
+			if (flags & 2) {
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			} else {
+				tglDisable(TGL_BLEND);
+			}
+			tglShadeModel((flags & 4) ? TGL_SMOOTH : TGL_FLAT);
+			if (flags & 8) {
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, texture);
+			} else {
+				tglDisable(TGL_TEXTURE_2D);
+			}
+
+			const float size = randomFloat(rnd, 0.5f, 6.0f);
+			const float cx = randomFloat(rnd, -10.0f, 10.0f);
+			const float cy = randomFloat(rnd, -8.0f, 8.0f);
+			const float cz = randomFloat(rnd, -30.0f, -1.5f);
+			tglBegin(types[rnd.getRandomNumber(ARRAYSIZE(types) - 1)]);
+			for (int v = 0; v < 12; v++) {
+				tglColor4ub(rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255), rnd.getRandomNumber(255));
+				tglTexCoord2f(randomFloat(rnd, 0.0f, 2.0f), randomFloat(rnd, 0.0f, 2.0f));
+				tglVertex3f(cx + randomFloat(rnd, -size, size), cy + randomFloat(rnd, -size, size), cz + randomFloat(rnd, -1.0f, 1.0f));
+			}
+			tglEnd();
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../system/null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+// Converts the same images with the lookup tables and with every available
+// vectorized implementation, which must produce identical pixels.
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+#endif
+		_savedFunc = Graphics::YUVToRGBRow::convertFunc;
+	}
+
+	void tearDown() {
+		Graphics::YUVToRGBRow::convertFunc = _savedFunc;
+#if BENCHMARK_TIME
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_random_images() {
+		Graphics::YUVToRGBRow::ConvertFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), // XRGB8888
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), // RGB565
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15) // ARGB1555
+		};
+		// Not a multiple of 16 pixels, so that every implementation leaves
+		// pixels at the end of the rows
+		const int w = 52, h = 12;
+		Planes planes(w, h);
+
+		for (int i = 0; i < numFuncs; i++) {
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+		for (int scale = 0; scale < 2; scale++) {
+		for (int mode = 0; mode < kModeCount; mode++) {
+			Graphics::Surface ref, out;
+			ref.create(w, h, formats[f]);
+			out.create(w, h, formats[f]);
+
+			Graphics::YUVToRGBRow::convertFunc = Graphics::YUVToRGBRow::convertGeneric;
+			convert(mode, ref, (Graphics::YUVToRGBManager::LuminanceScale)scale, planes);
+			Graphics::YUVToRGBRow::convertFunc = funcs[i];
+			convert(mode, out, (Graphics::YUVToRGBManager::LuminanceScale)scale, planes);
+
+			TSM_ASSERT_SAME_DATA(Common::String::format("func %d, format %d, scale %d, mode %d", i, f, scale, mode).c_str(),
+			                     ref.getPixels(), out.getPixels(), ref.pitch * ref.h);
+			ref.free();
+			out.free();
+		}
+		}
+		}
+		}
+	}
+
+	void test_all_chroma_values() {
+		Graphics::YUVToRGBRow::ConvertFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+
+		// Every combination of u and v, with varying luminance values
+		Planes planes(256, 256);
+		for (int y = 0; y < 256; y++) {
+			for (int x = 0; x < 256; x++) {
+				planes.y[y * planes.yPitch + x] = (x * 7 + y * 13) & 0xFF;
+				planes.u[y * planes.uvPitch + x] = x;
+				planes.v[y * planes.uvPitch + x] = y;
+			}
+		}
+
+		for (int i = 0; i < numFuncs; i++) {
+			for (int scale = 0; scale < 2; scale++) {
+				Graphics::Surface ref, out;
+				ref.create(256, 256, Graphics::PixelFormat::createFormatARGB32());
+				out.create(256, 256, Graphics::PixelFormat::createFormatARGB32());
+
+				Graphics::YUVToRGBRow::convertFunc = Graphics::YUVToRGBRow::convertGeneric;
+				convert(kMode444, ref, (Graphics::YUVToRGBManager::LuminanceScale)scale, planes);
+				Graphics::YUVToRGBRow::convertFunc = funcs[i];
+				convert(kMode444, out, (Graphics::YUVToRGBManager::LuminanceScale)scale, planes);
+
+				TSM_ASSERT_SAME_DATA(Common::String::format("func %d, scale %d", i, scale).c_str(),
+				                     ref.getPixels(), out.getPixels(), ref.pitch * ref.h);
+				ref.free();
+				out.free();
+			}
+		}
+	}
+
+	void test_convert_speed() {
+#if BENCHMARK_TIME
+		Graphics::YUVToRGBRow::ConvertFunc funcs[3];
+		const int numFuncs = getSIMDFuncs(funcs);
+#ifdef SLOW_TESTS
+		const int iterations = 100;
+#else
+		const int iterations = 2;
+#endif
+		const int w = 1920, h = 1080;
+		Planes planes(w, h);
+		Graphics::Surface surface;
+		surface.create(w, h, Graphics::PixelFormat::createFormatARGB32());
+
+		for (int i = -1; i < numFuncs; i++) {
+			Graphics::YUVToRGBRow::convertFunc = (i < 0) ? Graphics::YUVToRGBRow::convertGeneric : funcs[i];
+			uint32 start = g_system->getMillis();
+			for (int n = 0; n < iterations; n++)
+				convert(kMode420, surface, Graphics::YUVToRGBManager::kScaleITU, planes);
+			debug("YUV420 %dx%d, %d frames, %s (in milliseconds): %d\n", w, h, iterations,
+			      (i < 0) ? "lookup tables" : Common::String::format("func %d", i).c_str(), g_system->getMillis() - start);
+		}
+
+		surface.free();
+#endif
+	}
+
+private:
+	enum Mode {
+		kMode444,
+		kMode422,
+		kMode420,
+		kMode410,
+		kModeCount
+	};
+
+	/**
+	 * Random planes, with room for the extra chroma row and column needed by
+	 * the YUV410 conversion.
+	 */
+	struct Planes {
+		Planes(int w, int h) : width(w), height(h), yPitch(w + 5), uvPitch(w + 3) {
+			Common::RandomSource rnd("yuv_to_rgb");
+			rnd.setSeed(1234);
+
+			y = new byte[yPitch * h];
+			u = new byte[uvPitch * (h + 1)];
+			v = new byte[uvPitch * (h + 1)];
+			for (int i = 0; i < yPitch * h; i++)
+				y[i] = rnd.getRandomNumber(255);
+			for (int i = 0; i < uvPitch * (h + 1); i++) {
+				u[i] = rnd.getRandomNumber(255);
+				v[i] = rnd.getRandomNumber(255);
+			}
+		}
+
+		~Planes() {
+			delete[] y;
+			delete[] u;
+			delete[] v;
+		}
+
+		int width, height, yPitch, uvPitch;
+		byte *y, *u, *v;
+	};
+
+	static void convert(int mode, Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, const Planes &planes) {
+		switch (mode) {
+		case kMode444:
+			YUVToRGBMan.convert444(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kMode422:
+			YUVToRGBMan.convert422(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kMode420:
+			YUVToRGBMan.convert420(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		default:
+			YUVToRGBMan.convert410(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		}
+	}
+
+	static int getSIMDFuncs(Graphics::YUVToRGBRow::ConvertFunc *funcs) {
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs++] = Graphics::YUVToRGBRow::convertNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[numFuncs++] = Graphics::YUVToRGBRow::convertSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[numFuncs++] = Graphics::YUVToRGBRow::convertAVX2;
+#endif
+		return numFuncs;
+	}
+
+	Graphics::YUVToRGBRow::ConvertFunc _savedFunc;
+};
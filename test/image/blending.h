@@ -1024,3 +1024,165 @@ public:
 #endif
 	}
 };
+
+// Compares the SIMD versions of alphaBlit(), alphaKeyBlit() and
+// alphaMaskBlit() with the scalar code used for all other formats.
+class AlphaBlitTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if BENCHMARK_TIME
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_alpha_blit_simd() {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatARGB32(),
+			Graphics::PixelFormat::createFormatRGBA32(),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), // XRGB8888
+		};
+		const byte aMods[] = { 255, 200, 1 };
+		const uint w = 37, h = 9;
+
+		uint32 src[w * h], ref[w * h], out[w * h], dstInit[w * h];
+		byte mask[w * h];
+
+		Graphics::AlphaBlitRow::BlitFunc oldFunc = Graphics::AlphaBlitRow::blitFunc;
+		Graphics::AlphaBlitRow::BlitFunc funcs[3];
+		int numFuncs = 0;
+#ifdef SCUMMVM_NEON
+		funcs[numFuncs++] = Graphics::AlphaBlitRow::blitNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs[numFuncs++] = Graphics::AlphaBlitRow::blitSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs[numFuncs++] = Graphics::AlphaBlitRow::blitAVX2;
+#endif
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			const Graphics::PixelFormat &format = formats[f];
+			const uint32 key = format.ARGBToColor(255, 255, 0, 255);
+			fillPixels(src, dstInit, mask, w * h, format, key);
+
+			for (int i = 0; i < numFuncs; i++) {
+			for (int mode = 0; mode < 3; mode++) {
+			for (int flip = 0; flip <= 3; flip++) {
+			for (int m = 0; m < ARRAYSIZE(aMods); m++) {
+				Graphics::AlphaBlitRow::blitFunc = Graphics::AlphaBlitRow::blitGeneric;
+				memcpy(ref, dstInit, sizeof(ref));
+				blit(mode, ref, src, mask, w, h, format, key, flip, aMods[m]);
+
+				Graphics::AlphaBlitRow::blitFunc = funcs[i];
+				memcpy(out, dstInit, sizeof(out));
+				blit(mode, out, src, mask, w, h, format, key, flip, aMods[m]);
+
+				TSM_ASSERT_SAME_DATA(Common::String::format("func %d, format %d, mode %d, flip %d, aMod %d", i, f, mode, flip, aMods[m]).c_str(),
+				                     ref, out, sizeof(ref));
+			}
+			}
+			}
+			}
+		}
+
+		Graphics::AlphaBlitRow::blitFunc = oldFunc;
+	}
+
+	void test_alpha_blit_speed() {
+#if BENCHMARK_TIME
+#ifdef SLOW_TESTS
+		const int iters = 2000;
+#else
+		const int iters = 1;
+#endif
+		const uint w = 320, h = 200;
+		const Graphics::PixelFormat format = Graphics::PixelFormat::createFormatARGB32();
+		const uint32 key = format.ARGBToColor(255, 255, 0, 255);
+
+		uint32 *src = new uint32[w * h];
+		uint32 *dst = new uint32[w * h];
+		uint32 *dstInit = new uint32[w * h];
+		byte *mask = new byte[w * h];
+		fillPixels(src, dstInit, mask, w * h, format, key);
+
+		Graphics::AlphaBlitRow::BlitFunc oldFunc = Graphics::AlphaBlitRow::blitFunc;
+		Graphics::AlphaBlitRow::BlitFunc simdFunc = Graphics::AlphaBlitRow::blitGeneric;
+#ifdef SCUMMVM_NEON
+		simdFunc = Graphics::AlphaBlitRow::blitNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			simdFunc = Graphics::AlphaBlitRow::blitSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			simdFunc = Graphics::AlphaBlitRow::blitAVX2;
+#endif
+
+		const char *modeNames[] = { "alphaBlit", "alphaKeyBlit", "alphaMaskBlit" };
+		for (int mode = 0; mode < 3; mode++) {
+			memcpy(dst, dstInit, w * h * sizeof(uint32));
+			Graphics::AlphaBlitRow::blitFunc = Graphics::AlphaBlitRow::blitGeneric;
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				blit(mode, dst, src, mask, w, h, format, key, 0, 255);
+			uint32 genericTime = g_system->getMillis() - start;
+
+			memcpy(dst, dstInit, w * h * sizeof(uint32));
+			Graphics::AlphaBlitRow::blitFunc = simdFunc;
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				blit(mode, dst, src, mask, w, h, format, key, 0, 255);
+			uint32 simdTime = g_system->getMillis() - start;
+
+			debug("%s %d iters, generic (in milliseconds): %d\n", modeNames[mode], iters, genericTime);
+			debug("%s %d iters, SIMD (in milliseconds): %d\n", modeNames[mode], iters, simdTime);
+		}
+
+		Graphics::AlphaBlitRow::blitFunc = oldFunc;
+		delete[] src;
+		delete[] dst;
+		delete[] dstInit;
+		delete[] mask;
+#endif
+	}
+
+private:
+	// Pixels with a mix of transparent, opaque and translucent alpha values,
+	// and the key color
+	static void fillPixels(uint32 *src, uint32 *dst, byte *mask, uint count, const Graphics::PixelFormat &format, uint32 key) {
+		const byte alphas[] = { 0, 255, 255, 128, 1, 254 };
+		uint32 seed = 12345;
+		for (uint i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			const byte r = seed >> 24, g = seed >> 16, b = seed >> 8;
+			src[i] = (i % 5 == 3) ? key : format.ARGBToColor(alphas[(seed >> 4) % ARRAYSIZE(alphas)], r, g, b);
+			dst[i] = format.ARGBToColor(seed & 0xFF, b, r, g);
+			mask[i] = alphas[(seed >> 12) % ARRAYSIZE(alphas)];
+		}
+	}
+
+	static void blit(int mode, uint32 *dst, const uint32 *src, const byte *mask, uint w, uint h,
+	                 const Graphics::PixelFormat &format, uint32 key, byte flip, byte aMod) {
+		const uint pitch = w * sizeof(uint32);
+		switch (mode) {
+		case 0:
+			Graphics::alphaBlit((byte *)dst, (const byte *)src, pitch, pitch, w, h, format, format, flip, aMod);
+			break;
+		case 1:
+			Graphics::alphaKeyBlit((byte *)dst, (const byte *)src, pitch, pitch, w, h, format, format, key, flip, aMod);
+			break;
+		default:
+			Graphics::alphaMaskBlit((byte *)dst, (const byte *)src, mask, pitch, pitch, w, w, h, format, format, flip, aMod);
+			break;
+		}
+	}
+};
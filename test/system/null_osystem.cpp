@@ -8,6 +8,10 @@
 #undef USE_CLOUD
 #endif
 #include "../backends/saves/savefile.cpp"
+#ifdef NULL_DRIVER_USE_THREADS
+#include "../backends/mutex/pthread/pthread-mutex.cpp"
+#include "../backends/threads/pthread/pthread-threads.cpp"
+#endif
 
 //#define DISPLAY_ERROR_MESSAGES
 
@@ -0,0 +1,236 @@
+#include <cxxtest/TestSuite.h>
+
+#ifdef USE_BINK
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/util.h"
+
+#include "graphics/surface.h"
+
+#include "video/bink_decoder.h"
+
+#include "../system/null_osystem.h"
+
+// The thread pool needs an OSystem to create its threads
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_BINK_THREADS 1
+#else
+#define TEST_BINK_THREADS 0
+#endif
+
+/**
+ * Writes BIKi videos made of blocks filled with a color, which change with
+ * every frame. They stand in for sample files, which the tests can't use.
+ */
+class BinkWriter {
+public:
+	static Common::SeekableReadStream *createVideo(uint32 width, uint32 height, uint32 frameCount, bool hasAlpha) {
+		Common::Array<Common::Array<byte> > frames;
+		frames.resize(frameCount);
+		for (uint32 i = 0; i < frameCount; i++)
+			writeFrame(frames[i], width, height, i, hasAlpha);
+
+		const uint32 headerSize = 11 * 4 + frameCount * 4;
+		uint32 fileSize = headerSize, largestFrameSize = 0;
+		for (uint32 i = 0; i < frameCount; i++) {
+			fileSize += frames[i].size();
+			largestFrameSize = MAX<uint32>(largestFrameSize, frames[i].size());
+		}
+
+		byte *data = (byte *)malloc(fileSize);
+		WRITE_BE_UINT32(data, MKTAG('B', 'I', 'K', 'i'));
+		WRITE_LE_UINT32(data + 4, fileSize - 8);
+		WRITE_LE_UINT32(data + 8, frameCount);
+		WRITE_LE_UINT32(data + 12, largestFrameSize);
+		WRITE_LE_UINT32(data + 16, 0);
+		WRITE_LE_UINT32(data + 20, width);
+		WRITE_LE_UINT32(data + 24, height);
+		WRITE_LE_UINT32(data + 28, 30);
+		WRITE_LE_UINT32(data + 32, 1);
+		WRITE_LE_UINT32(data + 36, hasAlpha ? 0x00100000 : 0);
+		WRITE_LE_UINT32(data + 40, 0);
+
+		// Every frame is a key frame
+		uint32 offset = headerSize;
+		for (uint32 i = 0; i < frameCount; i++) {
+			WRITE_LE_UINT32(data + 44 + i * 4, offset | 1);
+			memcpy(data + offset, frames[i].begin(), frames[i].size());
+			offset += frames[i].size();
+		}
+
+		return new Common::MemoryReadStream(data, fileSize, DisposeAfterUse::YES);
+	}
+
+private:
+	/** Writes bits from the least significant one, like BitStreamMemory32LELSB reads them. */
+	struct BitWriter {
+		BitWriter(Common::Array<byte> &d) : data(d), pos(0) {}
+
+		void put(uint32 value, int n) {
+			for (int i = 0; i < n; i++, pos++) {
+				if ((pos & 7) == 0)
+					data.push_back(0);
+				data.back() |= ((value >> i) & 1) << (pos & 7);
+			}
+		}
+
+		void zeros(int n) {
+			for (int i = 0; i < n; i++)
+				put(0, 1);
+		}
+
+		void align() {
+			zeros((32 - (pos & 0x1F)) & 0x1F);
+		}
+
+		Common::Array<byte> &data;
+		uint32 pos;
+	};
+
+	static void writeFrame(Common::Array<byte> &data, uint32 width, uint32 height, uint32 frame, bool hasAlpha) {
+		BitWriter bits(data);
+
+		// BIKi frames have a 32-bit value before the alpha and the Y
+		// planes, which the decoder skips
+		if (hasAlpha) {
+			bits.put(0, 32);
+			writePlane(bits, width, height, false, frame * 3 + 7);
+		}
+
+		bits.put(0, 32);
+		writePlane(bits, width, height, false, frame * 5);
+		writePlane(bits, width, height, true, frame * 2 + 100);
+		writePlane(bits, width, height, true, frame * 7 + 50);
+	}
+
+	static uint32 countLength(uint32 count) {
+		return Common::intLog2(count + 511) + 1;
+	}
+
+	/** A plane of fill blocks, using only the first Huffman tree. */
+	static void writePlane(BitWriter &bits, uint32 width, uint32 height, bool isChroma, uint32 seed) {
+		const uint32 blockWidth  = isChroma ? (width  + 15) >> 4 : (width  + 7) >> 3;
+		const uint32 blockHeight = isChroma ? (height + 15) >> 4 : (height + 7) >> 3;
+		const uint32 planeWidth  = MAX<uint32>(isChroma ? width >> 1 : width, 8);
+
+		const uint32 typeLength     = countLength(planeWidth >> 3);
+		const uint32 subTypeLength  = countLength((planeWidth + 7) >> 4);
+		const uint32 colorLength    = countLength(blockWidth * 64);
+		const uint32 patternLength  = countLength(blockWidth << 3);
+		const uint32 runLength      = countLength(blockWidth * 48);
+
+		// The Huffman trees of the block types, the sub block types, the
+		// colors with their high nibbles, the patterns, the motion values
+		// and the runs
+		bits.zeros(4 * 2);
+		bits.zeros(4 * 17);
+		bits.zeros(4 * 3);
+		bits.zeros(4);
+
+		for (uint32 y = 0; y < blockHeight; y++) {
+			bits.put(blockWidth, typeLength);
+			bits.put(1, 1);
+			bits.put(6, 4); // kBlockFill
+			if (y == 0)
+				bits.put(0, subTypeLength);
+
+			bits.put(blockWidth, colorLength);
+			bits.put(0, 1);
+			for (uint32 x = 0; x < blockWidth; x++) {
+				const byte color = (x * 16 + y * 8 + seed) & 0xFF;
+				bits.put(color >> 4, 4);
+				bits.put(color & 0xF, 4);
+			}
+
+			// Nothing else is used, and an empty bundle stays empty
+			if (y == 0) {
+				bits.zeros(patternLength);
+				bits.zeros(typeLength * 4);
+				bits.zeros(runLength);
+			}
+		}
+
+		bits.align();
+	}
+};
+
+// Decodes the same videos with one and several threads, which must produce
+// identical frames.
+class BinkThreadsTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_BINK_THREADS
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_BINK_THREADS
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_same_frames() {
+#if TEST_BINK_THREADS
+		// Odd sizes, with and without alpha, and too small for a band per thread
+		compare(201, 121, false);
+		compare(160, 96, true);
+		compare(33, 40, true);
+#endif
+	}
+
+	void test_decode_speed() {
+#if TEST_BINK_THREADS
+#ifdef SLOW_TESTS
+		const uint32 frameCount = 300;
+#else
+		const uint32 frameCount = 10;
+#endif
+		const uint numThreads[] = { 1, 2, 4, 0 };
+
+		for (int t = 0; t < ARRAYSIZE(numThreads); t++) {
+			Video::BinkDecoder decoder;
+			decoder.setThreadCount(numThreads[t]);
+			decoder.loadStream(BinkWriter::createVideo(640, 480, frameCount, false));
+
+			uint32 start = g_system->getMillis();
+			while (!decoder.endOfVideo())
+				decoder.decodeNextFrame();
+			debug("Bink 640x480 %u frames, %u threads (in milliseconds): %d\n", frameCount,
+			      numThreads[t], g_system->getMillis() - start);
+		}
+#endif
+	}
+
+private:
+	static void compare(uint32 width, uint32 height, bool hasAlpha) {
+		const uint32 frameCount = 12;
+
+		Video::BinkDecoder ref, threads;
+		ref.setThreadCount(1);
+		threads.setThreadCount(4);
+		TS_ASSERT(ref.loadStream(BinkWriter::createVideo(width, height, frameCount, hasAlpha)));
+		TS_ASSERT(threads.loadStream(BinkWriter::createVideo(width, height, frameCount, hasAlpha)));
+
+		for (uint32 i = 0; i < frameCount; i++) {
+			const Graphics::Surface *refSurface = ref.decodeNextFrame();
+			const Graphics::Surface *surface = threads.decodeNextFrame();
+
+			TS_ASSERT(refSurface && surface);
+			if (refSurface && surface) {
+				TS_ASSERT_EQUALS(refSurface->w, surface->w);
+				TS_ASSERT_EQUALS(refSurface->h, surface->h);
+				for (int y = 0; y < refSurface->h; y++)
+					TS_ASSERT_SAME_DATA(refSurface->getBasePtr(0, y), surface->getBasePtr(0, y), refSurface->w * refSurface->format.bytesPerPixel);
+			}
+		}
+
+		TS_ASSERT(threads.endOfVideo());
+	}
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+
+#include "video/video_decoder.h"
+
+#include "../system/null_osystem.h"
+
+// The frames are decoded ahead by a thread, which needs an OSystem
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_DECODE_AHEAD 1
+#else
+#define TEST_DECODE_AHEAD 0
+#endif
+
+/**
+ * A video whose frames are filled with their number. Decoding them is
+ * simulated by sleeping, for longer on every tenth (key) frame, which also
+ * changes the palette.
+ */
+class SlowVideoDecoder : public Video::VideoDecoder {
+public:
+	SlowVideoDecoder(int frameCount, int frameRate, uint decodeTime, uint keyFrameTime) :
+		_frameCount(frameCount), _frameRate(frameRate), _decodeTime(decodeTime), _keyFrameTime(keyFrameTime) {}
+
+	~SlowVideoDecoder() {
+		close();
+	}
+
+	bool loadStream(Common::SeekableReadStream *stream) {
+		close();
+		addTrack(new SlowVideoTrack(_frameCount, _frameRate, _decodeTime, _keyFrameTime));
+		return true;
+	}
+
+protected:
+	bool canDecodeAhead() const { return true; }
+
+private:
+	class SlowVideoTrack : public FixedRateVideoTrack {
+	public:
+		SlowVideoTrack(int frameCount, int frameRate, uint decodeTime, uint keyFrameTime) :
+				_frameCount(frameCount), _frameRate(frameRate), _decodeTime(decodeTime), _keyFrameTime(keyFrameTime),
+				_curFrame(-1), _dirtyPalette(false) {
+			_surface.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~SlowVideoTrack() {
+			_surface.free();
+		}
+
+		uint16 getWidth() const { return kWidth; }
+		uint16 getHeight() const { return kHeight; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return _frameCount; }
+
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time) {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() {
+			_curFrame++;
+
+			const bool keyFrame = (_curFrame % 10) == 0;
+			uint decodeTime = keyFrame ? _keyFrameTime : _decodeTime;
+			if (decodeTime)
+				g_system->delayMillis(decodeTime);
+
+			_surface.fillRect(Common::Rect(kWidth, kHeight), _curFrame & 0xFF);
+			if (keyFrame) {
+				memset(_palette, _curFrame & 0xFF, sizeof(_palette));
+				_dirtyPalette = true;
+			}
+
+			return &_surface;
+		}
+
+		const byte *getPalette() const {
+			_dirtyPalette = false;
+			return _palette;
+		}
+
+		bool hasDirtyPalette() const { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const { return _frameRate; }
+
+	private:
+		enum {
+			kWidth = 64,
+			kHeight = 48
+		};
+
+		int _frameCount;
+		int _frameRate;
+		uint _decodeTime;
+		uint _keyFrameTime;
+
+		int _curFrame;
+		Graphics::Surface _surface;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+
+	int _frameCount;
+	int _frameRate;
+	uint _decodeTime;
+	uint _keyFrameTime;
+};
+
+// Decodes the same video on the calling thread and ahead on another one,
+// which must return the same frames and status.
+class DecodeAheadTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if TEST_DECODE_AHEAD
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if TEST_DECODE_AHEAD
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_same_frames() {
+#if TEST_DECODE_AHEAD
+		SlowVideoDecoder ref(45, 30, 0, 0);
+		SlowVideoDecoder ahead(45, 30, 0, 0);
+		ref.loadStream(nullptr);
+		ahead.loadStream(nullptr);
+		TS_ASSERT(ahead.setDecodeAhead(true));
+
+		compareFrames(ref, ahead, 12);
+		TS_ASSERT(ahead.isDecodingAhead());
+
+		// The frames decoded ahead are dropped
+		TS_ASSERT(ref.seekToFrame(30));
+		TS_ASSERT(ahead.seekToFrame(30));
+		TS_ASSERT_EQUALS(ahead.getCurFrame(), 29);
+		compareFrames(ref, ahead, 5);
+
+		TS_ASSERT(ref.rewind());
+		TS_ASSERT(ahead.rewind());
+		TS_ASSERT_EQUALS(ahead.getCurFrame(), -1);
+
+		// Up to the end, after which the rest of the video is decoded on
+		// the calling thread again
+		compareFrames(ref, ahead, 45);
+		TS_ASSERT(ahead.endOfVideo());
+		TS_ASSERT(ahead.decodeNextFrame() == nullptr);
+		TS_ASSERT(!ahead.isDecodingAhead());
+#endif
+	}
+
+	void test_reverse() {
+#if TEST_DECODE_AHEAD
+		SlowVideoDecoder ref(30, 30, 0, 0);
+		SlowVideoDecoder ahead(30, 30, 0, 0);
+		ref.loadStream(nullptr);
+		ahead.loadStream(nullptr);
+		TS_ASSERT(ahead.setDecodeAhead(true));
+
+		compareFrames(ref, ahead, 5);
+		g_system->delayMillis(10);
+
+		// Changing the direction drops the frames decoded ahead, which have
+		// not been returned yet and must not be skipped. This track cannot
+		// be reversed, but it still has to be back at the shown frame.
+		TS_ASSERT(!ref.setReverse(true));
+		TS_ASSERT(!ahead.setReverse(true));
+		TS_ASSERT(!ahead.isDecodingAhead());
+		TS_ASSERT_EQUALS(ahead.getCurFrame(), 4);
+		compareFrames(ref, ahead, 10);
+#endif
+	}
+
+	void test_end_time() {
+#if TEST_DECODE_AHEAD
+		SlowVideoDecoder decoder(40, 30, 0, 0);
+		decoder.loadStream(nullptr);
+		decoder.setDecodeAhead(true);
+		decoder.setEndFrame(19);
+		decoder.start();
+
+		int frames = 0;
+		while (!decoder.endOfVideo()) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT_EQUALS(*(const byte *)surface->getPixels(), frames);
+			frames++;
+
+			// Pausing doesn't affect the frames decoded ahead
+			if (frames == 5) {
+				decoder.pauseVideo(true);
+				g_system->delayMillis(10);
+				decoder.pauseVideo(false);
+			}
+		}
+
+		// The thread decoded a few frames past the end time, which must
+		// not be taken into account
+		TS_ASSERT_EQUALS(frames, 20);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 19);
+#endif
+	}
+
+	void test_late_frames() {
+#if TEST_DECODE_AHEAD
+#ifdef SLOW_TESTS
+		const int frameCount = 300;
+#else
+		const int frameCount = 25;
+#endif
+		// Frames take 8ms to decode, and the key frames 40ms, while they
+		// are shown for 20ms
+		for (int ahead = 0; ahead < 2; ahead++) {
+			SlowVideoDecoder decoder(frameCount, 50, 8, 40);
+			decoder.loadStream(nullptr);
+			decoder.setDecodeAhead(ahead != 0);
+			decoder.start();
+
+			// A frame is late when shown more than half of its duration
+			// after its start time, and dropped when the next frame should
+			// already be shown instead
+			int late = 0, dropped = 0;
+			while (!decoder.endOfVideo()) {
+				if (decoder.needsUpdate()) {
+					decoder.decodeNextFrame();
+					const uint32 time = decoder.getTime();
+					const uint32 startTime = decoder.getCurFrame() * 20;
+					if (time >= startTime + 20)
+						dropped++;
+					else if (time > startTime + 10)
+						late++;
+				}
+				g_system->delayMillis(1);
+			}
+
+			debug("Playing %d frames %s: %d late, %d dropped\n", frameCount,
+			      ahead ? "decoded ahead" : "decoded in place", late, dropped);
+		}
+#endif
+	}
+
+private:
+	static void compareFrames(Video::VideoDecoder &ref, Video::VideoDecoder &ahead, int count) {
+		for (int i = 0; i < count; i++) {
+			const Graphics::Surface *refSurface = ref.decodeNextFrame();
+			const Graphics::Surface *aheadSurface = ahead.decodeNextFrame();
+
+			TS_ASSERT_EQUALS(ref.getCurFrame(), ahead.getCurFrame());
+			TS_ASSERT_EQUALS(ref.endOfVideo(), ahead.endOfVideo());
+			TS_ASSERT(refSurface && aheadSurface);
+			if (refSurface && aheadSurface) {
+				TS_ASSERT_EQUALS(refSurface->w, aheadSurface->w);
+				TS_ASSERT_EQUALS(refSurface->h, aheadSurface->h);
+				TS_ASSERT_SAME_DATA(refSurface->getPixels(), aheadSurface->getPixels(), refSurface->pitch * refSurface->h);
+			}
+
+			TS_ASSERT_EQUALS(ref.hasDirtyPalette(), ahead.hasDirtyPalette());
+			if (ref.hasDirtyPalette() && ahead.hasDirtyPalette())
+				TS_ASSERT_SAME_DATA(ref.getPalette(), ahead.getPalette(), 256 * 3);
+		}
+	}
+};
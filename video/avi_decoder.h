@@ -102,6 +102,8 @@ protected:
 	// VideoDecoder API
 	void readNextPacket();
 	bool seekIntern(const Audio::Timestamp &time);
+	// The transparency track is decoded separately by decodeNextTransparency()
+	bool canDecodeAhead() const { return !_transparencyTrack.track; }
 	bool supportsAudioTrackSwitching() const { return true; }
 	AudioTrack *getAudioTrack(int index);
 
@@ -30,12 +30,12 @@
 #include "common/textconsole.h"
 #include "common/intrinsics.h"
 #include "common/stream.h"
-#include "common/substream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -65,6 +65,7 @@ namespace Video {
 
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+	_numThreads = 0;
 }
 
 BinkDecoder::~BinkDecoder() {
@@ -104,8 +105,10 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 	uint32 videoFlags = _bink->readUint32LE();
 
 	// BIKh and BIKi swap the chroma planes
-	addTrack(new BinkVideoTrack(width, height, frameCount,
-			Common::Rational(frameRateNum, frameRateDen), (id == kBIKhID || id == kBIKiID), videoFlags & kVideoFlagAlpha, id));
+	BinkVideoTrack *videoTrack = new BinkVideoTrack(width, height, frameCount,
+			Common::Rational(frameRateNum, frameRateDen), (id == kBIKhID || id == kBIKiID), videoFlags & kVideoFlagAlpha, id);
+	videoTrack->setThreadCount(_numThreads);
+	addTrack(videoTrack);
 
 	uint32 audioTrackCount = _bink->readUint32LE();
 
@@ -151,6 +154,7 @@ void BinkDecoder::close() {
 
 	delete _bink;
 	_bink = 0;
+	_packet.clear();
 
 	_audioTracks.clear();
 	_frames.clear();
@@ -182,14 +186,15 @@ void BinkDecoder::readNextPacket() {
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
+			uint32 audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			// The packet is borrowed from the stream if it is held in memory
+			_packet.readFromStream(*_bink, audioPacketEnd - _bink->pos());
+			audio.bits = new Common::BitStreamMemory32LELSB(new Common::BitStreamMemoryStream(_packet->data(),
+					_packet->size()), DisposeAfterUse::YES);
 
 			audioTrack->decodePacket();
 
@@ -202,11 +207,9 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	_packet.readFromStream(*_bink, frameSize);
+	frame.bits = new Common::BitStreamMemory32LELSB(new Common::BitStreamMemoryStream(_packet->data(),
+			_packet->size()), DisposeAfterUse::YES);
 
 	videoTrack->decodePacket(frame);
 
@@ -270,6 +273,9 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 			_colHighHuffman[i].symbols[j] = j;
 	}
 
+	_numThreads = 0;
+	_threads = nullptr;
+
 	// Make the surface even-sized:
 	_surfaceHeight = _height = height;
 	_surfaceWidth = _width = width;
@@ -315,6 +321,9 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 
 	deinitBundles();
 
+	delete _threads;
+	_threads = nullptr;
+
 	for (int i = 0; i < 16; i++) {
 		delete _huffman[i];
 		_huffman[i] = 0;
@@ -327,6 +336,14 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	}
 }
 
+void BinkDecoder::setThreadCount(uint numThreads) {
+	_numThreads = numThreads;
+
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+	if (videoTrack)
+		videoTrack->setThreadCount(numThreads);
+}
+
 Common::Rational BinkDecoder::getFrameRate() {
 	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
 
@@ -464,6 +481,8 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		decodePlane(frame, 3, false);
 	}
 
+	// The meaning of this value isn't documented. It may locate the chroma
+	// planes, but without that, the planes can only be decoded in turn.
 	if (_id == kBIKiID)
 		frame.bits->skip(32);
 
@@ -477,23 +496,87 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	}
 
 	// Convert the YUV data we have to our format
+	convertPlanes();
+
+	// And swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		SWAP(_curPlanes[i], _oldPlanes[i]);
+
+	_curFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::setThreadCount(uint numThreads) {
+	if (numThreads == _numThreads)
+		return;
+
+	_numThreads = numThreads;
+
+	delete _threads;
+	_threads = nullptr;
+}
+
+void BinkDecoder::BinkVideoTrack::convertPlanes() {
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
-	if (_hasAlpha) {
+	if (_hasAlpha)
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	} else {
+	else
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+
+	if (!_threads && _numThreads != 1)
+		_threads = new Common::ThreadPool(_numThreads, "Bink decoder");
+
+	const uint count = getBandCount();
+	if (count < 2) {
+		convertBand(0, 1);
+		return;
 	}
 
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
+	// Converting nothing sets up the conversion before using it from
+	// several threads
+	if (_hasAlpha)
+		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
+				_surfaceWidth, 0, _yBlockWidth * 8, _uvBlockWidth * 8);
+	else
+		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
+				_surfaceWidth, 0, _yBlockWidth * 8, _uvBlockWidth * 8);
 
-	_curFrame++;
+	_threads->run(count, convertBandProc, this);
+}
+
+void BinkDecoder::BinkVideoTrack::convertBandProc(void *data, uint index) {
+	BinkVideoTrack *track = (BinkVideoTrack *)data;
+	track->convertBand(index, track->getBandCount());
+}
+
+uint BinkDecoder::BinkVideoTrack::getBandCount() const {
+	// At least 16 rows per band
+	return _threads ? MIN<uint>(_threads->getNumThreads(), _surfaceHeight / 16) : 1;
+}
+
+void BinkDecoder::BinkVideoTrack::convertBand(uint index, uint count) {
+	// Bands of an even number of rows, since the chroma planes have half the height
+	const uint32 rows = ((_surfaceHeight + count - 1) / count + 1) & ~1;
+	const uint32 top = index * rows;
+	const uint32 bottom = MIN<uint32>(top + rows, _surfaceHeight);
+	if (top >= bottom)
+		return;
+
+	const uint32 yPitch = _yBlockWidth * 8;
+	const uint32 uvPitch = _uvBlockWidth * 8;
+
+	// The surface height is the video height, which may be odd
+	Graphics::Surface band;
+	band.init(_surface->w, bottom - top, _surface->pitch, _surface->getBasePtr(0, top), _surface->format);
+
+	if (_hasAlpha)
+		YUVToRGBMan.convert420Alpha(&band, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0] + top * yPitch,
+				_curPlanes[1] + top / 2 * uvPitch, _curPlanes[2] + top / 2 * uvPitch, _curPlanes[3] + top * yPitch,
+				_surfaceWidth, bottom - top, yPitch, uvPitch);
+	else
+		YUVToRGBMan.convert420(&band, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0] + top * yPitch,
+				_curPlanes[1] + top / 2 * uvPitch, _curPlanes[2] + top / 2 * uvPitch,
+				_surfaceWidth, bottom - top, yPitch, uvPitch);
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
@@ -721,7 +804,7 @@ void BinkDecoder::BinkVideoTrack::deinitBundles() {
 
 void BinkDecoder::BinkVideoTrack::initHuffman() {
 	for (int i = 0; i < 16; i++)
-		_huffman[i] = new Common::Huffman<Common::BitStream32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
+		_huffman[i] = new Common::Huffman<Common::BitStreamMemory32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
 byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
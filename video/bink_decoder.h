@@ -33,6 +33,7 @@
 #include "common/array.h"
 #include "common/bitstream.h"
 #include "common/rational.h"
+#include "common/span.h"
 
 #include "video/video_decoder.h"
 
@@ -45,6 +46,7 @@ class QueuingAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class ThreadPool;
 template <class BITSTREAM>
 class Huffman;
 }
@@ -76,6 +78,19 @@ public:
 
 	Common::Rational getFrameRate();
 
+	/**
+	 * Set the number of threads decoding the video frames.
+	 *
+	 * The planes are decoded in turn, as the position of each of them is
+	 * only known once the previous one is decoded. The conversion to RGB is
+	 * split into bands of rows. The output is the same with any number of
+	 * threads.
+	 *
+	 * @param numThreads	the number of threads, including the calling one.
+	 *			If 0, the number of CPU cores is used, which is the default.
+	 */
+	void setThreadCount(uint numThreads);
+
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -106,7 +121,7 @@ private:
 
 		uint32 sampleCount;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		bool first;
 
@@ -139,7 +154,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -167,6 +182,7 @@ private:
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
 		void setCurFrame(uint32 frame) { _curFrame = frame; }
+		void setThreadCount(uint numThreads);
 
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
@@ -266,13 +282,16 @@ private:
 
 		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
 
-		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
+		Common::Huffman<Common::BitStreamMemory32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
 		/** Huffman codebooks to use for decoding high nibbles in color data types. */
 		Huffman _colHighHuffman[16];
 		/** Value of the last decoded high nibble in color data types. */
 		int _colLastVal;
 
+		uint _numThreads;              ///< The number of threads to use, 0 for the number of CPU cores.
+		Common::ThreadPool *_threads;  ///< The threads converting rows.
+
 		uint32 _yBlockWidth;   ///< Width of the Y plane in blocks
 		uint32 _yBlockHeight;  ///< Height of the Y plane in blocks
 		uint32 _uvBlockWidth;  ///< Width of the U and V planes in blocks
@@ -292,6 +311,12 @@ private:
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
+		/** Convert the planes to the surface. */
+		void convertPlanes();
+		static void convertBandProc(void *data, uint index);
+		void convertBand(uint index, uint count);
+		uint getBandCount() const;
+
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
 
@@ -378,10 +403,13 @@ private:
 	};
 
 	Common::SeekableReadStream *_bink;
+	Common::StreamSpan _packet; ///< The audio or video packet being decoded.
 
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
+	uint _numThreads; ///< The number of threads decoding the video frames.
+
 	void initAudioTrack(AudioInfo &audio);
 };
 
@@ -26,10 +26,76 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
+#include "common/thread.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * The frames decoded ahead on a separate thread, see setDecodeAhead().
+ *
+ * The slots are used in turn: the thread waits for a free slot, decodes a
+ * frame into it and marks it as ready, while decodeNextFrame() takes the
+ * ready slots in the same order. The slot returned last stays in use until
+ * the next call, since the caller may still be accessing its surface.
+ */
+class VideoDecoder::DecodeAheadQueue {
+public:
+	struct Status {
+		Status() : curFrame(-1), curFrameDelay(0), nextFrameStartTime(0), endOfTrack(false) {}
+
+		int curFrame;
+		int curFrameDelay;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+	};
+
+	struct Frame {
+		Frame() : hasSurface(false), dirtyPalette(false) {}
+
+		Graphics::Surface surface;
+		bool hasSurface;
+		Status status;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	DecodeAheadQueue(VideoDecoder *d, VideoTrack *t, uint numSlots) :
+			decoder(d), track(t), frames(numSlots), freeSlots(numSlots), readIndex(0), writeIndex(0),
+			holdingFrame(false), quit(false) {
+		shown.curFrame = track->getCurFrame();
+		shown.curFrameDelay = track->getCurFrameDelay();
+		shown.nextFrameStartTime = track->getNextFrameStartTime();
+		shown.endOfTrack = track->endOfTrack();
+	}
+
+	~DecodeAheadQueue() {
+		for (auto &frame : frames)
+			frame.surface.free();
+	}
+
+	VideoDecoder *decoder;
+	VideoTrack *track;
+
+	Common::Thread thread;
+	// Held by the thread while it is decoding a frame
+	Common::Mutex decodeMutex;
+
+	Common::Array<Frame> frames;
+	Common::Semaphore freeSlots;
+	Common::Semaphore readySlots;
+	uint readIndex;
+	uint writeIndex;
+	bool holdingFrame;
+	std::atomic<bool> quit;
+
+	// Status of the track after the last frame returned by decodeNextFrame()
+	Status shown;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,9 +114,18 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_decodeAhead = nullptr;
+	_decodeAheadFrames = 0;
+}
+
+VideoDecoder::~VideoDecoder() {
+	stopDecodeAhead();
 }
 
 void VideoDecoder::close() {
+	stopDecodeAhead();
+	_decodeAheadFrames = 0;
+
 	if (isPlaying())
 		stop();
 
@@ -212,6 +287,16 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	// Once the thread has decoded the last frame, the rest of the video,
+	// if any, is read here again
+	if (_decodeAhead && _decodeAhead->shown.endOfTrack)
+		stopDecodeAhead();
+	else if (!_decodeAhead && _decodeAheadFrames)
+		startDecodeAhead();
+
+	if (_decodeAhead)
+		return decodeAheadFrame();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -240,6 +325,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	// Attempt to make sure all the tracks are in the requested direction
 	for (auto &track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)track)->isReversed() != reverse) {
+			// Frames are only decoded ahead when playing forward
+			if (!stopDecodeAheadAtShownFrame())
+				return false;
+
 			if (!((VideoTrack *)track)->setReverse(reverse))
 				return false;
 
@@ -261,7 +350,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (const auto &track : _tracks)
 		if (track->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)track)->getCurFrame() + 1;
+			frame += getTrackCurFrame((const VideoTrack *)track) + 1;
 
 	return frame;
 }
@@ -271,7 +360,7 @@ int VideoDecoder::getCurFrameDelay() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrameDelay() + 1;
+			frame += getTrackCurFrameDelay((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -313,7 +402,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -332,8 +421,8 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 
 bool VideoDecoder::endOfVideo() const {
 	for (const auto &track : _tracks) {
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = trackEndOfTrack(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -356,6 +445,9 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	// Drop the frames decoded ahead
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -390,6 +482,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	// Drop the frames decoded ahead
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be seek'ed
 	if (isPlaying())
 		stopAudio();
@@ -588,10 +683,184 @@ bool VideoDecoder::setOutputPixelFormats(const Common::List<Graphics::PixelForma
 void VideoDecoder::setVideoCodecAccuracy(Image::CodecAccuracy accuracy) {
 	_videoCodecAccuracy = accuracy;
 
+	// Don't change the codec while the thread is decoding a frame
+	if (_decodeAhead)
+		_decodeAhead->decodeMutex.lock();
+
 	for (Track *track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo)
 			static_cast<VideoTrack *>(track)->setCodecAccuracy(accuracy);
 	}
+
+	if (_decodeAhead)
+		_decodeAhead->decodeMutex.unlock();
+}
+
+bool VideoDecoder::setDecodeAhead(bool enable, uint numFrames) {
+	// Frames already decoded ahead are still returned until the video is
+	// rewound, seeked or closed
+	_decodeAheadFrames = 0;
+
+	if (!enable || !canDecodeAhead())
+		return false;
+
+	uint videoTracks = 0;
+	for (const auto &track : _tracks)
+		if (track->getTrackType() == Track::kTrackTypeVideo)
+			videoTracks++;
+
+	if (videoTracks != 1)
+		return false;
+
+	// One more slot for the frame returned last
+	_decodeAheadFrames = MAX<uint>(numFrames, 1) + 1;
+	return true;
+}
+
+void VideoDecoder::startDecodeAhead() {
+	if (!_nextVideoTrack || _nextVideoTrack->isReversed() || _nextVideoTrack->endOfTrack())
+		return;
+
+	_decodeAhead = new DecodeAheadQueue(this, _nextVideoTrack, _decodeAheadFrames);
+
+	if (!_decodeAhead->thread.start(decodeAheadProc, _decodeAhead, "Video decoder")) {
+		// Threads are not supported, decode the frames in decodeNextFrame()
+		delete _decodeAhead;
+		_decodeAhead = nullptr;
+		_decodeAheadFrames = 0;
+	}
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	if (!_decodeAhead)
+		return;
+
+	// Wake the thread up if it is waiting for a free slot
+	_decodeAhead->quit = true;
+	_decodeAhead->freeSlots.post();
+	_decodeAhead->thread.join();
+
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+
+	// The tracks now reflect the frames which have been decoded
+	findNextVideoTrack();
+}
+
+bool VideoDecoder::stopDecodeAheadAtShownFrame() {
+	if (!_decodeAhead)
+		return true;
+
+	VideoTrack *track = _decodeAhead->track;
+	const int shownFrame = _decodeAhead->shown.curFrame;
+	stopDecodeAhead();
+
+	// The frames in the queue were never returned, so seek the track back
+	// to the one returned last
+	if (track->getCurFrame() == shownFrame)
+		return true;
+
+	if (!isSeekable() || !seekIntern(track->getFrameTime(shownFrame + 1)))
+		return false;
+
+	findNextVideoTrack();
+	return true;
+}
+
+const Graphics::Surface *VideoDecoder::decodeAheadFrame() {
+	DecodeAheadQueue *queue = _decodeAhead;
+
+	// The caller is done with the previous frame
+	if (queue->holdingFrame) {
+		queue->readIndex = (queue->readIndex + 1) % queue->frames.size();
+		queue->freeSlots.post();
+	}
+
+	queue->readySlots.wait();
+	queue->holdingFrame = true;
+
+	const DecodeAheadQueue::Frame &frame = queue->frames[queue->readIndex];
+	queue->shown = frame.status;
+
+	if (frame.dirtyPalette) {
+		memcpy(_decodeAheadPalette, frame.palette, sizeof(_decodeAheadPalette));
+		_palette = _decodeAheadPalette;
+		_dirtyPalette = true;
+	}
+
+	return frame.hasSurface ? &frame.surface : nullptr;
+}
+
+void VideoDecoder::decodeAheadProc(void *data) {
+	DecodeAheadQueue *queue = (DecodeAheadQueue *)data;
+	VideoTrack *track = queue->track;
+	bool endOfTrack = false;
+
+	while (!endOfTrack) {
+		queue->freeSlots.wait();
+		if (queue->quit)
+			break;
+
+		DecodeAheadQueue::Frame &frame = queue->frames[queue->writeIndex];
+
+		{
+			Common::StackLock lock(queue->decodeMutex);
+
+			queue->decoder->readNextPacket();
+			const Graphics::Surface *surface = track->decodeNextFrame();
+
+			// The track may reuse its surface for the next frame
+			frame.hasSurface = surface != nullptr;
+			if (surface) {
+				if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+					frame.surface.free();
+					frame.surface.create(surface->w, surface->h, surface->format);
+				}
+
+				frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+			}
+
+			frame.dirtyPalette = track->hasDirtyPalette();
+			if (frame.dirtyPalette)
+				memcpy(frame.palette, track->getPalette(), sizeof(frame.palette));
+
+			frame.status.curFrame = track->getCurFrame();
+			frame.status.curFrameDelay = track->getCurFrameDelay();
+			frame.status.nextFrameStartTime = track->getNextFrameStartTime();
+			frame.status.endOfTrack = endOfTrack = track->endOfTrack();
+		}
+
+		queue->writeIndex = (queue->writeIndex + 1) % queue->frames.size();
+		queue->readySlots.post();
+	}
+}
+
+bool VideoDecoder::trackEndOfTrack(const Track *track) const {
+	if (_decodeAhead && track == _decodeAhead->track)
+		return _decodeAhead->shown.endOfTrack;
+
+	return track->endOfTrack();
+}
+
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	if (_decodeAhead && track == _decodeAhead->track)
+		return _decodeAhead->shown.curFrame;
+
+	return track->getCurFrame();
+}
+
+int VideoDecoder::getTrackCurFrameDelay(const VideoTrack *track) const {
+	if (_decodeAhead && track == _decodeAhead->track)
+		return _decodeAhead->shown.curFrameDelay;
+
+	return track->getCurFrameDelay();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_decodeAhead && track == _decodeAhead->track)
+		return _decodeAhead->shown.nextFrameStartTime;
+
+	return track->getNextFrameStartTime();
 }
 
 VideoDecoder::Track::Track() {
@@ -959,7 +1228,7 @@ void VideoDecoder::setEndFrame(uint frame) {
 
 void VideoDecoder::resetStartTime() {
 	if (_nextVideoTrack) {
-		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
+		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(getTrackCurFrame(_nextVideoTrack));
 		if (isPlaying()) {
 			_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
 		}
@@ -982,7 +1251,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (const auto &track : _tracks)
-		if (track->getTrackType() == Track::kTrackTypeVideo && !track->endOfTrack())
+		if (track->getTrackType() == Track::kTrackTypeVideo && !trackEndOfTrack(track))
 			return false;
 
 	return true;
@@ -1049,8 +1318,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *videoTrack = (const VideoTrack *)track;
 
-		bool videoEndTimeReached = _endTimeSet && videoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = videoTrack->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+		bool endReached = trackEndOfTrack(videoTrack) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
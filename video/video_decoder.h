@@ -53,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -430,6 +430,33 @@ public:
 	 */
 	virtual void setVideoCodecAccuracy(Image::CodecAccuracy accuracy);
 
+	/**
+	 * Decode the frames ahead on a separate thread.
+	 *
+	 * The frames are copied into a small queue, from which decodeNextFrame()
+	 * then returns them without waiting for the codec, so that frames which
+	 * are slow to decode do not hold up the caller. The queue is flushed when
+	 * seeking or rewinding the video.
+	 *
+	 * This only works for videos with a single video track played forward,
+	 * for decoders which support it (see canDecodeAhead()), and when the
+	 * backend supports threads. Otherwise, the frames keep being decoded
+	 * by decodeNextFrame().
+	 *
+	 * This should be called after loadStream(), and after setting the output
+	 * pixel format or dithering palette.
+	 *
+	 * @param enable	true to decode frames ahead, false to decode them in decodeNextFrame()
+	 * @param numFrames	the number of frames which can be decoded ahead
+	 * @return true if frames will be decoded ahead, false otherwise
+	 */
+	bool setDecodeAhead(bool enable, uint numFrames = 3);
+
+	/**
+	 * Returns if frames are currently decoded ahead on a separate thread.
+	 */
+	bool isDecodingAhead() const { return _decodeAhead != nullptr; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -929,6 +956,18 @@ protected:
 	 */
 	virtual bool useAudioSync() const { return true; }
 
+	/**
+	 * Whether or not the frames can be decoded ahead on a separate thread.
+	 *
+	 * The separate thread calls readNextPacket() and the decodeNextFrame()
+	 * function of the video track, so only a subclass which does not access
+	 * its tracks from other functions while the video is playing should
+	 * return true. Frames are not decoded ahead by default.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	virtual bool canDecodeAhead() const { return false; }
+
 	/**
 	 * Get the given track based on its index.
 	 *
@@ -1053,6 +1092,24 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Decoding frames ahead on a separate thread
+	class DecodeAheadQueue;
+	DecodeAheadQueue *_decodeAhead;
+	uint _decodeAheadFrames;
+	byte _decodeAheadPalette[256 * 3];
+
+	void startDecodeAhead();
+	void stopDecodeAhead();
+	bool stopDecodeAheadAtShownFrame();
+	const Graphics::Surface *decodeAheadFrame();
+	static void decodeAheadProc(void *data);
+
+	// Track status, as of the last frame returned when decoding ahead
+	bool trackEndOfTrack(const Track *track) const;
+	int getTrackCurFrame(const VideoTrack *track) const;
+	int getTrackCurFrameDelay(const VideoTrack *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
 };
 
 } // End of namespace Video